@@ -0,0 +1,25 @@
+#ifndef __bits_h
+#define __bits_h
+
+#include "TypeDefs.h"
+
+
+inline ui32 CountBits(ui32 mask)
+{
+	ui32 count = 0;
+	for (; mask; mask &= mask - 1)
+		count++;
+
+	return count;
+}
+
+inline ui32 GetHighestBit(ui32 value)
+{
+	ui32 bit = 0;
+	while (value >>= 1)
+		bit++;
+
+	return bit;
+}
+
+#endif __bits_h
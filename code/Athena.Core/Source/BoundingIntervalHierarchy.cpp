@@ -1,576 +1,2834 @@
-#include "Athena.h"
-#include "BoundingIntervalHierarchy.h"
-#include "HitResult.h"
-#include "Rendering.h"
-#include "Scene.h"
-#include "Timer.h"
-#include "Timers.h"
-
-#define NODE_MEM_POOL_PAGE_SIZE	1024
-
-
-void BIH::Destroy()
-{
-	if (objects)
-	{
-		ShowStats();
-
-		objects = null;
-		nodes.Destroy();
-
-		LOG_DEBUG("BIH::Destroy");
-	}
-}
-
-void BIH::Initialize(Objects* objects, MemoryManager* memoryManagerInstance)
-{
-	numOfLeavesUsed = numOfNodesUsed = numOfObjectsUsed = depthSum = 0;
-	numOfTreesConstructed = 0;
-	currentNumOfLeaves = currentNumOfNodes = 0;
-	currentDepth = currentMaxDepth = 0;
-	currentMinDepth = 0;
-
-	nodes.Initialize(memoryManagerInstance, "BIHNode", NODE_MEM_POOL_PAGE_SIZE);
-
-	this->objects = objects;
-}
-
-bool BIH::Update(uint maxObjectsPerLeaf, uint maxDepth, AthenaStorage* athenaStorage)
-{
-	TIMED_BLOCK(&athenaStorage->timers[TimerId::BihConstruction]);
-
-	// clear memory pool
-	nodes.Clear();
-	currentNumOfLeaves = currentNumOfNodes = 0;
-	currentDepth = 0;
-
-	if (athenaStorage->renderingParameters.tracingMethod != TracingMethod::BoundingIntervalHierarchy)
-		return false;
-
-	// min value is 1
-	if (!maxObjectsPerLeaf)
-		maxObjectsPerLeaf = 1;
-
-	// set tree properties
-	this->maxObjectsPerLeaf = maxObjectsPerLeaf;
-	this->maxDepth = maxDepth;
-
-	if (!objects->everything.currentCount || !maxDepth)
-		return false;
-
-	// get root bounding box
-	UpdateRootCell();
-
-	BIHNode rootNode;
-	rootNode.Clear();
-
-	const uint unknownObjectsCount = PreSortObjects();
-	// recursively create tree
-	CreateNode((ui32)nodes.Add(rootNode), unknownObjectsCount, objects->everything.currentCount - unknownObjectsCount, 
-		rootCell);
-	
-	numOfTreesConstructed++;
-	numOfNodesUsed += currentNumOfNodes;
-	numOfLeavesUsed += currentNumOfLeaves;
-	numOfObjectsUsed += objects->everything.currentCount;
-	depthSum += currentDepth;
-
-	if (currentDepth < currentMinDepth)
-		currentMinDepth = currentDepth;
-
-	if (currentDepth > currentMaxDepth)
-		currentMaxDepth = currentDepth;
-
-	return true;
-}
-
-template <typename T> void AddObjectListToCell(const list_of<T>& objectList, AACell& cell)
-{
-	for (uint32 i = 0; i < (uint32)objectList.currentCount; ++i)
-	{
-		const T& object = objectList[i];
-		cell.minCorner.Set(
-			MIN2(object.cell.minCorner.x + object.position.x, cell.minCorner.x),
-			MIN2(object.cell.minCorner.y + object.position.y, cell.minCorner.y),
-			MIN2(object.cell.minCorner.z + object.position.z, cell.minCorner.z));
-		cell.maxCorner.Set(
-			MAX2(object.cell.maxCorner.x + object.position.x, cell.maxCorner.x),
-			MAX2(object.cell.maxCorner.y + object.position.y, cell.maxCorner.y),
-			MAX2(object.cell.maxCorner.z + object.position.z, cell.maxCorner.z));
-	}
-}
-
-void BIH::UpdateRootCell()
-{
-	rootCell.maxCorner.Set(-_INFINITY, -_INFINITY, -_INFINITY);
-	rootCell.minCorner.Set(_INFINITY, _INFINITY, _INFINITY);
-
-	AddObjectListToCell<Box>(objects->boxes, rootCell);
-	AddObjectListToCell<Sphere>(objects->spheres, rootCell);
-	AddObjectListToCell<SphereLightSource>(objects->sphereLights, rootCell);
-	AddObjectListToCell<BoxLightSource>(objects->boxLights, rootCell);
-	AddObjectListToCell<Mesh>(objects->meshes, rootCell);
-}
-
-void BIH::CreateNode(uint32 nodeId, uint firstObjectId, uint objectCount, const AACell& cell, uint depth)
-{
-	depth++;
-	
-	if (objectCount <= maxObjectsPerLeaf || depth == maxDepth)
-	{
-		BIHNode& node = nodes[nodeId];
-
-		node.isLeaf = 1;
-		node.firstObjectId = (uint32)firstObjectId;
-		node.objectCount = (uint32)objectCount;
-
-		currentNumOfLeaves++;
-
-		if (depth > currentDepth)
-			currentDepth = depth;
-
-		return;
-	}
-
-	currentNumOfNodes++;
-
-	v3f cellSize = cell.maxCorner - cell.minCorner;
-
-	// find longest dimension
-	nodes[nodeId].axis = BIH_NODE_X_AXIS;
-	
-	if (cellSize.y > cellSize.x)
-		nodes[nodeId].axis = BIH_NODE_Y_AXIS;
-
-	if (cellSize.z > cellSize[nodes[nodeId].axis])
-		nodes[nodeId].axis = BIH_NODE_Z_AXIS;
-
-	const real splitPlane = cellSize[nodes[nodeId].axis] * .5 + cell.minCorner.Get(nodes[nodeId].axis);
-
-	// sort objects by split plane
-	uint numOfObjectsOnLeft = SortObjects(firstObjectId, objectCount, splitPlane, nodes[nodeId].axis);
-
-	nodes[nodeId].leftPlane = cell.minCorner.Get(nodes[nodeId].axis);
-	nodes[nodeId].rightPlane = cell.maxCorner.Get(nodes[nodeId].axis);
-
-	AACell objectCell;
-	v3f objectPosition;
-
-	// left interval
-	if (numOfObjectsOnLeft)
-	{
-		// get left plane
-		for (uint i = 0; i < numOfObjectsOnLeft; i++)
-		{
-			if (!GetObjectInfoById(objects->everything[firstObjectId + i], objectCell, objectPosition))
-				continue;
-			
-			const real objectMaxPlane = objectCell.maxCorner[nodes[nodeId].axis] +
-				objectPosition[nodes[nodeId].axis];
-
-			if (objectMaxPlane > nodes[nodeId].leftPlane)
-				nodes[nodeId].leftPlane = objectMaxPlane;
-		}
-
-		AACell leftCell = cell;
-		leftCell.maxCorner[nodes[nodeId].axis] = nodes[nodeId].leftPlane;
-		
-		BIHNode leftNode;
-		leftNode.Clear();
-		//leftnode.parentNodeId = nodeId;
-
-		nodes[nodeId].leftNodeId = (ui32)nodes.Add(leftNode);
-		CreateNode(nodes[nodeId].leftNodeId, firstObjectId, numOfObjectsOnLeft, leftCell, depth);
-	}
-
-	// right interval
-	if (objectCount - numOfObjectsOnLeft)
-	{
-		// get right plane
-		for (uint i = numOfObjectsOnLeft; i < objectCount; i++)
-		{
-			if (!GetObjectInfoById(objects->everything[firstObjectId + i], objectCell, objectPosition))
-				continue;
-
-			const real objectMinPlane = objectCell.minCorner[nodes[nodeId].axis] +
-				objectPosition[nodes[nodeId].axis];
-			if (objectMinPlane < nodes[nodeId].rightPlane)
-				nodes[nodeId].rightPlane = objectMinPlane;
-		}
-
-		AACell rightCell = cell;
-		rightCell.minCorner[nodes[nodeId].axis] = nodes[nodeId].rightPlane;
-
-		BIHNode rightNode;
-		rightNode.Clear();
-		//rightNode.parentNodeId = nodeId;
-
-		nodes[nodeId].rightNodeId = (ui32)nodes.Add(rightNode);
-		CreateNode(nodes[nodeId].rightNodeId, firstObjectId + numOfObjectsOnLeft, objectCount - numOfObjectsOnLeft,
-			rightCell, depth);
-	}
-}
-
-uint BIH::PreSortObjects()
-{
-	AACell objectCell;
-	v3f objectPosition;
-	uint lastUnknown = 0;
-	for (uint i = 0; i < objects->everything.currentCount; ++i)
-	{
-		// if object is unknown
-		if (!GetObjectInfoById(objects->everything[i], objectCell, objectPosition))
-		{
-			// find first known object from left
-			for (; lastUnknown < i; ++lastUnknown)
-			{
-				if (GetObjectInfoById(objects->everything[lastUnknown], objectCell, objectPosition))
-				{
-					// swap objects, so unknown objects are from 0 to lastUnknown
-					ObjectId tmpObjectId = objects->everything[lastUnknown];
-					objects->everything[lastUnknown] = objects->everything[i];
-					objects->everything[i] = tmpObjectId;
-					// point lastUnknown to next object
-					break;
-				}
-			}
-			lastUnknown++;
-		}
-	}
-
-	return lastUnknown;
-}
-
-uint BIH::SortObjects(uint firstObjectId, uint objectCount, real splitPlane, uint8 axis)
-{
-	int64 leftId = firstObjectId, rightId = firstObjectId + objectCount - 1;
-	uint leftCount = 0;
-
-	AACell leftObjectCell, rightObjectCell;
-	v3f leftObjectPosition, rightObjectPosition;
-	while (leftId <= rightId)
-	{
-		auto leftFound = GetObjectInfoById(objects->everything[leftId], leftObjectCell, leftObjectPosition);
-		ASSERT(leftFound);
-		auto rightFound = GetObjectInfoById(objects->everything[rightId], rightObjectCell, rightObjectPosition);
-		ASSERT(rightFound);
-
-		const real leftCellMid = (leftObjectCell.maxCorner[axis] - leftObjectCell.minCorner[axis]) * .5 +
-			leftObjectCell.minCorner[axis] + leftObjectPosition[axis];
-		const real rightCellMid = (rightObjectCell.maxCorner[axis] - rightObjectCell.minCorner[axis]) * .5 +
-			rightObjectCell.minCorner[axis] + rightObjectPosition[axis];
-
-		// if both good
-		if (splitPlane >= leftCellMid && splitPlane <= rightCellMid)
-		{
-			leftCount++;
-
-			leftId++;
-			rightId--;
-			continue;
-		}
-
-		// if both bad
-		if (splitPlane <= leftCellMid && splitPlane >= rightCellMid)
-		{
-			// switch object indices
-			ObjectId tmpObjectId = objects->everything[leftId];
-			objects->everything[leftId] = objects->everything[rightId];
-			objects->everything[rightId] = tmpObjectId;
-
-			leftCount++;
-
-			leftId++;
-			rightId--;
-			continue;
-		}
-
-		// if left is good then right is bad, so i have to find next left bad
-		if (splitPlane >= leftCellMid)
-		{
-			leftId++;
-			leftCount++;
-		}
-		else
-		{
-			rightId--;
-		}
-	}
-
-	return leftCount;
-}
-
-bool BIH::GetObjectInfoById(const ObjectId& objectId, AACell& objectCell, v3f& objectPosition) const
-{
-	switch (objectId.Type())
-	{
-		case ObjectType::Sphere: 
-		{
-			const Sphere& object = objects->spheres[objectId.index];
-			objectCell = object.cell;
-			objectPosition = object.position;
-			return true;
-		}
-		
-		case ObjectType::Box:
-		{
-			const Box& object = objects->boxes[objectId.index];
-			objectCell = object.cell;
-			objectPosition = object.position;
-			return true;
-		}
-				
-		case ObjectType::Mesh:
-		{
-			const Mesh& object = objects->meshes[objectId.index];
-			objectCell = object.cell;
-			objectPosition = object.position;
-			return true;
-		}
-
-		case ObjectType::SphereLightSource:
-		{
-			const SphereLightSource& object = objects->sphereLights[objectId.index];
-			objectCell = object.cell;
-			objectPosition = object.position;
-			return true;
-		}
-		
-		case ObjectType::BoxLightSource:
-		{
-			const BoxLightSource& object = objects->boxLights[objectId.index];
-			objectCell = object.cell;
-			objectPosition = object.position;
-			return true;
-		}
-
-		case ObjectType::PointLightSource:
-		case ObjectType::Plane:
-			break;
-	}
-
-	return false;
-}
-
-void BIH::Hit(const Ray& ray, HitResult& hitResult) const
-{
-	hitResult.nodeTestCount = 0;
-
-	if (!Box(rootCell).Collide(ray, EPSILON, hitResult.distance))
-		return;
-
-	if (!nodes[0].isLeaf)
-		HitNode(ray, nodes[0], rootCell, hitResult);
-	else
-		HitLeaf(ray, nodes[0].firstObjectId, nodes[0].objectCount, hitResult);
-}
-
-void BIH::HitLeaf(const Ray& ray, uint firstObjectId, uint objectCount, HitResult& hitResult) const
-{
-	hitResult.nodeTestCount++;
-
-	ObjectId innerObjectId;
-	for (uint i = 0; i < objectCount; ++i)
-	{
-		real t = _INFINITY;
-		const ObjectId& objectId = objects->everything[firstObjectId + i];
-		switch (objectId.Type())
-		{
-			case ObjectType::Sphere: t = objects->spheres[objectId.index].Hit(ray); break;
-			case ObjectType::Box: t = objects->boxes[objectId.index].Hit(ray); break;
-			case ObjectType::Mesh: t = objects->meshes[objectId.index].Hit(ray, innerObjectId); break;
-			case ObjectType::SphereLightSource: t = objects->sphereLights[objectId.index].Hit(ray); break;
-			case ObjectType::BoxLightSource: t = objects->boxLights[objectId.index].Hit(ray); break;
-
-			case ObjectType::Plane:
-			case ObjectType::PointLightSource:
-			default:
-				t = _INFINITY;
-		}
-
-		if (t > EPSILON && t < hitResult.distance)
-		{
-			hitResult.distance = t;
-			hitResult.objectId = objectId;
-			if (objectId.Type() == ObjectType::Mesh)
-				hitResult.innerObjectId = innerObjectId;
-		}
-	}
-
-	hitResult.intersectionCount += objectCount;
-}
-
-void BIH::HitNode(const Ray& ray, const BIHNode& parentNode, const AACell& parentNodeCell, HitResult& hitResult) const
-{
-	hitResult.nodeTestCount++;
-
-	if (parentNode.leftNodeId)
-	{
-		AACell childCell = parentNodeCell;
-		childCell.maxCorner[parentNode.axis] = parentNode.leftPlane;
-		Box childNodeBox;
-		childNodeBox.cell = childCell;
-
-		if (childNodeBox.Collide(ray, EPSILON, hitResult.distance))
-		{
-			const BIHNode& childNode = nodes[parentNode.leftNodeId];
-			if (childNode.isLeaf)
-				HitLeaf(ray, childNode.firstObjectId, childNode.objectCount, hitResult);
-			else
-				HitNode(ray, childNode, childNodeBox.cell, hitResult);
-		}
-	}
-
-	if (parentNode.rightNodeId)
-	{
-		AACell childCell = parentNodeCell;
-		childCell.minCorner[parentNode.axis] = parentNode.rightPlane;
-		Box childNodeBox;
-		childNodeBox.cell = childCell;
-
-		if (childNodeBox.Collide(ray, EPSILON, hitResult.distance))
-		{
-			const BIHNode& childNode = nodes[parentNode.rightNodeId];
-			if (childNode.isLeaf)
-				HitLeaf(ray, childNode.firstObjectId, childNode.objectCount, hitResult);
-			else
-				HitNode(ray, childNode, childNodeBox.cell, hitResult);
-		}
-	}
-}
-
-bool BIH::Collide(const Ray& ray, real from, real to, const ObjectId* objectIdToSkip) const
-{
-	if (!Box(rootCell).Collide(ray, from, to))
-		return false;
-
-	if (maxDepth <= 0)
-		return true;
-
-	if (!nodes[0].isLeaf)
-		return CollideNode(ray, nodes[0], rootCell, from, to, objectIdToSkip);
-	else
-		return CollideLeaf(ray, nodes[0].firstObjectId, nodes[0].objectCount,
-			from, to, objectIdToSkip);
-}
-
-bool BIH::CollideLeaf(const Ray& ray, uint firstObjectId, uint objectCount,
-	real from, real to, const ObjectId* objectIdToSkip) const
-{
-	bool collision = false;
-	for (uint i = 0; i < objectCount; ++i)
-	{
-		const ObjectId& objectId = objects->everything[firstObjectId + i];
-		if ((objectId.Type() != ObjectType::Mesh) &&
-			(objectId.IsLight() || (objectIdToSkip != null && objectId._value == objectIdToSkip->_value)))
-			continue;
-
-		switch (objectId.Type())
-		{
-			case ObjectType::Sphere: 
-				collision = objects->spheres[objectId.index].Collide(ray, from, to); 
-				break;
-			case ObjectType::Box: 
-				collision = objects->boxes[objectId.index].Collide(ray, from, to);
-				break;
-			case ObjectType::Mesh:
-				collision = objects->meshes[objectId.index].Collide(ray, from, to);
-				break;
-			case ObjectType::SphereLightSource:
-				collision = objects->sphereLights[objectId.index].Collide(ray, from, to);
-				break;
-			case ObjectType::BoxLightSource:
-				collision = objects->boxLights[objectId.index].Collide(ray, from, to);
-				break;
-
-			case ObjectType::Plane:
-			case ObjectType::PointLightSource:
-			default:
-				break;
-		}
-
-		if (collision)
-			return true;
-	}
-
-	return false;
-}
-
-bool BIH::CollideNode(const Ray& ray, const BIHNode& parentNode, const AACell& parentNodeCell, 
-	real from, real to, const ObjectId* objectIdToSkip) const
-{
-	if (parentNode.leftNodeId)
-	{
-		AACell childCell = parentNodeCell;
-		childCell.maxCorner[parentNode.axis] = parentNode.leftPlane;
-		Box childNodeBox;
-		childNodeBox.cell = childCell;
-
-		if (childNodeBox.Collide(ray, from, to))
-		{
-			const BIHNode& childNode = nodes[parentNode.leftNodeId];
-			if (childNode.isLeaf)
-			{
-				if (CollideLeaf(ray, childNode.firstObjectId, childNode.objectCount, from, to, objectIdToSkip))
-					return true;
-			}
-			else
-			{
-				if (CollideNode(ray, childNode, childNodeBox.cell, from, to, objectIdToSkip))
-					return true;
-			}
-		}
-	}
-
-	if (parentNode.rightNodeId)
-	{
-		AACell childCell = parentNodeCell;
-		childCell.minCorner[parentNode.axis] = parentNode.rightPlane;
-		Box childNodeBox;
-		childNodeBox.cell = childCell;
-
-		if (childNodeBox.Collide(ray, from, to))
-		{
-			const BIHNode& childNode = nodes[parentNode.rightNodeId];
-			if (childNode.isLeaf)
-			{
-				if (CollideLeaf(ray, childNode.firstObjectId, childNode.objectCount, from, to, objectIdToSkip))
-					return true;
-			}
-			else
-			{
-				if (CollideNode(ray, childNode, childNodeBox.cell, from, to, objectIdToSkip))
-					return true;
-			}
-		}
-	}
-
-	return false;
-}
-
-void BIH::ShowStats()
-{
-	using namespace Common::Strings;
-
-	char tmpBuffer[256] = {};
-
-	if (numOfTreesConstructed)
-	{
-		const uint avgMemUsed =
-			(uint)((real)(numOfNodesUsed + numOfLeavesUsed) * sizeof(BIHNode)) / numOfTreesConstructed;
-
-		LOG_TL(LogLevel::Info, "Bounding interval hierarchy statistics:");
-		LOG_TL(LogLevel::Info, "\ttrees constructed:\t%I64d", numOfTreesConstructed);
-		//LOG_TL(LogLevel::Info, "\tconstruction time:\t%.3fms (avg %.3fms/tree)",
-		//	constructionTime, constructionTime / numOfTreesConstructed);
-		LOG_TL(LogLevel::Info, "\tdepth min/max/avg:\t%d/%d/%d", 
-			currentMinDepth, currentMaxDepth, depthSum / numOfTreesConstructed);
-		LOG_TL(LogLevel::Info, "\tobjects used:\t\t%I64d (avg %d/tree)", numOfObjectsUsed, 
-			numOfObjectsUsed / numOfTreesConstructed);
-		LOG_TL(LogLevel::Info, "\tnodes|leaves used:\t%I64d|%I64d (avg %d|%d/tree %s)", 
-			numOfNodesUsed, numOfLeavesUsed, 
-			numOfNodesUsed / numOfTreesConstructed, numOfLeavesUsed / numOfTreesConstructed,
-			GetMemSizeString(tmpBuffer, avgMemUsed));
-	}	
-}
-
+#include "Athena.h"
+#include "BoundingIntervalHierarchy.h"
+#include "Convert.h"
+#include "HitResult.h"
+#include "Rendering.h"
+#include "Scene.h"
+#include "Simd.h"
+#include "Timer.h"
+#include "Timers.h"
+#include "ZOrder.h"
+#include <cfloat>
+
+#define NODE_MEM_POOL_PAGE_SIZE	1024
+
+
+// node with ray interval [tmin, tmax] inside of it, used by non-recursive traversal
+struct BIHTraversalItem
+{
+	ui32 nodeId;
+	real tmin, tmax;
+};
+
+#define BIH_PACKET_REGISTERS	(BIH_PACKET_SIZE / SIMD_WIDTH)
+
+// rays of packet in SoA layout, all rays have the same direction signs
+struct BIHRayPacket
+{
+	simd_real origin[3][BIH_PACKET_REGISTERS];
+	simd_real invDirection[3][BIH_PACKET_REGISTERS];
+	v3ui sign;
+};
+
+// the same as BIHTraversalItem with interval for each ray, ray is inactive when tmin > tmax
+struct BIHPacketTraversalItem
+{
+	simd_real tmin[BIH_PACKET_REGISTERS];
+	simd_real tmax[BIH_PACKET_REGISTERS];
+	ui32 nodeId;
+};
+
+// ray for slab tests of wide nodes, each value is in all lanes, origin is rounded separately for near and far
+// corners, so float distances to near slabs are not longer and to far slabs not shorter than exact ones
+struct BIHWideRay
+{
+	simd_f32 nearOrigin[3];
+	simd_f32 farOrigin[3];
+	simd_f32 invDirection[3];
+	v3ui sign;
+};
+
+// child of wide node with distance where ray enters its bounds
+struct BIHWideTraversalItem
+{
+	ui32 childId;
+	ui32 objectCount; // 0 = node
+	real tmin;
+};
+
+// distances to far slabs are enlarged by rounding errors of float slab test
+#define BIH_WIDE_FAR_SCALE	(1 + 4 * FLT_EPSILON)
+
+inline void SetWideRay(const Ray& ray, BIHWideRay& wideRay)
+{
+	wideRay.sign = ray.sign;
+
+	for (uint axis = 0; axis < 3; ++axis)
+	{
+		const real origin = ray.origin.Get(axis);
+		const f32 originDown = ToFloatDown(origin);
+		const f32 originUp = ToFloatUp(origin);
+
+		// near corner is min corner for positive direction
+		wideRay.nearOrigin[axis] = SIMD_F32_SET1(ray.sign.Get(axis) ? originDown : originUp);
+		wideRay.farOrigin[axis] = SIMD_F32_SET1(ray.sign.Get(axis) ? originUp : originDown);
+		wideRay.invDirection[axis] = SIMD_F32_SET1((f32)ray.invDirection.Get(axis));
+	}
+}
+
+// cell is reduced to its intersection with bounds, it is empty (min corner above max corner) if they do not overlap
+inline void ClipCell(AACell& cell, const AACell& bounds)
+{
+	for (uint axis = 0; axis < 3; ++axis)
+	{
+		cell.minCorner[axis] = MAX2(cell.minCorner[axis], bounds.minCorner.Get(axis));
+		cell.maxCorner[axis] = MIN2(cell.maxCorner[axis], bounds.maxCorner.Get(axis));
+	}
+}
+
+inline bool IsCellEmpty(const AACell& cell)
+{
+	return cell.minCorner.Get(0) > cell.maxCorner.Get(0) || cell.minCorner.Get(1) > cell.maxCorner.Get(1) ||
+		cell.minCorner.Get(2) > cell.maxCorner.Get(2);
+}
+
+// treelet of node being restructured, subsets of its leaves are bit masks
+struct BIHTreelet
+{
+	uint32 leafNodeIds[BIH_TREELET_LEAVES];
+	// treelet root is the first one
+	uint32 internalNodeIds[BIH_TREELET_LEAVES - 1];
+	uint leafNodeCount, internalNodeCount;
+
+	// bounds and optimal topology of each subset, partition is left part of subset
+	AACell cells[BIH_TREELET_SUBSETS];
+	real costs[BIH_TREELET_SUBSETS];
+	real costDensities[BIH_TREELET_SUBSETS];
+	ui32 objectCounts[BIH_TREELET_SUBSETS];
+	ui32 heights[BIH_TREELET_SUBSETS];
+	ui8 partitions[BIH_TREELET_SUBSETS];
+	ui8 axes[BIH_TREELET_SUBSETS];
+};
+
+// SAH cost of subtree is computed for cell of its bounds, it is scaled by surface area to larger cell
+// clipped from its parent
+inline real GetCostDensity(real cost, ui32 objectCount, const AACell& cell)
+{
+	const real area = cell.GetSurfaceArea();
+
+	// flat subtree is treated as leaf
+	return area > 0 ? cost / area : BIH_SAH_INTERSECTION_COST * objectCount;
+}
+
+// stored before object ids and nodes of tree in scene cache
+struct BIHCacheHeader
+{
+	ui64 objectCount;
+	ui64 referenceCount;
+	ui64 nodeCount;
+
+	ui32 maxObjectsPerLeaf, maxDepth, sahBinCount, mortonSplit;
+	ui32 numOfNodes, numOfLeaves, depth;
+
+	real spatialSplitBudget;
+	real sahCost;
+	AACell rootCell;
+};
+
+// bit mask of rays with non-empty interval
+inline ui32 GetActiveRays(const simd_real* tmin, const simd_real* tmax)
+{
+	ui32 mask = 0;
+	for (uint r = 0; r < BIH_PACKET_REGISTERS; ++r)
+		mask |= SIMD_MOVEMASK(SIMD_CMPLE(tmin[r], tmax[r])) << (r * SIMD_WIDTH);
+
+	return mask;
+}
+
+
+void BIH::Destroy(MemoryManager* memoryManagerInstance)
+{
+	if (objectIds)
+	{
+		// bottom level trees of meshes are not reported
+		if (objects)
+			ShowStats();
+
+		objects = null;
+		objectIds = leafObjectIds = null;
+		nodes.Destroy();
+		topNodes.Destroy();
+		references.Destroy();
+		referenceCells.Destroy();
+
+		for (uint i = 0; i < taskNodes.count; ++i)
+			taskNodes[i].Destroy();
+		_MEM_FREE_ARRAY(memoryManagerInstance, list_of<BIHNode>, &taskNodes);
+
+		_MEM_FREE_ARRAY(memoryManagerInstance, ui8, &compactNodesMemory);
+		compactNodes = array_of<BIHCompactNode>();
+
+		_MEM_FREE_ARRAY(memoryManagerInstance, ui8, &wideNodesMemory);
+		wideNodes = array_of<BIHWideNode>();
+
+		_MEM_FREE_ARRAY(memoryManagerInstance, BIHPrimitive, &primitives);
+
+		_MEM_FREE_ARRAY(memoryManagerInstance, ui64, &mortonKeys[0]);
+		_MEM_FREE_ARRAY(memoryManagerInstance, ui64, &mortonKeys[1]);
+		_MEM_FREE_ARRAY(memoryManagerInstance, ui32, &mortonDigitCounts);
+		_MEM_FREE_ARRAY(memoryManagerInstance, ObjectId, &sortedObjectIds);
+		_MEM_FREE_ARRAY(memoryManagerInstance, AACell, &sortedObjectCells);
+		_MEM_FREE_ARRAY(memoryManagerInstance, BIHSubtreeInfo, &subtreeInfos);
+
+		if (triangles.count)
+		{
+			triangleIds.Destroy();
+			triangles = array_of<Triangle>();
+			vertices = array_of<v3f>();
+		}
+		else
+			LOG_DEBUG("BIH::Destroy");
+	}
+}
+
+void BIH::Initialize(Objects* objects, MemoryManager* memoryManagerInstance)
+{
+	InitializeTree(memoryManagerInstance, BIH_MAX_BUILD_TASKS);
+
+	this->objects = objects;
+	this->objectIds = &objects->everything;
+}
+
+void BIH::Initialize(const array_of<Triangle>& triangles, const array_of<v3f>& vertices,
+	MemoryManager* memoryManagerInstance)
+{
+	// bottom level tree is always constructed on calling thread
+	InitializeTree(memoryManagerInstance, 0);
+
+	this->triangles = triangles;
+	this->vertices = vertices;
+
+	triangleIds.Initialize(memoryManagerInstance, "ObjectId", MAX2(triangles.count, 1));
+	triangleIds.Add(triangles.count);
+	for (uint i = 0; i < triangles.count; ++i)
+		triangleIds[i].Set(ObjectType::Triangle, i);
+
+	this->objectIds = &triangleIds;
+}
+
+void BIH::InitializeTree(MemoryManager* memoryManagerInstance, uint maxBuildTasks)
+{
+	numOfLeavesUsed = numOfNodesUsed = numOfObjectsUsed = depthSum = 0;
+	numOfTreesConstructed = 0;
+	currentNumOfLeaves = currentNumOfNodes = 0;
+	currentDepth = currentMaxDepth = 0;
+	currentMinDepth = 0;
+	currentSahCost = sahCostSum = constructedSahCost = 0;
+	numOfTreesRefitted = numOfTreesLoaded = 0;
+	currentNumOfObjects = 0;
+	currentObjectsVersion = 0;
+	sahBinCount = 0;
+	mortonSplit = false;
+	totalTasksUsed = 0;
+	numOfCompactNodesUsed = numOfReferencesUsed = 0;
+	numOfTreeletPasses = numOfTreeletsRestructured = 0;
+	numOfWideTreesCollapsed = numOfWideNodesUsed = 0;
+	spatialSplitBudget = 0;
+	maxReferenceCount = 0;
+
+	nodes.Initialize(memoryManagerInstance, "BIHNode", NODE_MEM_POOL_PAGE_SIZE);
+	topNodes.Initialize(memoryManagerInstance, "BIHNode");
+	references.Initialize(memoryManagerInstance, "ObjectId");
+	referenceCells.Initialize(memoryManagerInstance, "AACell");
+
+	taskNodes = array_of<list_of<BIHNode>>();
+	if (maxBuildTasks)
+	{
+		taskNodes = _MEM_ALLOC_ARRAY(memoryManagerInstance, list_of<BIHNode>, maxBuildTasks);
+		// allocated memory can contain old data, list_of::Initialize expects empty list
+		memset(taskNodes.ptr, 0, sizeof(list_of<BIHNode>) * taskNodes.count);
+		for (uint i = 0; i < taskNodes.count; ++i)
+			taskNodes[i].Initialize(memoryManagerInstance, "BIHNode", NODE_MEM_POOL_PAGE_SIZE);
+	}
+	taskCount = taskDepth = 0;
+
+	mortonKeys[0] = mortonKeys[1] = array_of<ui64>();
+	mortonDigitCounts = array_of<ui32>();
+	sortedObjectIds = array_of<ObjectId>();
+	sortedObjectCells = array_of<AACell>();
+	mortonTaskCount = 0;
+
+	treeletPassCount = 0;
+	subtreeInfos = array_of<BIHSubtreeInfo>();
+
+	compactNodes = array_of<BIHCompactNode>();
+	compactNodesMemory = array_of<ui8>();
+	primitives = array_of<BIHPrimitive>();
+
+	wideTree = false;
+	wideNodes = array_of<BIHWideNode>();
+	wideNodesMemory = array_of<ui8>();
+
+	triangles = array_of<Triangle>();
+	vertices = array_of<v3f>();
+
+	this->memoryManagerInstance = memoryManagerInstance;
+	this->objects = null;
+	this->objectIds = this->leafObjectIds = null;
+}
+
+bool BIH::Update(array_of<std::thread>& threads, uint maxObjectsPerLeaf, uint maxDepth, bool sceneChanged,
+	AthenaStorage* athenaStorage)
+{
+	TIMED_BLOCK(&athenaStorage->timers[TimerId::BihConstruction]);
+
+	const RenderingParameters& parameters = athenaStorage->renderingParameters;
+
+	if (parameters.tracingMethod != TracingMethod::BoundingIntervalHierarchy &&
+		parameters.tracingMethod != TracingMethod::LinearBoundingIntervalHierarchy &&
+		parameters.tracingMethod != TracingMethod::WideBoundingVolumeHierarchy)
+	{
+		Clear();
+		return false;
+	}
+
+	// min value is 1
+	if (!maxObjectsPerLeaf)
+		maxObjectsPerLeaf = 1;
+
+	// traversal stack is limited
+	if (maxDepth > BIH_MAX_DEPTH)
+		maxDepth = BIH_MAX_DEPTH;
+
+	// linear tree is split only by Morton codes of objects
+	const b32 mortonSplit = parameters.tracingMethod == TracingMethod::LinearBoundingIntervalHierarchy;
+
+	// wide nodes are collapsed from the same tree, which is traversed by BIH
+	wideTree = parameters.tracingMethod == TracingMethod::WideBoundingVolumeHierarchy;
+
+	// binned SAH split, otherwise split in the middle of longest axis
+	uint sahBinCount = 0;
+	if (parameters.bihSahSplit && !mortonSplit)
+	{
+		sahBinCount = parameters.bihSahBinCount;
+		CLAMP(sahBinCount, 2, BIH_SAH_MAX_BINS);
+	}
+
+	// spatial splits are evaluated together with binned SAH
+	real spatialSplitBudget = 0;
+	if (sahBinCount && parameters.bihSpatialSplits)
+	{
+		spatialSplitBudget = parameters.bihSpatialSplitBudget;
+		CLAMP(spatialSplitBudget, 0, BIH_MAX_SPATIAL_SPLIT_BUDGET);
+	}
+
+	// existing tree can be reused if it was built with the same properties for the same objects
+	if (compactNodes.count &&
+		maxObjectsPerLeaf == this->maxObjectsPerLeaf && maxDepth == this->maxDepth &&
+		sahBinCount == this->sahBinCount && spatialSplitBudget == this->spatialSplitBudget &&
+		mortonSplit == this->mortonSplit && objects->version == currentObjectsVersion)
+	{
+		// tracing method was switched between binary and wide tree
+		if (wideTree != (wideNodes.count != 0))
+			UpdateWideNodes();
+
+		// nothing moved, topology of tree is improved by one restructuring pass per update
+		if (!sceneChanged)
+		{
+			if (treeletPassCount < parameters.bihTreeletPasses)
+				Restructure(threads);
+
+			return true;
+		}
+
+		if (parameters.bihRefit)
+		{
+			Refit();
+
+			// rebuild only when refitted tree is too bad compared to the last constructed one
+			if (currentSahCost <= constructedSahCost * parameters.bihMaxRefitDegradation)
+				return true;
+		}
+	}
+
+	// set tree properties
+	this->maxObjectsPerLeaf = maxObjectsPerLeaf;
+	this->maxDepth = maxDepth;
+	this->sahBinCount = sahBinCount;
+	this->spatialSplitBudget = spatialSplitBudget;
+	this->mortonSplit = mortonSplit;
+
+	return Construct(threads);
+}
+
+bool BIH::Update()
+{
+	if (compactNodes.count)
+	{
+		// topology of mesh does not change, so refit is enough until the tree degrades too much
+		Refit();
+
+		if (currentSahCost <= constructedSahCost * BIH_MESH_MAX_REFIT_DEGRADATION)
+			return true;
+	}
+
+	maxObjectsPerLeaf = BIH_MESH_MAX_OBJECTS_PER_LEAF;
+	maxDepth = BIH_MAX_DEPTH;
+	sahBinCount = BIH_MESH_SAH_BIN_COUNT;
+	spatialSplitBudget = BIH_MESH_SPATIAL_SPLIT_BUDGET;
+	mortonSplit = false;
+
+	array_of<std::thread> noThreads;
+	return Construct(noThreads);
+}
+
+void BIH::Clear()
+{
+	// clear memory pool
+	nodes.Clear();
+	topNodes.Clear();
+	for (uint i = 0; i < taskCount; ++i)
+		taskNodes[i].Clear();
+	taskCount = 0;
+	compactNodes.count = 0;
+	wideNodes.count = 0;
+	currentNumOfLeaves = currentNumOfNodes = 0;
+	currentNumOfObjects = 0;
+	currentDepth = 0;
+}
+
+bool BIH::Construct(array_of<std::thread>& threads)
+{
+	Clear();
+
+	if (!objectIds->currentCount || !maxDepth)
+		return false;
+
+	// get root bounding box
+	UpdateRootCell();
+
+	BIHNode rootNode;
+	rootNode.Clear();
+
+	const uint unknownObjectsCount = PreSortObjects();
+	const uint objectCount = objectIds->currentCount - unknownObjectsCount;
+
+	// nodes of linear tree only split ranges of objects sorted by Morton codes
+	if (mortonSplit)
+		SortMortonCodes(threads, unknownObjectsCount, objectCount);
+
+	// spatial splits add references, so tree is built over copy of object ids with their bounds
+	leafObjectIds = objectIds;
+	maxReferenceCount = 0;
+	if (spatialSplitBudget > 0)
+	{
+		references.Clear();
+		references.Add(objectIds->currentCount);
+		memcpy(references.array.ptr, objectIds->array.ptr, objectIds->currentCount * sizeof(ObjectId));
+
+		AACell objectCell;
+		v3f objectPosition;
+		referenceCells.Clear();
+		referenceCells.Add(objectIds->currentCount);
+		for (uint i = unknownObjectsCount; i < objectIds->currentCount; ++i)
+		{
+			GetObjectInfoById((*objectIds)[i], objectCell, objectPosition);
+			referenceCells[i].minCorner = objectCell.minCorner + objectPosition;
+			referenceCells[i].maxCorner = objectCell.maxCorner + objectPosition;
+		}
+
+		leafObjectIds = &references;
+		maxReferenceCount = objectIds->currentCount + (uint)(objectCount * spatialSplitBudget);
+	}
+
+	// split top of the tree to tasks, one task per thread
+	taskDepth = 0;
+	while (((uint)2 << taskDepth) <= MIN2(threads.count, BIH_MAX_BUILD_TASKS))
+		taskDepth++;
+
+	BIHBuildTask topTask;
+	topTask.Clear();
+	// references are appended by spatial splits, so tree with them is constructed on calling thread
+	topTask.spawnTasks = taskDepth && objectCount >= 2 * BIH_MIN_BUILD_TASK_OBJECTS && !maxReferenceCount;
+	topTask.nodes = topTask.spawnTasks ? &topNodes : &nodes;
+
+	// recursively create tree
+	CreateNode(topTask, (ui32)topTask.nodes->Add(rootNode), unknownObjectsCount, objectCount, rootCell);
+
+	currentNumOfObjects = objectIds->currentCount;
+	currentObjectsVersion = objects ? objects->version : 0;
+	treeletPassCount = 0;
+	currentNumOfNodes = topTask.numOfNodes;
+	currentNumOfLeaves = topTask.numOfLeaves;
+	currentDepth = topTask.maxDepth;
+
+	if (topTask.spawnTasks)
+	{
+		// construct subtrees on threads
+		for (uint i = 0; i < taskCount; ++i)
+			threads[i] = std::thread(&BIH::ProcessTask, this, &tasks[i]);
+		for (uint i = 0; i < taskCount; ++i)
+			threads[i].join();
+
+		for (uint i = 0; i < taskCount; ++i)
+		{
+			currentNumOfNodes += tasks[i].numOfNodes;
+			currentNumOfLeaves += tasks[i].numOfLeaves;
+			if (tasks[i].maxDepth > currentDepth)
+				currentDepth = tasks[i].maxDepth;
+		}
+
+		StitchNode(0);
+	}
+
+	if (mortonSplit)
+	{
+		// planes of linear tree are set from bounds of objects in one pass over the whole tree
+		AACell bounds;
+		RefitNode(0, bounds);
+		referenceCells.Clear();
+	}
+
+	if (maxReferenceCount)
+		CompactReferences();
+
+	UpdateCompactNodes();
+	UpdatePrimitives();
+
+	totalTasksUsed += taskCount;
+	
+	numOfTreesConstructed++;
+	numOfNodesUsed += currentNumOfNodes;
+	numOfLeavesUsed += currentNumOfLeaves;
+	numOfObjectsUsed += objectIds->currentCount;
+	numOfReferencesUsed += leafObjectIds->currentCount;
+	numOfCompactNodesUsed += compactNodes.count;
+	depthSum += currentDepth;
+
+	// SAH cost of the whole tree, normalized by root surface area
+	const real rootArea = rootCell.GetSurfaceArea();
+	currentSahCost = rootArea > 0 ? GetSahCost(nodes[0], rootCell) / rootArea : 0;
+	constructedSahCost = currentSahCost;
+	sahCostSum += currentSahCost;
+
+	if (currentDepth < currentMinDepth)
+		currentMinDepth = currentDepth;
+
+	if (currentDepth > currentMaxDepth)
+		currentMaxDepth = currentDepth;
+
+	return true;
+}
+
+void BIH::Refit()
+{
+	numOfTreesRefitted++;
+
+	UpdateRootCell();
+
+	AACell bounds;
+	RefitNode(0, bounds);
+
+	UpdateCompactNodes();
+	UpdatePrimitives();
+
+	const real rootArea = rootCell.GetSurfaceArea();
+	currentSahCost = rootArea > 0 ? GetSahCost(nodes[0], rootCell) / rootArea : 0;
+}
+
+void BIH::RefitNode(uint32 nodeId, AACell& bounds)
+{
+	BIHNode& node = nodes[nodeId];
+
+	bounds.SetEmpty();
+
+	if (node.isLeaf)
+	{
+		// whole objects are used, so refitted spatial split is only less tight
+		AACell objectCell;
+		for (uint i = 0; i < node.objectCount; ++i)
+			if (GetReferenceCell(node.firstObjectId + i, objectCell))
+				bounds.Add(objectCell);
+
+		return;
+	}
+
+	AACell childBounds;
+
+	if (node.leftNodeId)
+	{
+		RefitNode(node.leftNodeId, childBounds);
+		node.leftPlane = childBounds.maxCorner[node.axis];
+		bounds.Add(childBounds);
+	}
+
+	if (node.rightNodeId)
+	{
+		RefitNode(node.rightNodeId, childBounds);
+		node.rightPlane = childBounds.minCorner[node.axis];
+		bounds.Add(childBounds);
+	}
+}
+
+void BIH::Restructure(array_of<std::thread>& threads)
+{
+	numOfTreeletPasses++;
+	treeletPassCount++;
+
+	if (subtreeInfos.count < nodes.currentCount)
+	{
+		_MEM_FREE_ARRAY(memoryManagerInstance, BIHSubtreeInfo, &subtreeInfos);
+		subtreeInfos = _MEM_ALLOC_ARRAY(memoryManagerInstance, BIHSubtreeInfo, nodes.currentCount);
+	}
+
+	UpdateSubtreeInfo(0, 1);
+
+	// subtrees at task depth are restructured on threads, the same way as they are constructed
+	ui32 taskDepth = 0;
+	while (((uint)2 << taskDepth) <= MIN2(threads.count, BIH_MAX_BUILD_TASKS))
+		taskDepth++;
+
+	ui32 skipDepth = 0;
+	if (taskDepth && subtreeInfos[0].objectCount >= 2 * BIH_MIN_BUILD_TASK_OBJECTS)
+	{
+		skipDepth = taskDepth + 1;
+
+		// nodes at skipDepth, found breadth-first from root
+		uint32 taskNodeIds[BIH_MAX_BUILD_TASKS];
+		uint taskNodeCount = 1;
+		taskNodeIds[0] = 0;
+		for (ui32 depth = 1; depth < skipDepth; ++depth)
+		{
+			uint count = 0;
+			uint32 childNodeIds[BIH_MAX_BUILD_TASKS];
+			for (uint i = 0; i < taskNodeCount; ++i)
+			{
+				const BIHNode& node = nodes[taskNodeIds[i]];
+				if (node.isLeaf)
+					continue;
+				if (node.leftNodeId)
+					childNodeIds[count++] = node.leftNodeId;
+				if (node.rightNodeId)
+					childNodeIds[count++] = node.rightNodeId;
+			}
+
+			memcpy(taskNodeIds, childNodeIds, count * sizeof(uint32));
+			taskNodeCount = count;
+		}
+
+		uint treeletCounts[BIH_MAX_BUILD_TASKS] = {};
+		for (uint i = 0; i < taskNodeCount; ++i)
+			threads[i] = std::thread(&BIH::RestructureNode, this, taskNodeIds[i], 0, &treeletCounts[i]);
+		for (uint i = 0; i < taskNodeCount; ++i)
+		{
+			threads[i].join();
+			numOfTreeletsRestructured += treeletCounts[i];
+		}
+	}
+
+	uint treeletCount = 0;
+	RestructureNode(0, skipDepth, &treeletCount);
+	numOfTreeletsRestructured += treeletCount;
+
+	// restructured nodes are not stored in depth-first order, which is expected by cache, so they are
+	// copied again the same way as subtrees of tasks
+	topNodes.Clear();
+	topNodes.Add(nodes.currentCount);
+	memcpy(topNodes.array.ptr, nodes.array.ptr, nodes.currentCount * sizeof(BIHNode));
+	nodes.Clear();
+	StitchNode(0);
+
+	currentDepth = subtreeInfos[0].height;
+	if (currentDepth > currentMaxDepth)
+		currentMaxDepth = currentDepth;
+
+	UpdateCompactNodes();
+
+	// refitted tree is compared to the restructured one
+	const real rootArea = rootCell.GetSurfaceArea();
+	currentSahCost = rootArea > 0 ? GetSahCost(nodes[0], rootCell) / rootArea : 0;
+	constructedSahCost = currentSahCost;
+}
+
+void BIH::UpdateSubtreeInfo(uint32 nodeId, ui32 depth)
+{
+	const BIHNode& node = nodes[nodeId];
+	BIHSubtreeInfo& info = subtreeInfos[nodeId];
+
+	info.depth = depth;
+	info.height = 1;
+	info.cell.SetEmpty();
+
+	if (node.isLeaf)
+	{
+		info.objectCount = node.objectCount;
+
+		AACell objectCell;
+		for (uint i = 0; i < node.objectCount; ++i)
+			if (GetReferenceCell(node.firstObjectId + i, objectCell))
+				info.cell.Add(objectCell);
+
+		info.cost = BIH_SAH_INTERSECTION_COST * node.objectCount * info.cell.GetSurfaceArea();
+		return;
+	}
+
+	info.objectCount = 0;
+
+	const uint32 childNodeIds[2] = { node.leftNodeId, node.rightNodeId };
+	for (uint i = 0; i < 2; ++i)
+	{
+		// 0 = no child
+		if (!childNodeIds[i])
+			continue;
+
+		UpdateSubtreeInfo(childNodeIds[i], depth + 1);
+
+		const BIHSubtreeInfo& childInfo = subtreeInfos[childNodeIds[i]];
+		info.cell.Add(childInfo.cell);
+		info.objectCount += childInfo.objectCount;
+	}
+
+	UpdateSubtreeCost(nodeId);
+}
+
+void BIH::UpdateSubtreeCost(uint32 nodeId)
+{
+	const BIHNode& node = nodes[nodeId];
+	BIHSubtreeInfo& info = subtreeInfos[nodeId];
+
+	info.height = 1;
+	info.cost = BIH_SAH_TRAVERSAL_COST * info.cell.GetSurfaceArea();
+
+	if (node.leftNodeId)
+	{
+		const BIHSubtreeInfo& leftInfo = subtreeInfos[node.leftNodeId];
+		AACell leftCell = info.cell;
+		leftCell.maxCorner[node.axis] = node.leftPlane;
+
+		info.height = MAX2(info.height, leftInfo.height + 1);
+		info.cost += GetCostDensity(leftInfo.cost, leftInfo.objectCount, leftInfo.cell) * leftCell.GetSurfaceArea();
+	}
+
+	if (node.rightNodeId)
+	{
+		const BIHSubtreeInfo& rightInfo = subtreeInfos[node.rightNodeId];
+		AACell rightCell = info.cell;
+		rightCell.minCorner[node.axis] = node.rightPlane;
+
+		info.height = MAX2(info.height, rightInfo.height + 1);
+		info.cost += GetCostDensity(rightInfo.cost, rightInfo.objectCount, rightInfo.cell) * rightCell.GetSurfaceArea();
+	}
+}
+
+void BIH::RestructureNode(uint32 nodeId, ui32 skipDepth, uint* treeletCount)
+{
+	const BIHNode& node = nodes[nodeId];
+	BIHSubtreeInfo& info = subtreeInfos[nodeId];
+
+	if (node.isLeaf || info.depth == skipDepth)
+		return;
+
+	// descendants are restructured first, so height and cost of node are updated
+	if (node.leftNodeId)
+		RestructureNode(node.leftNodeId, skipDepth, treeletCount);
+	if (node.rightNodeId)
+		RestructureNode(node.rightNodeId, skipDepth, treeletCount);
+
+	UpdateSubtreeCost(nodeId);
+
+	if (RestructureTreelet(nodeId))
+		(*treeletCount)++;
+}
+
+bool BIH::RestructureTreelet(uint32 nodeId)
+{
+	// node with single child clips empty space, it is not part of any treelet
+	const BIHNode& rootNode = nodes[nodeId];
+	if (!rootNode.leftNodeId || !rootNode.rightNodeId)
+		return false;
+
+	BIHTreelet treelet;
+	treelet.internalNodeIds[0] = nodeId;
+	treelet.internalNodeCount = 1;
+	treelet.leafNodeIds[0] = rootNode.leftNodeId;
+	treelet.leafNodeIds[1] = rootNode.rightNodeId;
+	treelet.leafNodeCount = 2;
+
+	// treelet is formed by expanding its leaf with the largest surface area
+	while (treelet.leafNodeCount < BIH_TREELET_LEAVES)
+	{
+		real maxArea = -1;
+		uint maxAreaLeaf = 0;
+		for (uint i = 0; i < treelet.leafNodeCount; ++i)
+		{
+			const BIHNode& node = nodes[treelet.leafNodeIds[i]];
+			if (node.isLeaf || !node.leftNodeId || !node.rightNodeId)
+				continue;
+
+			const real area = subtreeInfos[treelet.leafNodeIds[i]].cell.GetSurfaceArea();
+			if (area > maxArea)
+			{
+				maxArea = area;
+				maxAreaLeaf = i;
+			}
+		}
+
+		if (maxArea < 0)
+			break;
+
+		const BIHNode& node = nodes[treelet.leafNodeIds[maxAreaLeaf]];
+		treelet.internalNodeIds[treelet.internalNodeCount++] = treelet.leafNodeIds[maxAreaLeaf];
+		treelet.leafNodeIds[maxAreaLeaf] = node.leftNodeId;
+		treelet.leafNodeIds[treelet.leafNodeCount++] = node.rightNodeId;
+	}
+
+	// two leaves have only one topology
+	if (treelet.leafNodeCount < 3)
+		return false;
+
+	// optimal topology of each subset of leaves is found from optimal topologies of smaller subsets
+	const ui32 subsetCount = 1 << treelet.leafNodeCount;
+	for (ui32 subset = 1; subset < subsetCount; ++subset)
+	{
+		const ui32 lowestLeafBit = subset & (~subset + 1);
+		if (subset == lowestLeafBit)
+		{
+			uint leaf = 0;
+			while (!(lowestLeafBit & (1 << leaf)))
+				leaf++;
+
+			const BIHSubtreeInfo& info = subtreeInfos[treelet.leafNodeIds[leaf]];
+			treelet.cells[subset] = info.cell;
+			treelet.objectCounts[subset] = info.objectCount;
+			treelet.heights[subset] = info.height;
+			treelet.costs[subset] = info.cost;
+			treelet.costDensities[subset] = GetCostDensity(info.cost, info.objectCount, info.cell);
+			continue;
+		}
+
+		AACell& cell = treelet.cells[subset];
+		cell = treelet.cells[subset ^ lowestLeafBit];
+		cell.Add(treelet.cells[lowestLeafBit]);
+		treelet.objectCounts[subset] = treelet.objectCounts[subset ^ lowestLeafBit] +
+			treelet.objectCounts[lowestLeafBit];
+
+		// surface area of cell clipped on axis to length l is 2 * (l * otherSizeSum + otherSizeProduct)
+		const v3f cellSize = cell.maxCorner - cell.minCorner;
+		const real otherSizeSums[3] = { cellSize.y + cellSize.z, cellSize.x + cellSize.z, cellSize.x + cellSize.y };
+		const real otherSizeProducts[3] = { cellSize.y * cellSize.z, cellSize.x * cellSize.z, cellSize.x * cellSize.y };
+
+		// each partition is tested once on each axis, part with lower center on axis is left one
+		treelet.costs[subset] = DBL_MAX;
+		for (ui32 others = subset ^ lowestLeafBit, part = others; ; part = (part - 1) & others)
+		{
+			const ui32 first = part | lowestLeafBit;
+			const ui32 second = subset ^ first;
+			const AACell& firstCell = treelet.cells[first];
+			const AACell& secondCell = treelet.cells[second];
+			for (uint8 axis = BIH_NODE_X_AXIS; axis <= BIH_NODE_Z_AXIS && second; ++axis)
+			{
+				const bool swap = firstCell.minCorner.Get(axis) + firstCell.maxCorner.Get(axis) >
+					secondCell.minCorner.Get(axis) + secondCell.maxCorner.Get(axis);
+				const ui32 left = swap ? second : first;
+				const ui32 right = swap ? first : second;
+
+				const real leftSize = treelet.cells[left].maxCorner.Get(axis) - cell.minCorner.Get(axis);
+				const real rightSize = cell.maxCorner.Get(axis) - treelet.cells[right].minCorner.Get(axis);
+				const real cost = 2 * (
+					treelet.costDensities[left] * (leftSize * otherSizeSums[axis] + otherSizeProducts[axis]) +
+					treelet.costDensities[right] * (rightSize * otherSizeSums[axis] + otherSizeProducts[axis]));
+				if (cost < treelet.costs[subset])
+				{
+					treelet.costs[subset] = cost;
+					treelet.partitions[subset] = (ui8)left;
+					treelet.axes[subset] = axis;
+				}
+			}
+
+			if (!part)
+				break;
+		}
+
+		treelet.costs[subset] += BIH_SAH_TRAVERSAL_COST * cell.GetSurfaceArea();
+		treelet.costDensities[subset] = GetCostDensity(treelet.costs[subset], treelet.objectCounts[subset], cell);
+
+		const ui32 partition = treelet.partitions[subset];
+		treelet.heights[subset] = MAX2(treelet.heights[partition], treelet.heights[subset ^ partition]) + 1;
+	}
+
+	// restructured treelet has to be cheaper and must not exceed max depth of traversal stack
+	const ui32 allLeaves = subsetCount - 1;
+	const ui32 depth = subtreeInfos[nodeId].depth;
+	if (treelet.costs[allLeaves] >= subtreeInfos[nodeId].cost * (1 - EPSILON) ||
+		depth + treelet.heights[allLeaves] - 1 > maxDepth)
+		return false;
+
+	uint nextInternalNode = 1;
+	SetTreeletNode(nodeId, allLeaves, depth, treelet, nextInternalNode);
+
+	return true;
+}
+
+void BIH::SetTreeletNode(uint32 nodeId, ui32 subset, ui32 depth, const BIHTreelet& treelet, uint& nextInternalNode)
+{
+	const ui32 childSubsets[2] = { treelet.partitions[subset], subset ^ treelet.partitions[subset] };
+	uint32 childNodeIds[2];
+
+	for (uint i = 0; i < 2; ++i)
+	{
+		// single leaf of treelet keeps its subtree, other subsets get next internal node
+		if (!(childSubsets[i] & (childSubsets[i] - 1)))
+		{
+			uint leaf = 0;
+			while (!(childSubsets[i] & (1 << leaf)))
+				leaf++;
+
+			childNodeIds[i] = treelet.leafNodeIds[leaf];
+			continue;
+		}
+
+		childNodeIds[i] = treelet.internalNodeIds[nextInternalNode++];
+		SetTreeletNode(childNodeIds[i], childSubsets[i], depth + 1, treelet, nextInternalNode);
+	}
+
+	const uint8 axis = treelet.axes[subset];
+
+	// planes are the same as refit sets them
+	BIHNode& node = nodes[nodeId];
+	node.axis = axis;
+	node.leftNodeId = childNodeIds[0];
+	node.rightNodeId = childNodeIds[1];
+	node.leftPlane = treelet.cells[childSubsets[0]].maxCorner.Get(axis);
+	node.rightPlane = treelet.cells[childSubsets[1]].minCorner.Get(axis);
+
+	BIHSubtreeInfo& info = subtreeInfos[nodeId];
+	info.cell = treelet.cells[subset];
+	info.objectCount = treelet.objectCounts[subset];
+	info.depth = depth;
+	info.height = treelet.heights[subset];
+	info.cost = treelet.costs[subset];
+}
+
+template <typename T> void AddObjectListToCell(const list_of<T>& objectList, AACell& cell)
+{
+	for (uint32 i = 0; i < (uint32)objectList.currentCount; ++i)
+	{
+		const T& object = objectList[i];
+		cell.minCorner.Set(
+			MIN2(object.cell.minCorner.x + object.position.x, cell.minCorner.x),
+			MIN2(object.cell.minCorner.y + object.position.y, cell.minCorner.y),
+			MIN2(object.cell.minCorner.z + object.position.z, cell.minCorner.z));
+		cell.maxCorner.Set(
+			MAX2(object.cell.maxCorner.x + object.position.x, cell.maxCorner.x),
+			MAX2(object.cell.maxCorner.y + object.position.y, cell.maxCorner.y),
+			MAX2(object.cell.maxCorner.z + object.position.z, cell.maxCorner.z));
+	}
+}
+
+void BIH::UpdateRootCell()
+{
+	rootCell.maxCorner.Set(-_INFINITY, -_INFINITY, -_INFINITY);
+	rootCell.minCorner.Set(_INFINITY, _INFINITY, _INFINITY);
+
+	if (triangles.count)
+	{
+		for (uint i = 0; i < triangles.count; ++i)
+		{
+			const Triangle& triangle = triangles[i];
+			rootCell.Add(vertices[triangle.v.x] + triangle.position);
+			rootCell.Add(vertices[triangle.v.y] + triangle.position);
+			rootCell.Add(vertices[triangle.v.z] + triangle.position);
+		}
+
+		return;
+	}
+
+	AddObjectListToCell<Box>(objects->boxes, rootCell);
+	AddObjectListToCell<Sphere>(objects->spheres, rootCell);
+	AddObjectListToCell<SphereLightSource>(objects->sphereLights, rootCell);
+	AddObjectListToCell<BoxLightSource>(objects->boxLights, rootCell);
+	AddObjectListToCell<Mesh>(objects->meshes, rootCell);
+	AddObjectListToCell<MeshInstance>(objects->meshInstances, rootCell);
+}
+
+void BIH::CreateNode(BIHBuildTask& task, uint32 nodeId, uint firstObjectId, uint objectCount, const AACell& cell,
+	uint depth)
+{
+	depth++;
+
+	list_of<BIHNode>& treeNodes = *task.nodes;
+
+	uint8 axis = BIH_NODE_X_AXIS;
+	real splitPlane = 0;
+	bool spatialSplit = false;
+	
+	if (objectCount <= maxObjectsPerLeaf || depth == maxDepth ||
+		(sahBinCount && !FindSahSplit(firstObjectId, objectCount, axis, splitPlane, spatialSplit)))
+	{
+		BIHNode& node = treeNodes[nodeId];
+
+		node.isLeaf = 1;
+		node.firstObjectId = (uint32)firstObjectId;
+		node.objectCount = (uint32)objectCount;
+
+		task.numOfLeaves++;
+
+		if (depth > task.maxDepth)
+			task.maxDepth = depth;
+
+		return;
+	}
+
+	task.numOfNodes++;
+
+	if (!sahBinCount && !mortonSplit)
+	{
+		v3f cellSize = cell.maxCorner - cell.minCorner;
+
+		// find longest dimension
+		if (cellSize.y > cellSize.x)
+			axis = BIH_NODE_Y_AXIS;
+
+		if (cellSize.z > cellSize[axis])
+			axis = BIH_NODE_Z_AXIS;
+
+		splitPlane = cellSize[axis] * .5 + cell.minCorner.Get(axis);
+	}
+
+	// objects of linear tree are already sorted, axis is found together with split
+	uint numOfObjectsOnLeft, rightFirstObjectId, numOfObjectsOnRight;
+	if (mortonSplit)
+		numOfObjectsOnLeft = FindMortonSplit(firstObjectId, objectCount, axis);
+
+	treeNodes[nodeId].axis = axis;
+
+	// sort objects by split plane
+	if (mortonSplit)
+	{
+		rightFirstObjectId = firstObjectId + numOfObjectsOnLeft;
+		numOfObjectsOnRight = objectCount - numOfObjectsOnLeft;
+	}
+	else if (spatialSplit)
+	{
+		SplitReferences(firstObjectId, objectCount, splitPlane, axis,
+			numOfObjectsOnLeft, rightFirstObjectId, numOfObjectsOnRight);
+	}
+	else
+	{
+		numOfObjectsOnLeft = SortObjects(firstObjectId, objectCount, splitPlane, axis);
+		rightFirstObjectId = firstObjectId + numOfObjectsOnLeft;
+		numOfObjectsOnRight = objectCount - numOfObjectsOnLeft;
+	}
+
+	treeNodes[nodeId].leftPlane = cell.minCorner.Get(treeNodes[nodeId].axis);
+	treeNodes[nodeId].rightPlane = cell.maxCorner.Get(treeNodes[nodeId].axis);
+
+	AACell objectCell;
+
+	// left interval
+	if (numOfObjectsOnLeft)
+	{
+		// get left plane, planes of linear tree are set after construction
+		for (uint i = 0; i < numOfObjectsOnLeft && !mortonSplit; i++)
+		{
+			if (!GetReferenceCell(firstObjectId + i, objectCell))
+				continue;
+			
+			const real objectMaxPlane = objectCell.maxCorner[treeNodes[nodeId].axis];
+
+			if (objectMaxPlane > treeNodes[nodeId].leftPlane)
+				treeNodes[nodeId].leftPlane = objectMaxPlane;
+		}
+
+		AACell leftCell = cell;
+		leftCell.maxCorner[treeNodes[nodeId].axis] = treeNodes[nodeId].leftPlane;
+		
+		BIHNode leftNode;
+		leftNode.Clear();
+		//leftnode.parentNodeId = nodeId;
+
+		// NOTE list can be reallocated by Add, so node is accessed after it
+		const ui32 leftNodeId = (ui32)treeNodes.Add(leftNode);
+		treeNodes[nodeId].leftNodeId = leftNodeId;
+		CreateChildNode(task, leftNodeId, firstObjectId, numOfObjectsOnLeft, leftCell, depth);
+	}
+
+	// right interval
+	if (numOfObjectsOnRight)
+	{
+		// get right plane
+		for (uint i = 0; i < numOfObjectsOnRight && !mortonSplit; i++)
+		{
+			if (!GetReferenceCell(rightFirstObjectId + i, objectCell))
+				continue;
+
+			const real objectMinPlane = objectCell.minCorner[treeNodes[nodeId].axis];
+			if (objectMinPlane < treeNodes[nodeId].rightPlane)
+				treeNodes[nodeId].rightPlane = objectMinPlane;
+		}
+
+		AACell rightCell = cell;
+		rightCell.minCorner[treeNodes[nodeId].axis] = treeNodes[nodeId].rightPlane;
+
+		BIHNode rightNode;
+		rightNode.Clear();
+		//rightNode.parentNodeId = nodeId;
+
+		const ui32 rightNodeId = (ui32)treeNodes.Add(rightNode);
+		treeNodes[nodeId].rightNodeId = rightNodeId;
+		CreateChildNode(task, rightNodeId, rightFirstObjectId, numOfObjectsOnRight, rightCell, depth);
+	}
+}
+
+void BIH::CreateChildNode(BIHBuildTask& task, uint32 nodeId, uint firstObjectId, uint objectCount,
+	const AACell& cell, uint depth)
+{
+	if (!task.spawnTasks || depth < taskDepth || objectCount < BIH_MIN_BUILD_TASK_OBJECTS ||
+		taskCount == BIH_MAX_BUILD_TASKS)
+	{
+		CreateNode(task, nodeId, firstObjectId, objectCount, cell, depth);
+		return;
+	}
+
+	// subtree will be constructed by task on separate thread
+	BIHNode& node = (*task.nodes)[nodeId];
+	node.isTask = 1;
+	node.firstObjectId = (uint32)taskCount;
+
+	BIHBuildTask& childTask = tasks[taskCount];
+	childTask.Clear();
+	childTask.nodes = &taskNodes[taskCount];
+	childTask.firstObjectId = firstObjectId;
+	childTask.objectCount = objectCount;
+	childTask.cell = cell;
+	childTask.depth = depth;
+
+	taskCount++;
+}
+
+void BIH::ProcessTask(BIHBuildTask* task)
+{
+	BIHNode rootNode;
+	rootNode.Clear();
+
+	CreateNode(*task, (ui32)task->nodes->Add(rootNode), task->firstObjectId, task->objectCount, task->cell,
+		task->depth);
+}
+
+uint32 BIH::StitchNode(uint32 topNodeId)
+{
+	const BIHNode& topNode = topNodes[topNodeId];
+
+	if (topNode.isTask)
+	{
+		// append whole subtree, its local node ids are shifted by its position in final list
+		const list_of<BIHNode>& subtreeNodes = *tasks[topNode.firstObjectId].nodes;
+		const uint32 offset = (ui32)nodes.Add(subtreeNodes.currentCount);
+
+		for (uint i = 0; i < subtreeNodes.currentCount; ++i)
+		{
+			BIHNode& node = nodes[offset + i];
+			node = subtreeNodes[i];
+			if (!node.isLeaf)
+			{
+				// 0 = no child
+				if (node.leftNodeId)
+					node.leftNodeId += offset;
+				if (node.rightNodeId)
+					node.rightNodeId += offset;
+			}
+		}
+
+		return offset;
+	}
+
+	// children are added after parent node and left subtree before right one, the same as CreateNode does
+	const uint32 nodeId = (ui32)nodes.Add(topNodes[topNodeId]);
+	if (!topNode.isLeaf)
+	{
+		const uint32 leftNodeId = topNode.leftNodeId ? StitchNode(topNode.leftNodeId) : 0;
+		const uint32 rightNodeId = topNode.rightNodeId ? StitchNode(topNode.rightNodeId) : 0;
+
+		nodes[nodeId].leftNodeId = leftNodeId;
+		nodes[nodeId].rightNodeId = rightNodeId;
+	}
+
+	return nodeId;
+}
+
+uint BIH::GetCacheSize() const
+{
+	if (!compactNodes.count)
+		return sizeof(BIHCacheHeader);
+
+	return sizeof(BIHCacheHeader) + leafObjectIds->currentCount * sizeof(ObjectId) + nodes.currentCount * sizeof(BIHNode);
+}
+
+void BIH::WriteCache(ui8* memory) const
+{
+	BIHCacheHeader* header = (BIHCacheHeader*)memory;
+	memset(header, 0, sizeof(BIHCacheHeader));
+
+	// empty tree is stored only as header
+	if (!compactNodes.count)
+		return;
+
+	header->objectCount = objectIds->currentCount;
+	header->referenceCount = leafObjectIds->currentCount;
+	header->nodeCount = nodes.currentCount;
+	header->maxObjectsPerLeaf = (ui32)maxObjectsPerLeaf;
+	header->maxDepth = (ui32)maxDepth;
+	header->sahBinCount = (ui32)sahBinCount;
+	header->mortonSplit = (ui32)mortonSplit;
+	header->spatialSplitBudget = spatialSplitBudget;
+	header->numOfNodes = (ui32)currentNumOfNodes;
+	header->numOfLeaves = (ui32)currentNumOfLeaves;
+	header->depth = (ui32)currentDepth;
+	header->sahCost = constructedSahCost;
+	header->rootCell = rootCell;
+
+	memory += sizeof(BIHCacheHeader);
+	memcpy(memory, leafObjectIds->array.ptr, header->referenceCount * sizeof(ObjectId));
+
+	memory += header->referenceCount * sizeof(ObjectId);
+	memcpy(memory, nodes.array.ptr, header->nodeCount * sizeof(BIHNode));
+}
+
+bool BIH::ReadCache(const ui8* memory, uint size)
+{
+	if (size < sizeof(BIHCacheHeader))
+		return false;
+
+	const BIHCacheHeader* header = (const BIHCacheHeader*)memory;
+	if (!header->nodeCount || header->objectCount != objectIds->currentCount ||
+		size != sizeof(BIHCacheHeader) + header->referenceCount * sizeof(ObjectId) + header->nodeCount * sizeof(BIHNode))
+		return false;
+
+	const ObjectId* cachedObjectIds = (const ObjectId*)(memory + sizeof(BIHCacheHeader));
+	const BIHNode* cachedNodes = (const BIHNode*)(cachedObjectIds + header->referenceCount);
+
+	// damaged file must not break traversal
+	for (uint i = 0; i < header->referenceCount; ++i)
+		if (objects && (cachedObjectIds[i].type >= ObjectType::Count ||
+			cachedObjectIds[i].index >= objects->counts[cachedObjectIds[i].type]))
+			return false;
+	uint numOfNodes = 0;
+	for (uint i = 0; i < header->nodeCount; ++i)
+	{
+		// children are always stored after parent, 0 = no child
+		const BIHNode& node = cachedNodes[i];
+		if (node.isLeaf ?
+			(uint)node.firstObjectId + node.objectCount > header->referenceCount :
+			((node.leftNodeId && (node.leftNodeId <= i || node.leftNodeId >= header->nodeCount)) ||
+			(node.rightNodeId && (node.rightNodeId <= i || node.rightNodeId >= header->nodeCount))))
+			return false;
+
+		if (!node.isLeaf)
+			numOfNodes++;
+	}
+
+	// compact nodes are allocated by this count
+	if (numOfNodes != header->numOfNodes)
+		return false;
+
+	Clear();
+
+	// leaves point to references, so objects of scene keep their order
+	references.Clear();
+	references.Add(header->referenceCount);
+	memcpy(references.array.ptr, cachedObjectIds, header->referenceCount * sizeof(ObjectId));
+	referenceCells.Clear();
+	leafObjectIds = &references;
+
+	nodes.Add(header->nodeCount);
+	memcpy(nodes.array.ptr, cachedNodes, header->nodeCount * sizeof(BIHNode));
+
+	maxObjectsPerLeaf = header->maxObjectsPerLeaf;
+	maxDepth = header->maxDepth;
+	sahBinCount = header->sahBinCount;
+	mortonSplit = header->mortonSplit;
+	spatialSplitBudget = header->spatialSplitBudget;
+	currentNumOfNodes = header->numOfNodes;
+	currentNumOfLeaves = header->numOfLeaves;
+	currentNumOfObjects = header->objectCount;
+	currentObjectsVersion = objects->version;
+	treeletPassCount = 0;
+	currentDepth = header->depth;
+	currentSahCost = constructedSahCost = header->sahCost;
+	rootCell = header->rootCell;
+
+	UpdateCompactNodes();
+	UpdatePrimitives();
+
+	numOfTreesLoaded++;
+
+	return true;
+}
+
+void BIH::UpdatePrimitives()
+{
+	const uint count = leafObjectIds->currentCount;
+	if (primitives.count != count)
+	{
+		_MEM_FREE_ARRAY(memoryManagerInstance, BIHPrimitive, &primitives);
+		if (count)
+			primitives = _MEM_ALLOC_ARRAY(memoryManagerInstance, BIHPrimitive, count);
+	}
+
+	// references are already sorted by leaves after construction
+	for (uint i = 0; i < count; ++i)
+	{
+		BIHPrimitive& primitive = primitives[i];
+		primitive.id = (*leafObjectIds)[i];
+
+		v3f position;
+		const AACell* cell = null;
+		switch (primitive.id.Type())
+		{
+			case ObjectType::Sphere:
+			{
+				const Sphere& sphere = objects->spheres[primitive.id.index];
+				position = sphere.position;
+				primitive.radius = sphere.radius;
+				break;
+			}
+			case ObjectType::SphereLightSource:
+			{
+				const SphereLightSource& light = objects->sphereLights[primitive.id.index];
+				position = light.position;
+				primitive.radius = light.radius;
+				break;
+			}
+			case ObjectType::Box:
+				position = objects->boxes[primitive.id.index].position;
+				cell = &objects->boxes[primitive.id.index].cell;
+				break;
+			case ObjectType::BoxLightSource:
+				position = objects->boxLights[primitive.id.index].position;
+				cell = &objects->boxLights[primitive.id.index].cell;
+				break;
+			case ObjectType::Triangle:
+			{
+				const Triangle& triangle = triangles[primitive.id.index];
+				position = vertices[triangle.v.x] + triangle.position;
+				for (uint j = 0; j < 2; ++j)
+				{
+					const v3f vertex = vertices[triangle.v.Get(j + 1)] + triangle.position;
+					primitive.vertices[j][0] = vertex.x;
+					primitive.vertices[j][1] = vertex.y;
+					primitive.vertices[j][2] = vertex.z;
+				}
+				break;
+			}
+
+			default:
+				// meshes are tested through their own tree
+				continue;
+		}
+
+		primitive.position[0] = position.x;
+		primitive.position[1] = position.y;
+		primitive.position[2] = position.z;
+
+		if (cell)
+		{
+			primitive.minCorner[0] = cell->minCorner.x;
+			primitive.minCorner[1] = cell->minCorner.y;
+			primitive.minCorner[2] = cell->minCorner.z;
+			primitive.maxCorner[0] = cell->maxCorner.x;
+			primitive.maxCorner[1] = cell->maxCorner.y;
+			primitive.maxCorner[2] = cell->maxCorner.z;
+		}
+	}
+}
+
+void BIH::UpdateCompactNodes()
+{
+	// root and pair of children for each node
+	const uint count = 1 + 2 * (uint)currentNumOfNodes;
+	const uint size = count * sizeof(BIHCompactNode) + BIH_CACHE_LINE_SIZE;
+
+	if (compactNodesMemory.count < size)
+	{
+		_MEM_FREE_ARRAY(memoryManagerInstance, ui8, &compactNodesMemory);
+		compactNodesMemory = _MEM_ALLOC_ARRAY(memoryManagerInstance, ui8, size * 2);
+	}
+
+	compactNodes.ptr = (BIHCompactNode*)
+		(((uint64)compactNodesMemory.ptr + BIH_CACHE_LINE_SIZE - 1) & ~(uint64)(BIH_CACHE_LINE_SIZE - 1));
+	compactNodes.count = count;
+
+	uint32 nextCompactNodeId = 1;
+	CompactNode(0, 0, nextCompactNodeId);
+
+	ASSERT(nextCompactNodeId == count);
+
+	UpdateWideNodes();
+}
+
+void BIH::CompactNode(uint32 nodeId, uint32 compactNodeId, uint32& nextCompactNodeId)
+{
+	const BIHNode& node = nodes[nodeId];
+	BIHCompactNode& compactNode = compactNodes[compactNodeId];
+
+	if (node.isLeaf)
+	{
+		compactNode.firstObjectId = node.firstObjectId;
+		compactNode.objectCount = node.objectCount;
+		compactNode.data = BIH_COMPACT_NODE_LEAF;
+		return;
+	}
+
+	// children are placed right after parent's subtree position, so left subtree follows them
+	const uint32 leftChildId = nextCompactNodeId;
+	nextCompactNodeId += 2;
+
+	compactNode.data = (leftChildId << 2) | node.axis;
+
+	// planes are rounded outwards, so objects stay inside of intervals
+	f32 leftPlane = -FLT_MAX, rightPlane = FLT_MAX;
+	if (node.leftNodeId)
+	{
+		leftPlane = (f32)node.leftPlane;
+		if (leftPlane < node.leftPlane)
+			leftPlane = nextafterf(leftPlane, FLT_MAX);
+	}
+	if (node.rightNodeId)
+	{
+		rightPlane = (f32)node.rightPlane;
+		if (rightPlane > node.rightPlane)
+			rightPlane = nextafterf(rightPlane, -FLT_MAX);
+	}
+	compactNode.planes[0] = leftPlane;
+	compactNode.planes[1] = rightPlane;
+
+	for (uint32 i = 0; i < 2; ++i)
+	{
+		const ui32 childNodeId = i ? node.rightNodeId : node.leftNodeId;
+		if (childNodeId)
+			CompactNode(childNodeId, leftChildId + i, nextCompactNodeId);
+		else
+		{
+			// empty leaf, never visited because of its plane
+			BIHCompactNode& emptyNode = compactNodes[leftChildId + i];
+			emptyNode.firstObjectId = emptyNode.objectCount = 0;
+			emptyNode.data = BIH_COMPACT_NODE_LEAF;
+		}
+	}
+}
+
+void BIH::UpdateWideNodes()
+{
+	if (!wideTree)
+	{
+		_MEM_FREE_ARRAY(memoryManagerInstance, ui8, &wideNodesMemory);
+		wideNodes = array_of<BIHWideNode>();
+		return;
+	}
+
+	numOfWideTreesCollapsed++;
+
+	// each wide node is made of at least one node
+	const uint size = nodes.currentCount * sizeof(BIHWideNode) + BIH_CACHE_LINE_SIZE;
+
+	if (wideNodesMemory.count < size)
+	{
+		_MEM_FREE_ARRAY(memoryManagerInstance, ui8, &wideNodesMemory);
+		wideNodesMemory = _MEM_ALLOC_ARRAY(memoryManagerInstance, ui8, size * 2);
+	}
+
+	wideNodes.ptr = (BIHWideNode*)
+		(((uint64)wideNodesMemory.ptr + BIH_CACHE_LINE_SIZE - 1) & ~(uint64)(BIH_CACHE_LINE_SIZE - 1));
+	wideNodes.count = nodes.currentCount;
+
+	// children are bounded by their subtrees, not only by planes
+	if (subtreeInfos.count < nodes.currentCount)
+	{
+		_MEM_FREE_ARRAY(memoryManagerInstance, BIHSubtreeInfo, &subtreeInfos);
+		subtreeInfos = _MEM_ALLOC_ARRAY(memoryManagerInstance, BIHSubtreeInfo, nodes.currentCount);
+	}
+
+	UpdateSubtreeInfo(0, 1);
+
+	AACell cell = rootCell;
+	ClipCell(cell, subtreeInfos[0].cell);
+
+	uint32 nextWideNodeId = 1;
+	CollapseNode(0, cell, 0, nextWideNodeId);
+
+	ASSERT(nextWideNodeId <= wideNodes.count);
+	wideNodes.count = nextWideNodeId;
+	numOfWideNodesUsed += nextWideNodeId;
+}
+
+void BIH::CollapseNode(uint32 nodeId, const AACell& cell, uint32 wideNodeId, uint32& nextWideNodeId)
+{
+	uint32 childNodeIds[BIH_WIDE_NODE_WIDTH];
+	AACell childCells[BIH_WIDE_NODE_WIDTH];
+	uint childCount = 0;
+
+	if (!IsCellEmpty(cell))
+	{
+		childNodeIds[0] = nodeId;
+		childCells[0] = cell;
+		childCount = 1;
+	}
+
+	while (true)
+	{
+		// node with the largest surface area is replaced by its children
+		uint openedId = childCount;
+		real openedArea = -1;
+		for (uint i = 0; i < childCount; ++i)
+		{
+			if (nodes[childNodeIds[i]].isLeaf)
+				continue;
+
+			const real area = childCells[i].GetSurfaceArea();
+			if (area > openedArea)
+			{
+				openedArea = area;
+				openedId = i;
+			}
+		}
+
+		if (openedId == childCount)
+			break;
+
+		const BIHNode& node = nodes[childNodeIds[openedId]];
+		if (childCount - 1 + (node.leftNodeId ? 1 : 0) + (node.rightNodeId ? 1 : 0) > BIH_WIDE_NODE_WIDTH)
+			break;
+
+		const AACell openedCell = childCells[openedId];
+
+		childCount--;
+		childNodeIds[openedId] = childNodeIds[childCount];
+		childCells[openedId] = childCells[childCount];
+
+		for (uint i = 0; i < 2; ++i)
+		{
+			// 0 = no child
+			const uint32 childNodeId = i ? node.rightNodeId : node.leftNodeId;
+			if (!childNodeId)
+				continue;
+
+			// cell of child is clipped by its plane and by bounds of its subtree
+			AACell childCell = openedCell;
+			if (i)
+				childCell.minCorner[node.axis] = MAX2(childCell.minCorner[node.axis], node.rightPlane);
+			else
+				childCell.maxCorner[node.axis] = MIN2(childCell.maxCorner[node.axis], node.leftPlane);
+			ClipCell(childCell, subtreeInfos[childNodeId].cell);
+
+			// empty leaves are dropped
+			if (IsCellEmpty(childCell) || (nodes[childNodeId].isLeaf && !nodes[childNodeId].objectCount))
+				continue;
+
+			childNodeIds[childCount] = childNodeId;
+			childCells[childCount] = childCell;
+			childCount++;
+		}
+	}
+
+	BIHWideNode& wideNode = wideNodes[wideNodeId];
+	for (uint lane = 0; lane < BIH_WIDE_NODE_LANES; ++lane)
+	{
+		for (uint axis = 0; axis < 3; ++axis)
+		{
+			wideNode.minCorners[axis][lane] = FLT_MAX;
+			wideNode.maxCorners[axis][lane] = -FLT_MAX;
+		}
+
+		wideNode.childIds[lane] = wideNode.objectCounts[lane] = 0;
+	}
+
+	// child nodes are stored next to each other, their subtrees follow
+	for (uint i = 0; i < childCount; ++i)
+	{
+		for (uint axis = 0; axis < 3; ++axis)
+		{
+			wideNode.minCorners[axis][i] = ToFloatDown(childCells[i].minCorner[axis]);
+			wideNode.maxCorners[axis][i] = ToFloatUp(childCells[i].maxCorner[axis]);
+		}
+
+		const BIHNode& child = nodes[childNodeIds[i]];
+		if (child.isLeaf)
+		{
+			wideNode.childIds[i] = child.firstObjectId;
+			wideNode.objectCounts[i] = child.objectCount;
+		}
+		else
+			wideNode.childIds[i] = nextWideNodeId++;
+	}
+
+	for (uint i = 0; i < childCount; ++i)
+		if (!nodes[childNodeIds[i]].isLeaf)
+			CollapseNode(childNodeIds[i], childCells[i], wideNode.childIds[i], nextWideNodeId);
+}
+
+void BIH::SortMortonCodes(array_of<std::thread>& threads, uint firstObjectId, uint objectCount)
+{
+	// buffers are kept for next constructions, dynamic scene is constructed each frame
+	const uint keyCount = objectIds->currentCount;
+	if (mortonKeys[0].count < keyCount)
+	{
+		for (uint i = 0; i < 2; ++i)
+		{
+			_MEM_FREE_ARRAY(memoryManagerInstance, ui64, &mortonKeys[i]);
+			mortonKeys[i] = _MEM_ALLOC_ARRAY(memoryManagerInstance, ui64, keyCount);
+		}
+
+		_MEM_FREE_ARRAY(memoryManagerInstance, ObjectId, &sortedObjectIds);
+		sortedObjectIds = _MEM_ALLOC_ARRAY(memoryManagerInstance, ObjectId, keyCount);
+		_MEM_FREE_ARRAY(memoryManagerInstance, AACell, &sortedObjectCells);
+		sortedObjectCells = _MEM_ALLOC_ARRAY(memoryManagerInstance, AACell, keyCount);
+	}
+
+	if (!mortonDigitCounts.count)
+		mortonDigitCounts = _MEM_ALLOC_ARRAY(memoryManagerInstance, ui32, BIH_MAX_BUILD_TASKS * BIH_MORTON_RADIX);
+
+	// bounds of objects are used by construction the same way as with spatial splits
+	referenceCells.Clear();
+	referenceCells.Add(keyCount);
+
+	// one task per thread, small scenes are sorted on calling thread
+	mortonTaskCount = 1;
+	if (objectCount >= 2 * BIH_MIN_BUILD_TASK_OBJECTS)
+		mortonTaskCount = MAX2(MIN2(threads.count, BIH_MAX_BUILD_TASKS), 1);
+
+	for (uint i = 0; i < mortonTaskCount; ++i)
+	{
+		BIHMortonTask& task = mortonTasks[i];
+		task.firstObjectId = firstObjectId + objectCount * i / mortonTaskCount;
+		task.objectCount = firstObjectId + objectCount * (i + 1) / mortonTaskCount - task.firstObjectId;
+		task.digitCounts = mortonDigitCounts.ptr + i * BIH_MORTON_RADIX;
+	}
+
+	RunMortonTasks(threads, &BIH::ComputeCentroidCell, 0);
+
+	centroidCell.SetEmpty();
+	for (uint i = 0; i < mortonTaskCount; ++i)
+		centroidCell.Add(mortonTasks[i].centroidCell);
+
+	RunMortonTasks(threads, &BIH::ComputeMortonCodes, 0);
+
+	// least significant digit first, keys with the same digit keep their order
+	for (uint pass = 0; pass < BIH_MORTON_RADIX_PASSES; ++pass)
+	{
+		RunMortonTasks(threads, &BIH::CountMortonDigits, pass);
+
+		// keys of each digit are placed after all smaller digits and after the same digit of previous tasks
+		ui32 position = (ui32)firstObjectId;
+		for (uint digit = 0; digit < BIH_MORTON_RADIX; ++digit)
+		{
+			for (uint i = 0; i < mortonTaskCount; ++i)
+			{
+				const ui32 count = mortonTasks[i].digitCounts[digit];
+				mortonTasks[i].digitCounts[digit] = position;
+				position += count;
+			}
+		}
+
+		RunMortonTasks(threads, &BIH::ScatterMortonKeys, pass);
+	}
+
+	RunMortonTasks(threads, &BIH::GatherMortonObjects, 0);
+
+	memcpy(objectIds->array.ptr + firstObjectId, sortedObjectIds.ptr + firstObjectId, objectCount * sizeof(ObjectId));
+	memcpy(referenceCells.array.ptr + firstObjectId, sortedObjectCells.ptr + firstObjectId,
+		objectCount * sizeof(AACell));
+}
+
+void BIH::RunMortonTasks(array_of<std::thread>& threads, void (BIH::*step)(BIHMortonTask*, uint), uint pass)
+{
+	if (mortonTaskCount == 1)
+	{
+		(this->*step)(&mortonTasks[0], pass);
+		return;
+	}
+
+	for (uint i = 0; i < mortonTaskCount; ++i)
+		threads[i] = std::thread(step, this, &mortonTasks[i], pass);
+	for (uint i = 0; i < mortonTaskCount; ++i)
+		threads[i].join();
+}
+
+void BIH::ComputeCentroidCell(BIHMortonTask* task, uint pass)
+{
+	task->centroidCell.SetEmpty();
+
+	AACell objectCell;
+	v3f objectPosition;
+	for (uint i = task->firstObjectId; i < task->firstObjectId + task->objectCount; ++i)
+	{
+		GetObjectInfoById((*objectIds)[i], objectCell, objectPosition);
+
+		AACell& referenceCell = referenceCells[i];
+		referenceCell.minCorner = objectCell.minCorner + objectPosition;
+		referenceCell.maxCorner = objectCell.maxCorner + objectPosition;
+
+		task->centroidCell.Add((referenceCell.minCorner + referenceCell.maxCorner) * .5);
+	}
+}
+
+void BIH::ComputeMortonCodes(BIHMortonTask* task, uint pass)
+{
+	// centroids are quantized relative to bounds of all centroids
+	const real maxCoord = (real)((1 << BIH_MORTON_BITS_PER_AXIS) - 1);
+	const v3f centroidCellSize = centroidCell.maxCorner - centroidCell.minCorner;
+	v3f scale;
+	for (uint i = 0; i < 3; ++i)
+		scale[i] = centroidCellSize.Get(i) > 0 ? maxCoord / centroidCellSize.Get(i) : 0;
+
+	ui64* keys = mortonKeys[0].ptr;
+	for (uint i = task->firstObjectId; i < task->firstObjectId + task->objectCount; ++i)
+	{
+		const AACell& referenceCell = referenceCells[i];
+		const v3f centroid = (referenceCell.minCorner + referenceCell.maxCorner) * .5 - centroidCell.minCorner;
+
+		v3ui coords;
+		coords.x = (ui32)MIN2(centroid.x * scale.x + .5, maxCoord);
+		coords.y = (ui32)MIN2(centroid.y * scale.y + .5, maxCoord);
+		coords.z = (ui32)MIN2(centroid.z * scale.z + .5, maxCoord);
+
+		keys[i] = ((ui64)ZOrder::Encode3ui(coords) << 32) | i;
+	}
+}
+
+void BIH::CountMortonDigits(BIHMortonTask* task, uint pass)
+{
+	const ui64* keys = mortonKeys[pass & 1].ptr;
+	const uint shift = 32 + pass * BIH_MORTON_RADIX_BITS;
+
+	memset(task->digitCounts, 0, BIH_MORTON_RADIX * sizeof(ui32));
+	for (uint i = task->firstObjectId; i < task->firstObjectId + task->objectCount; ++i)
+		task->digitCounts[(keys[i] >> shift) & (BIH_MORTON_RADIX - 1)]++;
+}
+
+void BIH::ScatterMortonKeys(BIHMortonTask* task, uint pass)
+{
+	const ui64* keys = mortonKeys[pass & 1].ptr;
+	ui64* sortedKeys = mortonKeys[(pass + 1) & 1].ptr;
+	const uint shift = 32 + pass * BIH_MORTON_RADIX_BITS;
+
+	for (uint i = task->firstObjectId; i < task->firstObjectId + task->objectCount; ++i)
+		sortedKeys[task->digitCounts[(keys[i] >> shift) & (BIH_MORTON_RADIX - 1)]++] = keys[i];
+}
+
+void BIH::GatherMortonObjects(BIHMortonTask* task, uint pass)
+{
+	const ui64* keys = mortonKeys[BIH_MORTON_RADIX_PASSES & 1].ptr;
+
+	for (uint i = task->firstObjectId; i < task->firstObjectId + task->objectCount; ++i)
+	{
+		const ui32 objectId = (ui32)keys[i];
+		sortedObjectIds[i] = (*objectIds)[objectId];
+		sortedObjectCells[i] = referenceCells[objectId];
+	}
+}
+
+uint BIH::FindMortonSplit(uint firstObjectId, uint objectCount, uint8& axis) const
+{
+	const ui64* keys = mortonKeys[BIH_MORTON_RADIX_PASSES & 1].ptr;
+	const ui32 firstCode = (ui32)(keys[firstObjectId] >> 32);
+	const ui32 lastCode = (ui32)(keys[firstObjectId + objectCount - 1] >> 32);
+
+	// objects with the same code are split in half
+	if (firstCode == lastCode)
+	{
+		axis = BIH_NODE_X_AXIS;
+		return objectCount / 2;
+	}
+
+	ui32 bit = BIH_MORTON_CODE_BITS - 1;
+	while (!(((firstCode ^ lastCode) >> bit) & 1))
+		bit--;
+
+	// bits of Morton code are interleaved x, y, z from the lowest one
+	axis = (uint8)(bit % 3);
+
+	// higher bits are the same for all objects, so the bit splits them to two sorted ranges,
+	// find the first object with the bit set
+	uint left = firstObjectId, right = firstObjectId + objectCount - 1;
+	while (right - left > 1)
+	{
+		const uint middle = (left + right) / 2;
+		if ((keys[middle] >> (32 + bit)) & 1)
+			right = middle;
+		else
+			left = middle;
+	}
+
+	return right - firstObjectId;
+}
+
+bool BIH::FindSahSplit(uint firstObjectId, uint objectCount, uint8& axis, real& splitPlane, bool& spatialSplit) const
+{
+	// "On fast Construction of SAH-based Bounding Volume Hierarchies"
+	// IEEE Symposium on Interactive Ray Tracing, 2007
+	// Ingo Wald
+
+	AACell objectCell, nodeCell, centroidCell;
+
+	nodeCell.SetEmpty();
+	centroidCell.SetEmpty();
+
+	// get bounds of all objects and of their centroids
+	for (uint i = 0; i < objectCount; ++i)
+	{
+		if (!GetReferenceCell(firstObjectId + i, objectCell))
+			continue;
+
+		nodeCell.Add(objectCell);
+		centroidCell.Add((objectCell.minCorner + objectCell.maxCorner) * .5);
+	}
+
+	// cost of leaf with all objects, costs are compared multiplied by node surface area
+	const real nodeArea = nodeCell.GetSurfaceArea();
+	real bestCost = BIH_SAH_INTERSECTION_COST * objectCount * nodeArea;
+	bool splitFound = false;
+
+	AACell binCells[BIH_SAH_MAX_BINS];
+	uint binObjectCounts[BIH_SAH_MAX_BINS];
+	real rightAreas[BIH_SAH_MAX_BINS];
+	uint rightObjectCounts[BIH_SAH_MAX_BINS];
+
+	for (uint8 binAxis = BIH_NODE_X_AXIS; binAxis <= BIH_NODE_Z_AXIS; ++binAxis)
+	{
+		const real centroidMin = centroidCell.minCorner[binAxis];
+		const real centroidExtent = centroidCell.maxCorner[binAxis] - centroidMin;
+
+		// all centroids lie on the same plane
+		if (centroidExtent < EPSILON)
+			continue;
+
+		for (uint b = 0; b < sahBinCount; ++b)
+		{
+			binCells[b].SetEmpty();
+			binObjectCounts[b] = 0;
+		}
+
+		// fill bins with objects by their centroids
+		const real binScale = sahBinCount / centroidExtent;
+		for (uint i = 0; i < objectCount; ++i)
+		{
+			if (!GetReferenceCell(firstObjectId + i, objectCell))
+				continue;
+
+			const real centroid = (objectCell.minCorner[binAxis] + objectCell.maxCorner[binAxis]) * .5;
+			uint binId = (uint)((centroid - centroidMin) * binScale);
+			if (binId >= sahBinCount)
+				binId = sahBinCount - 1;
+
+			binCells[binId].Add(objectCell);
+			binObjectCounts[binId]++;
+		}
+
+		// sweep from right, rightAreas[b] contains all bins after plane b
+		AACell sweepCell;
+		sweepCell.SetEmpty();
+		uint sweepObjectCount = 0;
+		for (uint b = sahBinCount - 1; b > 0; --b)
+		{
+			sweepCell.Add(binCells[b]);
+			sweepObjectCount += binObjectCounts[b];
+
+			rightAreas[b - 1] = sweepCell.GetSurfaceArea();
+			rightObjectCounts[b - 1] = sweepObjectCount;
+		}
+
+		// sweep from left and evaluate cost of each plane
+		sweepCell.SetEmpty();
+		sweepObjectCount = 0;
+		for (uint b = 0; b < sahBinCount - 1; ++b)
+		{
+			sweepCell.Add(binCells[b]);
+			sweepObjectCount += binObjectCounts[b];
+
+			if (!sweepObjectCount || !rightObjectCounts[b])
+				continue;
+
+			const real cost = BIH_SAH_TRAVERSAL_COST * nodeArea + BIH_SAH_INTERSECTION_COST *
+				(sweepCell.GetSurfaceArea() * sweepObjectCount + rightAreas[b] * rightObjectCounts[b]);
+
+			if (cost < bestCost)
+			{
+				bestCost = cost;
+				axis = binAxis;
+				splitPlane = centroidMin + (b + 1) / binScale;
+				splitFound = true;
+			}
+		}
+	}
+
+	spatialSplit = false;
+	if (maxReferenceCount && leafObjectIds->currentCount < maxReferenceCount &&
+		FindSpatialSplit(firstObjectId, objectCount, nodeCell, bestCost, axis, splitPlane))
+	{
+		spatialSplit = true;
+		splitFound = true;
+	}
+
+	return splitFound;
+}
+
+bool BIH::FindSpatialSplit(uint firstObjectId, uint objectCount, const AACell& nodeCell, real& bestCost,
+	uint8& axis, real& splitPlane) const
+{
+	// "Spatial Splits in Bounding Volume Hierarchies"
+	// High Performance Graphics, 2009
+	// Martin Stich, Heiko Friedrich, Andreas Dietrich
+
+	AACell objectCell, clippedCell;
+
+	const real nodeArea = nodeCell.GetSurfaceArea();
+	const uint freeReferenceCount = maxReferenceCount - leafObjectIds->currentCount;
+	bool splitFound = false;
+
+	AACell binCells[BIH_SAH_MAX_BINS];
+	uint binEntryCounts[BIH_SAH_MAX_BINS];
+	uint binExitCounts[BIH_SAH_MAX_BINS];
+	real rightAreas[BIH_SAH_MAX_BINS];
+	uint rightObjectCounts[BIH_SAH_MAX_BINS];
+
+	for (uint8 binAxis = BIH_NODE_X_AXIS; binAxis <= BIH_NODE_Z_AXIS; ++binAxis)
+	{
+		const real nodeMin = nodeCell.minCorner.Get(binAxis);
+		const real binSize = (nodeCell.maxCorner.Get(binAxis) - nodeMin) / sahBinCount;
+
+		if (binSize < EPSILON)
+			continue;
+
+		for (uint b = 0; b < sahBinCount; ++b)
+		{
+			binCells[b].SetEmpty();
+			binEntryCounts[b] = binExitCounts[b] = 0;
+		}
+
+		// object is clipped to each bin it overlaps, it enters first bin and exits last one
+		for (uint i = 0; i < objectCount; ++i)
+		{
+			if (!GetReferenceCell(firstObjectId + i, objectCell))
+				continue;
+
+			uint firstBinId = (uint)MAX2((objectCell.minCorner[binAxis] - nodeMin) / binSize, 0);
+			uint lastBinId = (uint)MAX2((objectCell.maxCorner[binAxis] - nodeMin) / binSize, 0);
+			firstBinId = MIN2(firstBinId, sahBinCount - 1);
+			lastBinId = MIN2(lastBinId, sahBinCount - 1);
+
+			for (uint b = firstBinId; b <= lastBinId; ++b)
+			{
+				clippedCell = objectCell;
+				clippedCell.minCorner[binAxis] = MAX2(objectCell.minCorner[binAxis], nodeMin + b * binSize);
+				clippedCell.maxCorner[binAxis] = MIN2(objectCell.maxCorner[binAxis], nodeMin + (b + 1) * binSize);
+				binCells[b].Add(clippedCell);
+			}
+
+			binEntryCounts[firstBinId]++;
+			binExitCounts[lastBinId]++;
+		}
+
+		// sweep from right, objects which exit after plane b are on right side
+		AACell sweepCell;
+		sweepCell.SetEmpty();
+		uint sweepObjectCount = 0;
+		for (uint b = sahBinCount - 1; b > 0; --b)
+		{
+			sweepCell.Add(binCells[b]);
+			sweepObjectCount += binExitCounts[b];
+
+			rightAreas[b - 1] = sweepCell.GetSurfaceArea();
+			rightObjectCounts[b - 1] = sweepObjectCount;
+		}
+
+		// sweep from left, objects which enter before plane b are on left side, crossing ones are on both
+		sweepCell.SetEmpty();
+		sweepObjectCount = 0;
+		for (uint b = 0; b < sahBinCount - 1; ++b)
+		{
+			sweepCell.Add(binCells[b]);
+			sweepObjectCount += binEntryCounts[b];
+
+			if (!sweepObjectCount || !rightObjectCounts[b] ||
+				sweepObjectCount + rightObjectCounts[b] - objectCount > freeReferenceCount)
+				continue;
+
+			const real cost = BIH_SAH_TRAVERSAL_COST * nodeArea + BIH_SAH_INTERSECTION_COST *
+				(sweepCell.GetSurfaceArea() * sweepObjectCount + rightAreas[b] * rightObjectCounts[b]);
+
+			if (cost < bestCost)
+			{
+				bestCost = cost;
+				axis = binAxis;
+				splitPlane = nodeMin + (b + 1) * binSize;
+				splitFound = true;
+			}
+		}
+	}
+
+	return splitFound;
+}
+
+real BIH::GetSahCost(const BIHNode& node, const AACell& nodeCell) const
+{
+	if (node.isLeaf)
+		return BIH_SAH_INTERSECTION_COST * node.objectCount * nodeCell.GetSurfaceArea();
+
+	real cost = BIH_SAH_TRAVERSAL_COST * nodeCell.GetSurfaceArea();
+
+	if (node.leftNodeId)
+	{
+		AACell childCell = nodeCell;
+		childCell.maxCorner[node.axis] = node.leftPlane;
+		cost += GetSahCost(nodes[node.leftNodeId], childCell);
+	}
+
+	if (node.rightNodeId)
+	{
+		AACell childCell = nodeCell;
+		childCell.minCorner[node.axis] = node.rightPlane;
+		cost += GetSahCost(nodes[node.rightNodeId], childCell);
+	}
+
+	return cost;
+}
+
+uint BIH::PreSortObjects()
+{
+	AACell objectCell;
+	v3f objectPosition;
+	uint lastUnknown = 0;
+	for (uint i = 0; i < objectIds->currentCount; ++i)
+	{
+		// if object is unknown
+		if (!GetObjectInfoById((*objectIds)[i], objectCell, objectPosition))
+		{
+			// find first known object from left
+			for (; lastUnknown < i; ++lastUnknown)
+			{
+				if (GetObjectInfoById((*objectIds)[lastUnknown], objectCell, objectPosition))
+				{
+					// swap objects, so unknown objects are from 0 to lastUnknown
+					ObjectId tmpObjectId = (*objectIds)[lastUnknown];
+					(*objectIds)[lastUnknown] = (*objectIds)[i];
+					(*objectIds)[i] = tmpObjectId;
+					// point lastUnknown to next object
+					break;
+				}
+			}
+			lastUnknown++;
+		}
+	}
+
+	return lastUnknown;
+}
+
+uint BIH::SortObjects(uint firstObjectId, uint objectCount, real splitPlane, uint8 axis)
+{
+	int64 leftId = firstObjectId, rightId = firstObjectId + objectCount - 1;
+	uint leftCount = 0;
+
+	AACell leftObjectCell, rightObjectCell;
+	while (leftId <= rightId)
+	{
+		auto leftFound = GetReferenceCell(leftId, leftObjectCell);
+		ASSERT(leftFound);
+		auto rightFound = GetReferenceCell(rightId, rightObjectCell);
+		ASSERT(rightFound);
+
+		const real leftCellMid = (leftObjectCell.maxCorner[axis] - leftObjectCell.minCorner[axis]) * .5 +
+			leftObjectCell.minCorner[axis];
+		const real rightCellMid = (rightObjectCell.maxCorner[axis] - rightObjectCell.minCorner[axis]) * .5 +
+			rightObjectCell.minCorner[axis];
+
+		// if both good
+		if (splitPlane >= leftCellMid && splitPlane <= rightCellMid)
+		{
+			leftCount++;
+
+			leftId++;
+			rightId--;
+			continue;
+		}
+
+		// if both bad
+		if (splitPlane <= leftCellMid && splitPlane >= rightCellMid)
+		{
+			// switch object indices
+			SwapReferences((uint)leftId, (uint)rightId);
+
+			leftCount++;
+
+			leftId++;
+			rightId--;
+			continue;
+		}
+
+		// if left is good then right is bad, so i have to find next left bad
+		if (splitPlane >= leftCellMid)
+		{
+			leftId++;
+			leftCount++;
+		}
+		else
+		{
+			rightId--;
+		}
+	}
+
+	return leftCount;
+}
+
+void BIH::SplitReferences(uint firstObjectId, uint objectCount, real splitPlane, uint8 axis,
+	uint& leftObjectCount, uint& rightFirstObjectId, uint& rightObjectCount)
+{
+	// sort to objects on left, objects crossing split plane and objects on right
+	uint leftId = firstObjectId, rightId = firstObjectId + objectCount;
+	for (uint i = firstObjectId; i < rightId;)
+	{
+		if (referenceCells[i].maxCorner[axis] <= splitPlane)
+			SwapReferences(i++, leftId++);
+		else if (referenceCells[i].minCorner[axis] >= splitPlane)
+			SwapReferences(i, --rightId);
+		else
+			i++;
+	}
+
+	const uint crossingCount = rightId - leftId;
+	leftObjectCount = rightId - firstObjectId;
+	rightObjectCount = firstObjectId + objectCount - leftId;
+
+	// NOTE lists can be reallocated by Add, so they are accessed by ids after it
+	rightFirstObjectId = references.Add(rightObjectCount);
+	referenceCells.Add(rightObjectCount);
+
+	for (uint i = 0; i < rightObjectCount; ++i)
+	{
+		references[rightFirstObjectId + i] = references[leftId + i];
+		referenceCells[rightFirstObjectId + i] = referenceCells[leftId + i];
+	}
+
+	for (uint i = 0; i < crossingCount; ++i)
+	{
+		referenceCells[leftId + i].maxCorner[axis] = splitPlane;
+		referenceCells[rightFirstObjectId + i].minCorner[axis] = splitPlane;
+	}
+}
+
+void BIH::SwapReferences(uint firstId, uint secondId)
+{
+	ObjectId tmpObjectId = (*leafObjectIds)[firstId];
+	(*leafObjectIds)[firstId] = (*leafObjectIds)[secondId];
+	(*leafObjectIds)[secondId] = tmpObjectId;
+
+	if (referenceCells.currentCount)
+	{
+		AACell tmpCell = referenceCells[firstId];
+		referenceCells[firstId] = referenceCells[secondId];
+		referenceCells[secondId] = tmpCell;
+	}
+}
+
+void BIH::CompactReferences()
+{
+	// nodes are stored in depth-first order, so leaves are visited in the same order as traversal sees them
+	array_of<ObjectId> leafReferences = _MEM_ALLOC_ARRAY(memoryManagerInstance, ObjectId, references.currentCount);
+
+	uint count = 0;
+	for (uint i = 0; i < nodes.currentCount; ++i)
+	{
+		BIHNode& node = nodes[i];
+		if (!node.isLeaf)
+			continue;
+
+		memcpy(leafReferences.ptr + count, references.array.ptr + node.firstObjectId,
+			node.objectCount * sizeof(ObjectId));
+		node.firstObjectId = (uint32)count;
+		count += node.objectCount;
+	}
+
+	references.Clear();
+	references.Add(count);
+	memcpy(references.array.ptr, leafReferences.ptr, count * sizeof(ObjectId));
+	_MEM_FREE_ARRAY(memoryManagerInstance, ObjectId, &leafReferences);
+
+	// clipped bounds are needed only during construction
+	referenceCells.Clear();
+}
+
+bool BIH::GetReferenceCell(uint referenceId, AACell& referenceCell) const
+{
+	if (referenceCells.currentCount)
+	{
+		referenceCell = referenceCells[referenceId];
+		return true;
+	}
+
+	v3f objectPosition;
+	if (!GetObjectInfoById((*leafObjectIds)[referenceId], referenceCell, objectPosition))
+		return false;
+
+	referenceCell.minCorner += objectPosition;
+	referenceCell.maxCorner += objectPosition;
+	return true;
+}
+
+bool BIH::GetObjectInfoById(const ObjectId& objectId, AACell& objectCell, v3f& objectPosition) const
+{
+	switch (objectId.Type())
+	{
+		case ObjectType::Sphere: 
+		{
+			const Sphere& object = objects->spheres[objectId.index];
+			objectCell = object.cell;
+			objectPosition = object.position;
+			return true;
+		}
+		
+		case ObjectType::Box:
+		{
+			const Box& object = objects->boxes[objectId.index];
+			objectCell = object.cell;
+			objectPosition = object.position;
+			return true;
+		}
+				
+		case ObjectType::Mesh:
+		{
+			const Mesh& object = objects->meshes[objectId.index];
+			objectCell = object.cell;
+			objectPosition = object.position;
+			return true;
+		}
+
+		case ObjectType::MeshInstance:
+		{
+			const MeshInstance& object = objects->meshInstances[objectId.index];
+			objectCell = object.cell;
+			objectPosition = object.position;
+			return true;
+		}
+
+		case ObjectType::SphereLightSource:
+		{
+			const SphereLightSource& object = objects->sphereLights[objectId.index];
+			objectCell = object.cell;
+			objectPosition = object.position;
+			return true;
+		}
+		
+		case ObjectType::BoxLightSource:
+		{
+			const BoxLightSource& object = objects->boxLights[objectId.index];
+			objectCell = object.cell;
+			objectPosition = object.position;
+			return true;
+		}
+
+		case ObjectType::Triangle:
+		{
+			const Triangle& object = triangles[objectId.index];
+			objectCell.SetEmpty();
+			objectCell.Add(vertices[object.v.x]);
+			objectCell.Add(vertices[object.v.y]);
+			objectCell.Add(vertices[object.v.z]);
+			objectPosition = object.position;
+			return true;
+		}
+
+		case ObjectType::PointLightSource:
+		case ObjectType::Plane:
+			break;
+	}
+
+	return false;
+}
+
+void BIH::Hit(const Ray& ray, HitResult& hitResult) const
+{
+	// ray interval is clipped by planes of nodes (as in BIH paper), near child is visited first
+
+	if (!compactNodes.count)
+		return;
+
+	BIHTraversalItem stack[BIH_MAX_DEPTH];
+	uint stackSize = 0;
+
+	BIHTraversalItem current;
+	current.nodeId = 0;
+	current.tmin = EPSILON;
+	current.tmax = hitResult.distance;
+
+	if (!ClipRay(ray, current.tmin, current.tmax))
+		return;
+
+	while (true)
+	{
+		const BIHCompactNode& node = compactNodes[current.nodeId];
+
+		if (node.IsLeaf())
+		{
+			HitLeaf(ray, node.firstObjectId, node.objectCount, hitResult);
+		}
+		else
+		{
+			hitResult.nodeTestCount++;
+
+			if (TraverseNode(ray, node, current, stack, stackSize))
+				continue;
+		}
+
+		// pop next node, nodes behind closest hit are skipped
+		do
+		{
+			if (!stackSize)
+				return;
+
+			current = stack[--stackSize];
+		}
+		while (current.tmin > hitResult.distance);
+
+		if (current.tmax > hitResult.distance)
+			current.tmax = hitResult.distance;
+	}
+}
+
+bool BIH::ClipRay(const Ray& ray, real& tmin, real& tmax) const
+{
+	// NOTE when ray is parallel with slab t can be NaN, comparisons below keep interval unchanged then
+	for (uint8 axis = BIH_NODE_X_AXIS; axis <= BIH_NODE_Z_AXIS; ++axis)
+	{
+		const real origin = ray.origin.Get(axis);
+		const real invDirection = ray.invDirection.Get(axis);
+
+		const real tNear = ((ray.sign.Get(axis) ? rootCell.maxCorner.Get(axis) : rootCell.minCorner.Get(axis)) -
+			origin) * invDirection;
+		const real tFar = ((ray.sign.Get(axis) ? rootCell.minCorner.Get(axis) : rootCell.maxCorner.Get(axis)) -
+			origin) * invDirection;
+
+		if (tNear > tmin)
+			tmin = tNear;
+		if (tFar < tmax)
+			tmax = tFar;
+	}
+
+	return tmin <= tmax;
+}
+
+bool BIH::TraverseNode(const Ray& ray, const BIHCompactNode& node, BIHTraversalItem& current,
+	BIHTraversalItem* stack, uint& stackSize) const
+{
+	const ui32 axis = node.GetAxis();
+	const real origin = ray.origin.Get(axis);
+	const real invDirection = ray.invDirection.Get(axis);
+
+	// left child is near one for positive direction
+	const ui32 nearChild = ray.sign.Get(axis) ? 1 : 0;
+	const ui32 nearNodeId = node.GetLeftChildId() + nearChild;
+	const ui32 farNodeId = node.GetLeftChildId() + (nearChild ^ 1);
+
+	// distances to planes, where ray leaves near child and enters far child
+	const real tNearPlane = ((real)node.planes[nearChild] - origin) * invDirection;
+	const real tFarPlane = ((real)node.planes[nearChild ^ 1] - origin) * invDirection;
+
+	// NOTE t is NaN when ray is parallel and lies on the plane, comparisons keep whole interval then
+	const real nearTmax = tNearPlane < current.tmax ? tNearPlane : current.tmax;
+	const real farTmin = tFarPlane > current.tmin ? tFarPlane : current.tmin;
+
+	const bool visitNear = current.tmin <= nearTmax;
+	const bool visitFar = farTmin <= current.tmax;
+
+	if (visitFar)
+	{
+		if (!visitNear)
+		{
+			current.nodeId = farNodeId;
+			current.tmin = farTmin;
+			return true;
+		}
+
+		ASSERT(stackSize < BIH_MAX_DEPTH);
+
+		BIHTraversalItem& farItem = stack[stackSize++];
+		farItem.nodeId = farNodeId;
+		farItem.tmin = farTmin;
+		farItem.tmax = current.tmax;
+	}
+
+	if (visitNear)
+	{
+		current.nodeId = nearNodeId;
+		current.tmax = nearTmax;
+		return true;
+	}
+
+	return false;
+}
+
+void BIH::HitPacket(const Ray* rays, HitResult* hitResults) const
+{
+	if (!compactNodes.count)
+		return;
+
+	// packet diverges, near child would not be the same for all rays
+	for (uint i = 1; i < BIH_PACKET_SIZE; ++i)
+	{
+		if (rays[i].sign.x != rays[0].sign.x || rays[i].sign.y != rays[0].sign.y || rays[i].sign.z != rays[0].sign.z)
+		{
+			for (uint j = 0; j < BIH_PACKET_SIZE; ++j)
+				Hit(rays[j], hitResults[j]);
+			return;
+		}
+	}
+
+	BIHRayPacket packet;
+	packet.sign = rays[0].sign;
+
+	BIHPacketTraversalItem current;
+	current.nodeId = 0;
+
+	real values[BIH_PACKET_SIZE];
+	for (uint8 axis = BIH_NODE_X_AXIS; axis <= BIH_NODE_Z_AXIS; ++axis)
+	{
+		for (uint i = 0; i < BIH_PACKET_SIZE; ++i)
+			values[i] = rays[i].origin.Get(axis);
+		for (uint r = 0; r < BIH_PACKET_REGISTERS; ++r)
+			packet.origin[axis][r] = SIMD_LOAD(values + r * SIMD_WIDTH);
+
+		for (uint i = 0; i < BIH_PACKET_SIZE; ++i)
+			values[i] = rays[i].invDirection.Get(axis);
+		for (uint r = 0; r < BIH_PACKET_REGISTERS; ++r)
+			packet.invDirection[axis][r] = SIMD_LOAD(values + r * SIMD_WIDTH);
+	}
+
+	// ray intervals clipped by root cell, ray missing it is inactive from the beginning
+	real tmin[BIH_PACKET_SIZE], tmax[BIH_PACKET_SIZE];
+	for (uint i = 0; i < BIH_PACKET_SIZE; ++i)
+	{
+		tmin[i] = EPSILON;
+		tmax[i] = hitResults[i].distance;
+		if (!ClipRay(rays[i], tmin[i], tmax[i]))
+			tmax[i] = -_INFINITY;
+	}
+	for (uint r = 0; r < BIH_PACKET_REGISTERS; ++r)
+	{
+		current.tmin[r] = SIMD_LOAD(tmin + r * SIMD_WIDTH);
+		current.tmax[r] = SIMD_LOAD(tmax + r * SIMD_WIDTH);
+	}
+
+	ui32 activeRays = GetActiveRays(current.tmin, current.tmax);
+	if (!activeRays)
+		return;
+
+	simd_real distance[BIH_PACKET_REGISTERS];
+	for (uint r = 0; r < BIH_PACKET_REGISTERS; ++r)
+		distance[r] = current.tmax[r];
+
+	BIHPacketTraversalItem stack[BIH_MAX_DEPTH];
+	uint stackSize = 0;
+
+	while (true)
+	{
+		const BIHCompactNode& node = compactNodes[current.nodeId];
+
+		if (node.IsLeaf())
+		{
+			for (uint i = 0; i < BIH_PACKET_SIZE; ++i)
+			{
+				if (activeRays & (1 << i))
+					HitLeaf(rays[i], node.firstObjectId, node.objectCount, hitResults[i]);
+				values[i] = hitResults[i].distance;
+			}
+
+			for (uint r = 0; r < BIH_PACKET_REGISTERS; ++r)
+				distance[r] = SIMD_LOAD(values + r * SIMD_WIDTH);
+		}
+		else
+		{
+			for (uint i = 0; i < BIH_PACKET_SIZE; ++i)
+				if (activeRays & (1 << i))
+					hitResults[i].nodeTestCount++;
+
+			if (TraversePacketNode(packet, node, current, stack, stackSize))
+			{
+				activeRays = GetActiveRays(current.tmin, current.tmax);
+				continue;
+			}
+		}
+
+		// pop next node, rays behind their closest hit are inactive
+		do
+		{
+			if (!stackSize)
+				return;
+
+			current = stack[--stackSize];
+			for (uint r = 0; r < BIH_PACKET_REGISTERS; ++r)
+				current.tmax[r] = SIMD_MIN(current.tmax[r], distance[r]);
+
+			activeRays = GetActiveRays(current.tmin, current.tmax);
+		}
+		while (!activeRays);
+	}
+}
+
+bool BIH::TraversePacketNode(const BIHRayPacket& packet, const BIHCompactNode& node, BIHPacketTraversalItem& current,
+	BIHPacketTraversalItem* stack, uint& stackSize) const
+{
+	const ui32 axis = node.GetAxis();
+
+	// left child is near one for positive direction
+	const ui32 nearChild = packet.sign.Get(axis) ? 1 : 0;
+	const simd_real nearPlane = SIMD_SET1((real)node.planes[nearChild]);
+	const simd_real farPlane = SIMD_SET1((real)node.planes[nearChild ^ 1]);
+
+	simd_real nearTmax[BIH_PACKET_REGISTERS], farTmin[BIH_PACKET_REGISTERS];
+	ui32 visitNear = 0, visitFar = 0;
+
+	for (uint r = 0; r < BIH_PACKET_REGISTERS; ++r)
+	{
+		const simd_real tNearPlane = SIMD_MUL(SIMD_SUB(nearPlane, packet.origin[axis][r]), packet.invDirection[axis][r]);
+		const simd_real tFarPlane = SIMD_MUL(SIMD_SUB(farPlane, packet.origin[axis][r]), packet.invDirection[axis][r]);
+
+		// NaN t keeps whole interval (see TraverseNode), min/max return second operand then
+		nearTmax[r] = SIMD_MIN(tNearPlane, current.tmax[r]);
+		farTmin[r] = SIMD_MAX(tFarPlane, current.tmin[r]);
+
+		visitNear |= SIMD_MOVEMASK(SIMD_CMPLE(current.tmin[r], nearTmax[r]));
+		visitFar |= SIMD_MOVEMASK(SIMD_CMPLE(farTmin[r], current.tmax[r]));
+	}
+
+	const ui32 nearNodeId = node.GetLeftChildId() + nearChild;
+	const ui32 farNodeId = node.GetLeftChildId() + (nearChild ^ 1);
+
+	if (visitFar)
+	{
+		if (!visitNear)
+		{
+			current.nodeId = farNodeId;
+			for (uint r = 0; r < BIH_PACKET_REGISTERS; ++r)
+				current.tmin[r] = farTmin[r];
+			return true;
+		}
+
+		ASSERT(stackSize < BIH_MAX_DEPTH);
+
+		BIHPacketTraversalItem& farItem = stack[stackSize++];
+		farItem.nodeId = farNodeId;
+		for (uint r = 0; r < BIH_PACKET_REGISTERS; ++r)
+		{
+			farItem.tmin[r] = farTmin[r];
+			farItem.tmax[r] = current.tmax[r];
+		}
+	}
+
+	if (visitNear)
+	{
+		current.nodeId = nearNodeId;
+		for (uint r = 0; r < BIH_PACKET_REGISTERS; ++r)
+			current.tmax[r] = nearTmax[r];
+		return true;
+	}
+
+	return false;
+}
+
+void BIH::HitLeaf(const Ray& ray, uint firstObjectId, uint objectCount, HitResult& hitResult) const
+{
+	hitResult.nodeTestCount++;
+
+	ObjectId innerObjectId;
+	for (uint i = 0; i < objectCount; ++i)
+	{
+		real t;
+		const BIHPrimitive& primitive = primitives[firstObjectId + i];
+		const ObjectId& objectId = primitive.id;
+		switch (objectId.Type())
+		{
+			case ObjectType::Mesh: t = objects->meshes[objectId.index].Hit(ray, innerObjectId); break;
+			case ObjectType::MeshInstance:
+			{
+				const MeshInstance& instance = objects->meshInstances[objectId.index];
+				t = instance.Hit(ray, objects->sharedMeshes[instance.meshIndex], innerObjectId);
+				break;
+			}
+
+			default:
+				t = primitive.Hit(ray);
+		}
+
+		if (t > EPSILON && t < hitResult.distance)
+		{
+			hitResult.distance = t;
+			hitResult.objectId = objectId;
+			if (objectId.Type() == ObjectType::Mesh || objectId.Type() == ObjectType::MeshInstance)
+				hitResult.innerObjectId = innerObjectId;
+		}
+	}
+
+	hitResult.intersectionCount += objectCount;
+}
+
+bool BIH::Collide(const Ray& ray, real from, real to, const ObjectId* objectIdToSkip) const
+{
+	if (!compactNodes.count)
+		return false;
+
+	BIHTraversalItem stack[BIH_MAX_DEPTH];
+	uint stackSize = 0;
+
+	BIHTraversalItem current;
+	current.nodeId = 0;
+	current.tmin = from;
+	current.tmax = to;
+
+	if (!ClipRay(ray, current.tmin, current.tmax))
+		return false;
+
+	if (maxDepth <= 0)
+		return true;
+
+	while (true)
+	{
+		const BIHCompactNode& node = compactNodes[current.nodeId];
+
+		if (node.IsLeaf())
+		{
+			if (CollideLeaf(ray, node.firstObjectId, node.objectCount, from, to, objectIdToSkip))
+				return true;
+		}
+		else if (TraverseNode(ray, node, current, stack, stackSize))
+			continue;
+
+		if (!stackSize)
+			return false;
+
+		current = stack[--stackSize];
+	}
+}
+
+bool BIH::CollideLeaf(const Ray& ray, uint firstObjectId, uint objectCount,
+	real from, real to, const ObjectId* objectIdToSkip) const
+{
+	bool collision = false;
+	for (uint i = 0; i < objectCount; ++i)
+	{
+		const BIHPrimitive& primitive = primitives[firstObjectId + i];
+		const ObjectId& objectId = primitive.id;
+		if ((objectId.Type() != ObjectType::Mesh && objectId.Type() != ObjectType::MeshInstance) &&
+			(objectId.IsLight() || (objectIdToSkip != null && objectId._value == objectIdToSkip->_value)))
+			continue;
+
+		switch (objectId.Type())
+		{
+			case ObjectType::Mesh:
+				collision = objects->meshes[objectId.index].Collide(ray, from, to);
+				break;
+			case ObjectType::MeshInstance:
+			{
+				const MeshInstance& instance = objects->meshInstances[objectId.index];
+				collision = instance.Collide(ray, objects->sharedMeshes[instance.meshIndex], from, to);
+				break;
+			}
+
+			default:
+				collision = primitive.Collide(ray, from, to);
+		}
+
+		if (collision)
+			return true;
+	}
+
+	return false;
+}
+
+void BIH::HitWide(const Ray& ray, HitResult& hitResult) const
+{
+	if (!wideNodes.count)
+		return;
+
+	BIHWideRay wideRay;
+	SetWideRay(ray, wideRay);
+
+	BIHWideTraversalItem stack[BIH_WIDE_STACK_SIZE];
+	uint stackSize = 0;
+
+	// root node
+	BIHWideTraversalItem current;
+	current.childId = current.objectCount = 0;
+	current.tmin = EPSILON;
+
+	while (true)
+	{
+		if (current.objectCount)
+		{
+			HitLeaf(ray, current.childId, current.objectCount, hitResult);
+		}
+		else
+		{
+			hitResult.nodeTestCount++;
+
+			if (TraverseWideNode(wideRay, wideNodes[current.childId], EPSILON, hitResult.distance, current,
+				stack, stackSize))
+				continue;
+		}
+
+		// pop next child, children behind closest hit are skipped
+		do
+		{
+			if (!stackSize)
+				return;
+
+			current = stack[--stackSize];
+		}
+		while (current.tmin > hitResult.distance);
+	}
+}
+
+bool BIH::TraverseWideNode(const BIHWideRay& ray, const BIHWideNode& node, real tmin, real tmax,
+	BIHWideTraversalItem& current, BIHWideTraversalItem* stack, uint& stackSize) const
+{
+	const simd_f32 tminLanes = SIMD_F32_SET1(ToFloatDown(tmin));
+	const simd_f32 tmaxLanes = SIMD_F32_SET1(ToFloatUp(tmax));
+	const simd_f32 farScale = SIMD_F32_SET1(BIH_WIDE_FAR_SCALE);
+
+	// distances where ray enters children, bit mask of hit ones
+	simd_f32 tEntries[BIH_WIDE_NODE_LANES / SIMD_F32_WIDTH];
+	ui32 hitMask = 0;
+
+	for (uint lane = 0; lane < BIH_WIDE_NODE_LANES; lane += SIMD_F32_WIDTH)
+	{
+		simd_f32 tEntry = tminLanes;
+		simd_f32 tExit = SIMD_F32_SET1(FLT_MAX);
+
+		for (uint axis = 0; axis < 3; ++axis)
+		{
+			const f32* nearCorners = ray.sign.Get(axis) ? node.maxCorners[axis] : node.minCorners[axis];
+			const f32* farCorners = ray.sign.Get(axis) ? node.minCorners[axis] : node.maxCorners[axis];
+
+			// NOTE t is NaN when ray is parallel and lies on the slab, comparisons keep interval unchanged then
+			tEntry = SIMD_F32_MAX(SIMD_F32_MUL(SIMD_F32_SUB(SIMD_F32_LOAD(nearCorners + lane), ray.nearOrigin[axis]),
+				ray.invDirection[axis]), tEntry);
+			tExit = SIMD_F32_MIN(SIMD_F32_MUL(SIMD_F32_SUB(SIMD_F32_LOAD(farCorners + lane), ray.farOrigin[axis]),
+				ray.invDirection[axis]), tExit);
+		}
+
+		tExit = SIMD_F32_MIN(SIMD_F32_MUL(tExit, farScale), tmaxLanes);
+
+		hitMask |= SIMD_F32_MOVEMASK(SIMD_F32_CMPLE(tEntry, tExit)) << lane;
+		tEntries[lane / SIMD_F32_WIDTH] = tEntry;
+	}
+
+	if (!hitMask)
+		return false;
+
+	// hit children sorted by entry distance
+	const f32* tEntry = (const f32*)tEntries;
+	ui32 hitLanes[BIH_WIDE_NODE_LANES];
+	uint hitCount = 0;
+	for (ui32 lane = 0; lane < BIH_WIDE_NODE_LANES; ++lane)
+	{
+		if (!(hitMask & (1 << lane)))
+			continue;
+
+		uint i = hitCount++;
+		for (; i > 0 && tEntry[hitLanes[i - 1]] > tEntry[lane]; --i)
+			hitLanes[i] = hitLanes[i - 1];
+		hitLanes[i] = lane;
+	}
+
+	// the farthest child is popped last
+	for (uint i = hitCount - 1; i > 0; --i)
+	{
+		ASSERT(stackSize < BIH_WIDE_STACK_SIZE);
+
+		BIHWideTraversalItem& item = stack[stackSize++];
+		item.childId = node.childIds[hitLanes[i]];
+		item.objectCount = node.objectCounts[hitLanes[i]];
+		item.tmin = tEntry[hitLanes[i]];
+	}
+
+	current.childId = node.childIds[hitLanes[0]];
+	current.objectCount = node.objectCounts[hitLanes[0]];
+	current.tmin = tEntry[hitLanes[0]];
+
+	return true;
+}
+
+bool BIH::CollideWide(const Ray& ray, real from, real to, const ObjectId* objectIdToSkip) const
+{
+	if (!wideNodes.count)
+		return false;
+
+	BIHWideRay wideRay;
+	SetWideRay(ray, wideRay);
+
+	BIHWideTraversalItem stack[BIH_WIDE_STACK_SIZE];
+	uint stackSize = 0;
+
+	BIHWideTraversalItem current;
+	current.childId = current.objectCount = 0;
+	current.tmin = from;
+
+	while (true)
+	{
+		if (current.objectCount)
+		{
+			if (CollideLeaf(ray, current.childId, current.objectCount, from, to, objectIdToSkip))
+				return true;
+		}
+		else if (TraverseWideNode(wideRay, wideNodes[current.childId], from, to, current, stack, stackSize))
+			continue;
+
+		if (!stackSize)
+			return false;
+
+		current = stack[--stackSize];
+	}
+}
+
+void BIH::ShowStats()
+{
+	using namespace Common::Strings;
+
+	char tmpBuffer[256] = {};
+	char tmpBuffer2[256] = {};
+
+	if (numOfTreesConstructed)
+	{
+		const uint avgMemUsed =
+			(uint)((real)(numOfNodesUsed + numOfLeavesUsed) * sizeof(BIHNode)) / numOfTreesConstructed;
+
+		LOG_TL(LogLevel::Info, "Bounding interval hierarchy statistics:");
+		LOG_TL(LogLevel::Info, "\ttrees constructed:\t%I64d", numOfTreesConstructed);
+		LOG_TL(LogLevel::Info, "\ttrees refitted:\t\t%I64d", numOfTreesRefitted);
+		LOG_TL(LogLevel::Info, "\ttrees loaded:\t\t%I64d", numOfTreesLoaded);
+		LOG_TL(LogLevel::Info, "\tsplit method:\t\t%s",
+			mortonSplit ? "Morton code" : sahBinCount ? "binned SAH" : "midpoint");
+		LOG_TL(LogLevel::Info, "\tbuild tasks used:\t~%d/tree", totalTasksUsed / numOfTreesConstructed);
+		//LOG_TL(LogLevel::Info, "\tconstruction time:\t%.3fms (avg %.3fms/tree)",
+		//	constructionTime, constructionTime / numOfTreesConstructed);
+		LOG_TL(LogLevel::Info, "\tdepth min/max/avg:\t%d/%d/%d", 
+			currentMinDepth, currentMaxDepth, depthSum / numOfTreesConstructed);
+		LOG_TL(LogLevel::Info, "\tobjects used:\t\t%I64d (avg %d/tree)", numOfObjectsUsed, 
+			numOfObjectsUsed / numOfTreesConstructed);
+		LOG_TL(LogLevel::Info, "\treferences used:\t%I64d (avg %d/tree, spatial split budget %.2f)",
+			numOfReferencesUsed, numOfReferencesUsed / numOfTreesConstructed, spatialSplitBudget);
+		LOG_TL(LogLevel::Info, "\tnodes|leaves used:\t%I64d|%I64d (avg %d|%d/tree %s)", 
+			numOfNodesUsed, numOfLeavesUsed, 
+			numOfNodesUsed / numOfTreesConstructed, numOfLeavesUsed / numOfTreesConstructed,
+			GetMemSizeString(tmpBuffer, avgMemUsed));
+		const uint avgCompactMemUsed =
+			(uint)((real)numOfCompactNodesUsed * sizeof(BIHCompactNode)) / numOfTreesConstructed;
+		LOG_TL(LogLevel::Info, "\tnode memory build/traversal:\t%s/%s (avg/tree)",
+			GetMemSizeString(tmpBuffer, avgMemUsed), GetMemSizeString(tmpBuffer2, avgCompactMemUsed));
+		LOG_TL(LogLevel::Info, "\ttreelet passes:\t\t%I64d (%I64d treelets restructured)",
+			numOfTreeletPasses, numOfTreeletsRestructured);
+		if (numOfWideTreesCollapsed)
+			LOG_TL(LogLevel::Info, "\twide nodes used:\t%I64d (avg %d/tree, %d children/node)",
+				numOfWideNodesUsed, numOfWideNodesUsed / numOfWideTreesCollapsed, BIH_WIDE_NODE_WIDTH);
+		LOG_TL(LogLevel::Info, "\tSAH cost last/avg:\t%.3f/%.3f",
+			currentSahCost, sahCostSum / numOfTreesConstructed);
+	}	
+}
+
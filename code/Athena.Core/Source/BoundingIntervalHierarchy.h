@@ -1,154 +1,544 @@
-#ifndef __bounding_interval_hierarchy_h
-#define __bounding_interval_hierarchy_h
-
-// Bounding Interval Hierarchy
-// EuroGraphics Symposium on Rendering, 2006
-//
-// Carsten Wchter and Alexander Keller
-//
-// http://ainc.de/Research/BIH.pdf
-
-#include "AACell.h"
-#include "List.h"
-#include "TypeDefs.h"
-#include "Vectors.h"
-
-#define BIH_NODE_X_AXIS		0
-#define BIH_NODE_Y_AXIS		1
-#define BIH_NODE_Z_AXIS		2
-
-struct _BIHLeaf
-{
-	// 8B
-	ui32 firstObjectId;
-	ui32 objectCount;
-};
-
-struct _BIHNode
-{
-	// 8B
-	f32 leftPlane;
-	f32 rightPlane;
-
-	// 8B
-	ui32 leftId;
-	ui32 righId;
-
-	// 4B
-	uint32 axis			: 2;
-	uint32 leftLeaf		: 1;
-	uint32 rightLeaf	: 1;
-	uint32 reserved		: 28; // reserved, because of 4B padding
-};
-
-// TODO rozdelit BIHNode na Node a Leaf
-#pragma pack(push, 4)
-struct BIHNode
-{
-	uint32 axis		: 2;
-	uint32 isLeaf	: 1;
-	uint32 reserved : 29; // reserved, because of 4B padding
-
-	union
-	{
-		// leaf
-		struct
-		{
-			ui32 firstObjectId;
-			ui32 objectCount;
-			
-			uint64 _leaf_reserved; // (because node is bigger than leaf, can hold additional data about leaf)
-#ifdef REAL_AS_DOUBLE
-			uint64 _leaf_reserved1;
-#endif
-		};
-
-		// node
-		struct
-		{
-			ui32 leftNodeId;
-			ui32 rightNodeId;
-
-			real leftPlane;
-			real rightPlane;
-		};
-	};
-
-	void Clear()
-	{
-		leftNodeId = rightNodeId = 0;
-		isLeaf = 0;
-	}
-};
-#pragma pack(pop)
-
-DLL_EXPORT_ARRAY_OF(BIHNode);
-DLL_EXPORT_LIST_OF(BIHNode);
-
-
-struct AthenaStorage;
-struct HitResult;
-struct ObjectId;
-struct Ray;
-struct Objects;
-
-class DLL_EXPORT BIH
-{
-public:
-
-	void Initialize(Objects* objects, MemoryManager* memoryManagerInstance);
-	bool Update(uint maxObjectsPerLeaf, uint maxDepth, AthenaStorage* athenaStorage);
-	void Destroy();
-
-	void Hit(const Ray& ray, HitResult& hitResult) const;
-	bool Collide(const Ray& ray, 
-		real from = EPSILON, real to = _INFINITY, const ObjectId* objectIdToSkip = null) const;
-
-	inline const uint GetCurrentDepth() const { return currentDepth; }
-	inline const uint GetCurrentNodeCount() const { return currentNumOfLeaves + currentNumOfNodes; }
-
-private:
-
-	void ShowStats();
-
-	void UpdateRootCell();
-	bool GetObjectInfoById(const ObjectId& objectId, AACell& objectCell, v3f& objectPosition) const;
-
-	void HitNode(const Ray& ray, const BIHNode& parentNode, const AACell& nodeCell, HitResult& hitResult) const;
-	void HitLeaf(const Ray& ray, uint firstObjectId, uint objectCount, HitResult& hitResult) const;
-	
-	bool CollideNode(const Ray& ray, const BIHNode& parentNode, const AACell& parentNodeCell,
-		real from, real to, const ObjectId* objectIdToSkip) const;
-	bool CollideLeaf(const Ray& ray, uint firstObjectId, uint objectCount,
-		real from, real to, const ObjectId* objectIdToSkip) const;
-
-	void CreateNode(uint32 nodeId, uint firstObjectId, uint objectCount, const AACell& cell, uint depth = 0);
-
-	// sorts all unknown objects to left and returns number of these objects
-	uint PreSortObjects();
-	// sort objects by splitPlane to left/right and returns number of objects on left side
-	uint SortObjects(uint firstObjectId, uint objectCount, real splitPlane, uint8 axis);
-
-private:
-
-	// statistics
-	uint64 numOfNodesUsed, numOfLeavesUsed;
-	uint64 numOfObjectsUsed;
-	uint64 numOfTreesConstructed;
-	uint64 depthSum;
-
-	uint currentNumOfNodes, currentNumOfLeaves;
-	uint currentDepth, currentMaxDepth, currentMinDepth;
-
-	// properties
-	uint maxObjectsPerLeaf;
-	uint maxDepth;
-	
-	// main tree properties
-	AACell rootCell;
-
-	Objects* objects;
-	list_of<BIHNode> nodes;
-};
-
-#endif __bounding_interval_hierarchy_h
+#ifndef __bounding_interval_hierarchy_h
+#define __bounding_interval_hierarchy_h
+
+// Bounding Interval Hierarchy
+// EuroGraphics Symposium on Rendering, 2006
+//
+// Carsten Wchter and Alexander Keller
+//
+// http://ainc.de/Research/BIH.pdf
+
+#include "AACell.h"
+#include "Array.h"
+#include "List.h"
+#include "Object.h"
+#include "Ray.h"
+#include "Simd.h"
+#include "Sphere.h"
+#include "thread"
+#include "Triangle.h"
+#include "TypeDefs.h"
+#include "Vectors.h"
+
+#define BIH_NODE_X_AXIS		0
+#define BIH_NODE_Y_AXIS		1
+#define BIH_NODE_Z_AXIS		2
+
+// max depth of tree, limited by size of traversal stack
+#define BIH_MAX_DEPTH		64
+
+// surface area heuristic
+#define BIH_SAH_MAX_BINS			64
+#define BIH_SAH_TRAVERSAL_COST		(real)1
+#define BIH_SAH_INTERSECTION_COST	(real)1
+
+// spatial splits, object crossing split plane is referenced by both children with bounds clipped by plane
+// budget is number of extra references relative to number of objects
+#define BIH_MAX_SPATIAL_SPLIT_BUDGET	(real)4
+
+// parallel construction
+#define BIH_MAX_BUILD_TASKS			16
+#define BIH_MIN_BUILD_TASK_OBJECTS	1024 // smaller subtrees are not worth of separate thread
+
+// linear construction, object centroids are quantized to 30 bit Morton codes, which are sorted by radix sort
+#define BIH_MORTON_BITS_PER_AXIS	10
+#define BIH_MORTON_CODE_BITS		(3 * BIH_MORTON_BITS_PER_AXIS)
+#define BIH_MORTON_RADIX_BITS		10
+#define BIH_MORTON_RADIX			(1 << BIH_MORTON_RADIX_BITS)
+#define BIH_MORTON_RADIX_PASSES		(BIH_MORTON_CODE_BITS / BIH_MORTON_RADIX_BITS)
+
+// treelet restructuring (Karras and Aila, Fast Parallel Construction of High-Quality Bounding Volume
+// Hierarchies), topology of treelet is replaced by the one with the lowest SAH cost of its nodes
+#define BIH_TREELET_LEAVES		7
+#define BIH_TREELET_SUBSETS		(1 << BIH_TREELET_LEAVES)
+
+// traversal nodes
+#define BIH_COMPACT_NODE_LEAF	3 // axis value of leaf
+#define BIH_CACHE_LINE_SIZE		64
+
+// coherent rays traced together (2x2 primary rays)
+#define BIH_PACKET_SIZE			4
+
+// wide tree (TracingMethod::WideBoundingVolumeHierarchy) is collapsed from binary tree, 4 or 8 children per node
+#define BIH_WIDE_NODE_WIDTH		8
+// children bounds fill whole SIMD registers, unused lanes are empty
+#define BIH_WIDE_NODE_LANES		(BIH_WIDE_NODE_WIDTH > SIMD_F32_WIDTH ? BIH_WIDE_NODE_WIDTH : SIMD_F32_WIDTH)
+// wide tree is not deeper than binary one, each visited node pushes all but one child
+#define BIH_WIDE_STACK_SIZE		(BIH_MAX_DEPTH * (BIH_WIDE_NODE_WIDTH - 1) + 1)
+
+// bottom level tree over mesh triangles
+#define BIH_MESH_MAX_OBJECTS_PER_LEAF		4
+#define BIH_MESH_SAH_BIN_COUNT				16
+#define BIH_MESH_MAX_REFIT_DEGRADATION		(real)2 // deformed mesh is constructed again above this
+#define BIH_MESH_SPATIAL_SPLIT_BUDGET		(real).25 // long thin triangles overlap many nodes
+
+// node used for traversal, both children are stored next to each other (left, right) in depth-first order
+#pragma pack(push, 4)
+struct BIHCompactNode
+{
+	union
+	{
+		// leaf
+		struct
+		{
+			ui32 firstObjectId;
+			ui32 objectCount;
+		};
+
+		// node (missing child has empty leaf with plane out of scene, so it is never visited)
+		f32 planes[2];
+	};
+
+	// axis in lowest 2 bits (BIH_COMPACT_NODE_LEAF for leaf), id of left child in the rest
+	ui32 data;
+
+	inline bool IsLeaf() const { return (data & 3) == BIH_COMPACT_NODE_LEAF; }
+	inline ui32 GetAxis() const { return data & 3; }
+	inline ui32 GetLeftChildId() const { return data >> 2; }
+};
+#pragma pack(pop)
+
+DLL_EXPORT_ARRAY_OF(BIHCompactNode);
+
+// node of wide tree, bounds of children are stored in SoA layout, so one slab test checks all of them
+// sizeof() = 256B for 8 children
+struct BIHWideNode
+{
+	// rounded outwards, empty child has min corner above max corner, so it is never hit
+	f32 minCorners[3][BIH_WIDE_NODE_LANES];
+	f32 maxCorners[3][BIH_WIDE_NODE_LANES];
+
+	// id of child node, or id of the first object of child leaf
+	ui32 childIds[BIH_WIDE_NODE_LANES];
+	// 0 for child node
+	ui32 objectCounts[BIH_WIDE_NODE_LANES];
+};
+
+DLL_EXPORT_ARRAY_OF(BIHWideNode);
+
+// TODO rozdelit BIHNode na Node a Leaf
+#pragma pack(push, 4)
+struct BIHNode
+{
+	uint32 axis		: 2;
+	uint32 isLeaf	: 1;
+	uint32 isTask	: 1; // used only during construction, subtree is built by task with id firstObjectId
+	uint32 reserved : 28; // reserved, because of 4B padding
+
+	union
+	{
+		// leaf
+		struct
+		{
+			ui32 firstObjectId;
+			ui32 objectCount;
+			
+			uint64 _leaf_reserved; // (because node is bigger than leaf, can hold additional data about leaf)
+#ifdef REAL_AS_DOUBLE
+			uint64 _leaf_reserved1;
+#endif
+		};
+
+		// node
+		struct
+		{
+			ui32 leftNodeId;
+			ui32 rightNodeId;
+
+			real leftPlane;
+			real rightPlane;
+		};
+	};
+
+	void Clear()
+	{
+		leftNodeId = rightNodeId = 0;
+		isLeaf = isTask = 0;
+	}
+};
+#pragma pack(pop)
+
+// geometry of object copied to leaf order, so leaves do not need to look into object lists
+// (meshes keep only id, they are traversed by their own tree)
+struct BIHPrimitive
+{
+	ObjectId id;
+
+	// sphere center, box position or first vertex of triangle
+	real position[3];
+
+	union
+	{
+		// sphere
+		real radius;
+
+		// box, corners are relative to position
+		struct
+		{
+			real minCorner[3];
+			real maxCorner[3];
+		};
+
+		// remaining vertices of triangle
+		real vertices[2][3];
+	};
+
+	// returns _INFINITY for objects without inline geometry
+	__device__ real Hit(const Ray& ray) const
+	{
+		switch (id.Type())
+		{
+			case ObjectType::Sphere:
+			case ObjectType::SphereLightSource:
+				return Sphere::Hit(ray, GetPosition(), radius);
+
+			case ObjectType::Box:
+			case ObjectType::BoxLightSource:
+			{
+				Ray localRay(ray);
+				localRay.origin = ray.origin - GetPosition();
+				return GetCell().Hit(localRay);
+			}
+
+			case ObjectType::Triangle:
+				return Triangle::Hit(ray, GetPosition(), GetVertex(0), GetVertex(1));
+		}
+
+		return _INFINITY;
+	}
+
+	__device__ bool Collide(const Ray& ray, real from, real to) const
+	{
+		switch (id.Type())
+		{
+			case ObjectType::Sphere:
+			case ObjectType::SphereLightSource:
+				return Sphere::Collide(ray, GetPosition(), radius, from, to);
+
+			case ObjectType::Box:
+			case ObjectType::BoxLightSource:
+			{
+				Ray localRay(ray);
+				localRay.origin = GetPosition() - ray.origin;
+				return GetCell().Collide(localRay, from, to);
+			}
+
+			case ObjectType::Triangle:
+				return Triangle::Collide(ray, GetPosition(), GetVertex(0), GetVertex(1), from, to);
+		}
+
+		return false;
+	}
+
+	inline __device__ AACell GetCell() const
+	{
+		AACell cell;
+		cell.minCorner.Set(minCorner[0], minCorner[1], minCorner[2]);
+		cell.maxCorner.Set(maxCorner[0], maxCorner[1], maxCorner[2]);
+		return cell;
+	}
+
+	inline __device__ v3f GetPosition() const { return v3f(position[0], position[1], position[2]); }
+	inline __device__ v3f GetVertex(uint i) const { return v3f(vertices[i][0], vertices[i][1], vertices[i][2]); }
+};
+
+DLL_EXPORT_ARRAY_OF(BIHPrimitive);
+DLL_EXPORT_ARRAY_OF(BIHNode);
+DLL_EXPORT_LIST_OF(BIHNode);
+DLL_EXPORT_ARRAY_OF(list_of<BIHNode>);
+DLL_EXPORT_ARRAY_OF(ObjectId);
+DLL_EXPORT_LIST_OF(ObjectId);
+DLL_EXPORT_ARRAY_OF(AACell);
+DLL_EXPORT_LIST_OF(AACell);
+
+// (sub)tree construction, each task has its own node list and statistics
+struct BIHBuildTask
+{
+	list_of<BIHNode>* nodes;
+	b32 spawnTasks; // top of the tree only, creates tasks instead of subtrees at task depth
+
+	// subtree root
+	uint firstObjectId, objectCount;
+	AACell cell;
+	uint depth;
+
+	// statistics
+	uint numOfNodes, numOfLeaves, maxDepth;
+
+	void Clear()
+	{
+		nodes = null;
+		spawnTasks = false;
+		firstObjectId = objectCount = depth = 0;
+		numOfNodes = numOfLeaves = maxDepth = 0;
+	}
+};
+
+// contiguous part of objects sorted by one thread during linear construction
+struct BIHMortonTask
+{
+	uint firstObjectId, objectCount;
+	// bounds of centroids of task objects
+	AACell centroidCell;
+	// counts of radix digits of task keys, turned to positions of the first task key with each digit
+	ui32* digitCounts;
+};
+
+// bounds of whole subtree of node, used by treelet restructuring
+struct BIHSubtreeInfo
+{
+	AACell cell;
+	ui32 objectCount;
+	// root node has depth 1, leaf has height 1
+	ui32 depth, height;
+	// SAH cost (not normalized) for cell of subtree bounds
+	real cost;
+};
+
+DLL_EXPORT_ARRAY_OF(BIHSubtreeInfo);
+
+
+struct AthenaStorage;
+struct BIHPacketTraversalItem;
+struct BIHRayPacket;
+struct BIHTraversalItem;
+struct BIHTreelet;
+struct BIHWideRay;
+struct BIHWideTraversalItem;
+struct HitResult;
+struct ObjectId;
+struct Ray;
+struct Objects;
+struct Triangle;
+
+class DLL_EXPORT BIH
+{
+public:
+
+	void Initialize(Objects* objects, MemoryManager* memoryManagerInstance);
+	// constructs new tree or refits existing one when objects moved (sceneChanged)
+	// linear tree (TracingMethod::LinearBoundingIntervalHierarchy) is split by Morton codes of objects,
+	// its construction is much faster, but traversal is slower than with SAH tree
+	// tree of static scene is improved by one treelet restructuring pass per call (up to bihTreeletPasses)
+	// wide tree (TracingMethod::WideBoundingVolumeHierarchy) is collapsed from SAH tree whenever it changes
+	bool Update(array_of<std::thread>& threads, uint maxObjectsPerLeaf, uint maxDepth, bool sceneChanged,
+		AthenaStorage* athenaStorage);
+
+	// bottom level tree over triangles of mesh, in local space of mesh
+	void Initialize(const array_of<Triangle>& triangles, const array_of<v3f>& vertices,
+		MemoryManager* memoryManagerInstance);
+	// constructs tree over triangles when empty, refits it when vertices moved
+	bool Update();
+
+	void Destroy(MemoryManager* memoryManagerInstance);
+
+	void Hit(const Ray& ray, HitResult& hitResult) const;
+	bool Collide(const Ray& ray, 
+		real from = EPSILON, real to = _INFINITY, const ObjectId* objectIdToSkip = null) const;
+	// traces BIH_PACKET_SIZE rays at once, rays with different direction signs are traced one by one
+	void HitPacket(const Ray* rays, HitResult* hitResults) const;
+	// traverse wide tree, all children of node are tested at once and hit ones are visited from the nearest
+	void HitWide(const Ray& ray, HitResult& hitResult) const;
+	bool CollideWide(const Ray& ray,
+		real from = EPSILON, real to = _INFINITY, const ObjectId* objectIdToSkip = null) const;
+
+	// constructed tree stored in scene cache, reading fails when cached tree does not fit current objects
+	uint GetCacheSize() const;
+	void WriteCache(ui8* memory) const;
+	bool ReadCache(const ui8* memory, uint size);
+
+	inline const uint GetCurrentDepth() const { return currentDepth; }
+	inline const uint GetCurrentNodeCount() const { return currentNumOfLeaves + currentNumOfNodes; }
+
+private:
+
+	void ShowStats();
+
+	void InitializeTree(MemoryManager* memoryManagerInstance, uint maxBuildTasks);
+	void Clear();
+	bool Construct(array_of<std::thread>& threads);
+	// keeps topology of tree and recomputes planes from current object bounds
+	void Refit();
+	void RefitNode(uint32 nodeId, AACell& bounds);
+
+	// improves topology of constructed tree, treelet of each node is restructured after treelets of its
+	// descendants, independent subtrees are processed on threads
+	void Restructure(array_of<std::thread>& threads);
+	void UpdateSubtreeInfo(uint32 nodeId, ui32 depth);
+	// height and cost of node from its children
+	void UpdateSubtreeCost(uint32 nodeId);
+	// subtrees at skipDepth were already processed by tasks (0 = whole subtree is processed),
+	// treeletCount is increased by number of changed treelets
+	void RestructureNode(uint32 nodeId, ui32 skipDepth, uint* treeletCount);
+	// returns false if topology of treelet was not changed
+	bool RestructureTreelet(uint32 nodeId);
+	// rewrites node to split subset of treelet leaves by its optimal partition, internal nodes of treelet
+	// are reused in depth-first order
+	void SetTreeletNode(uint32 nodeId, ui32 subset, ui32 depth, const BIHTreelet& treelet, uint& nextInternalNode);
+
+	void UpdateRootCell();
+	bool GetObjectInfoById(const ObjectId& objectId, AACell& objectCell, v3f& objectPosition) const;
+
+	// clips ray interval by root cell, returns false if ray misses it
+	bool ClipRay(const Ray& ray, real& tmin, real& tmax) const;
+	// moves current to next child node and pushes far child to stack if both are hit, returns false if none is hit
+	bool TraverseNode(const Ray& ray, const BIHCompactNode& node, BIHTraversalItem& current,
+		BIHTraversalItem* stack, uint& stackSize) const;
+	// the same for all rays of packet, node is visited if any of rays hits it
+	bool TraversePacketNode(const BIHRayPacket& packet, const BIHCompactNode& node, BIHPacketTraversalItem& current,
+		BIHPacketTraversalItem* stack, uint& stackSize) const;
+
+	// copies geometry of objects to primitives, has to be called when objects moved
+	void UpdatePrimitives();
+
+	// converts constructed tree to compact nodes used for traversal
+	void UpdateCompactNodes();
+	void CompactNode(uint32 nodeId, uint32 compactNodeId, uint32& nextCompactNodeId);
+
+	// collapses tree to wide nodes when wide tree is used, called with compact nodes
+	void UpdateWideNodes();
+	// fills wide node with node and opens its descendants (one with the largest surface area first) until
+	// wide node is full, cell is bounds of node
+	void CollapseNode(uint32 nodeId, const AACell& cell, uint32 wideNodeId, uint32& nextWideNodeId);
+	// moves current to the nearest child hit in ray interval and pushes the other hit ones to stack (the farthest
+	// first), returns false if none is hit
+	bool TraverseWideNode(const BIHWideRay& ray, const BIHWideNode& node, real tmin, real tmax,
+		BIHWideTraversalItem& current, BIHWideTraversalItem* stack, uint& stackSize) const;
+
+	void HitLeaf(const Ray& ray, uint firstObjectId, uint objectCount, HitResult& hitResult) const;
+	bool CollideLeaf(const Ray& ray, uint firstObjectId, uint objectCount,
+		real from, real to, const ObjectId* objectIdToSkip) const;
+
+	void CreateNode(BIHBuildTask& task, uint32 nodeId, uint firstObjectId, uint objectCount, const AACell& cell,
+		uint depth = 0);
+	void CreateChildNode(BIHBuildTask& task, uint32 nodeId, uint firstObjectId, uint objectCount, const AACell& cell,
+		uint depth);
+	void ProcessTask(BIHBuildTask* task);
+	// copies top of the tree and subtrees of tasks to final node list in the same order as serial construction
+	uint32 StitchNode(uint32 topNodeId);
+
+	// sorts objects by Morton codes of their centroids and stores their bounds to referenceCells,
+	// steps of parallel radix sort are run on threads for contiguous parts of objects
+	void SortMortonCodes(array_of<std::thread>& threads, uint firstObjectId, uint objectCount);
+	void RunMortonTasks(array_of<std::thread>& threads, void (BIH::*step)(BIHMortonTask*, uint), uint pass);
+	void ComputeCentroidCell(BIHMortonTask* task, uint pass);
+	void ComputeMortonCodes(BIHMortonTask* task, uint pass);
+	void CountMortonDigits(BIHMortonTask* task, uint pass);
+	void ScatterMortonKeys(BIHMortonTask* task, uint pass);
+	void GatherMortonObjects(BIHMortonTask* task, uint pass);
+	// sorted objects are split by the highest bit which differs in their codes, node axis is axis of the bit,
+	// returns number of objects on left side
+	uint FindMortonSplit(uint firstObjectId, uint objectCount, uint8& axis) const;
+
+	// finds cheapest split plane using binned SAH, returns false if leaf is cheaper than any split
+	// spatial split is considered too when budget of references allows it
+	bool FindSahSplit(uint firstObjectId, uint objectCount, uint8& axis, real& splitPlane, bool& spatialSplit) const;
+	// bins clipped references by their position instead of centroids, updates bestCost if cheaper split is found
+	bool FindSpatialSplit(uint firstObjectId, uint objectCount, const AACell& nodeCell, real& bestCost,
+		uint8& axis, real& splitPlane) const;
+	// returns SAH cost of subtree (not normalized by root surface area)
+	real GetSahCost(const BIHNode& node, const AACell& nodeCell) const;
+
+	// sorts all unknown objects to left and returns number of these objects
+	uint PreSortObjects();
+	// sort objects by splitPlane to left/right and returns number of objects on left side
+	uint SortObjects(uint firstObjectId, uint objectCount, real splitPlane, uint8 axis);
+	// left child keeps objects in place with crossing ones clipped, right child gets copy of crossing
+	// and right objects at the end of references
+	void SplitReferences(uint firstObjectId, uint objectCount, real splitPlane, uint8 axis,
+		uint& leftObjectCount, uint& rightFirstObjectId, uint& rightObjectCount);
+	void SwapReferences(uint firstId, uint secondId);
+	// copies references of leaves to leaf order and drops unused ones
+	void CompactReferences();
+
+	// world bounds of object referenced by leafObjectIds, clipped by spatial splits during construction
+	bool GetReferenceCell(uint referenceId, AACell& referenceCell) const;
+
+private:
+
+	// statistics
+	uint64 numOfNodesUsed, numOfLeavesUsed;
+	uint64 numOfObjectsUsed;
+	uint64 numOfTreesConstructed;
+	uint64 numOfTreesRefitted;
+	uint64 numOfTreesLoaded;
+	uint64 depthSum;
+	uint64 totalTasksUsed;
+	uint64 numOfCompactNodesUsed;
+	uint64 numOfReferencesUsed;
+	uint64 numOfTreeletPasses;
+	uint64 numOfTreeletsRestructured;
+	uint64 numOfWideTreesCollapsed;
+	uint64 numOfWideNodesUsed;
+
+	uint currentNumOfNodes, currentNumOfLeaves, currentNumOfObjects;
+	ui64 currentObjectsVersion; // objects->version of constructed tree
+	uint currentDepth, currentMaxDepth, currentMinDepth;
+
+	real currentSahCost, sahCostSum;
+	real constructedSahCost; // cost of last constructed tree, refitted tree is compared to it
+
+	// properties
+	uint maxObjectsPerLeaf;
+	uint maxDepth;
+	uint sahBinCount; // 0 = split in the middle of longest axis
+	b32 mortonSplit; // linear construction, SAH and spatial splits are not used
+	real spatialSplitBudget; // 0 = objects are not duplicated
+	
+	// main tree properties
+	AACell rootCell;
+
+	Objects* objects;
+	list_of<ObjectId>* objectIds; // objects->everything or triangleIds
+
+	// bottom level tree (objects is null)
+	array_of<Triangle> triangles;
+	array_of<v3f> vertices;
+	list_of<ObjectId> triangleIds;
+
+	// objectIds or references, leaves point to it
+	list_of<ObjectId>* leafObjectIds;
+	// copy of objectIds with duplicated objects, used by spatial splits and cached trees
+	list_of<ObjectId> references;
+	list_of<AACell> referenceCells; // only during construction
+	uint maxReferenceCount; // 0 = no spatial splits
+
+	list_of<BIHNode> nodes;
+
+	// restructuring passes done since tree was constructed
+	uint treeletPassCount;
+	array_of<BIHSubtreeInfo> subtreeInfos;
+
+	// objects geometry in the same order as leafObjectIds
+	array_of<BIHPrimitive> primitives;
+
+	// traversal nodes, aligned to cache line
+	array_of<BIHCompactNode> compactNodes;
+	array_of<ui8> compactNodesMemory;
+
+	// wide tree, aligned to cache line
+	b32 wideTree;
+	array_of<BIHWideNode> wideNodes;
+	array_of<ui8> wideNodesMemory;
+
+	MemoryManager* memoryManagerInstance;
+
+	// parallel construction
+	list_of<BIHNode> topNodes;
+	array_of<list_of<BIHNode>> taskNodes;
+	BIHBuildTask tasks[BIH_MAX_BUILD_TASKS];
+	uint taskCount, taskDepth;
+
+	// linear construction, key is Morton code (upper 32 bits) with object id (lower 32 bits), each radix sort
+	// pass moves keys from one array to the other
+	array_of<ui64> mortonKeys[2];
+	array_of<ui32> mortonDigitCounts;
+	// objects and their bounds in sorted order, copied back to objectIds and referenceCells
+	array_of<ObjectId> sortedObjectIds;
+	array_of<AACell> sortedObjectCells;
+	BIHMortonTask mortonTasks[BIH_MAX_BUILD_TASKS];
+	uint mortonTaskCount;
+	AACell centroidCell;
+};
+
+#endif __bounding_interval_hierarchy_h
@@ -0,0 +1,19 @@
+#ifndef __hash_h
+#define __hash_h
+
+#include "TypeDefs.h"
+
+#define HASH_SEED	14695981039346656037ull
+
+
+// FNV-1a
+inline ui64 HashData(ui64 hash, const void* data, uint size)
+{
+	const ui8* bytes = (const ui8*)data;
+	for (uint i = 0; i < size; ++i)
+		hash = (hash ^ bytes[i]) * 1099511628211ull;
+
+	return hash;
+}
+
+#endif __hash_h
@@ -1,46 +1,49 @@
-#ifndef __hit_result_h
-#define __hit_result_h
-
-#include "Object.h"
-#include "TypeDefs.h"
-#include "Vectors.h"
-
-
-struct HitResult
-{
-	v3f point;
-	v3f normal;
-
-	ObjectId objectId;
-	ObjectId innerObjectId;
-
-	real distance;
-	int materialIndex;
-
-	// debugging
-	uint nodeTestCount;
-	uint intersectionCount;
-
-	bool fromInside;
-
-	__device__ HitResult()
-	{
-		Clear();
-	}
-
-	__device__ inline void Clear()
-	{
-		point.Set(0, 0, 0);
-		normal.Set(0, 0, 0);
-		objectId.Clear();
-		innerObjectId.Clear();
-		distance = _INFINITY;
-		materialIndex = 0;
-		fromInside = false;
-
-		nodeTestCount = 0;
-		intersectionCount = 0;
-	}
-};
-
-#endif __hit_result_h
+#ifndef __hit_result_h
+#define __hit_result_h
+
+#include "Object.h"
+#include "TypeDefs.h"
+#include "Vectors.h"
+
+
+struct HitResult
+{
+	v3f point;
+	v3f normal;
+	// color of voxel, prefiltered when traversal stopped above voxels
+	v3f color;
+
+	ObjectId objectId;
+	ObjectId innerObjectId;
+
+	real distance;
+	int materialIndex;
+
+	// debugging
+	uint nodeTestCount;
+	uint intersectionCount;
+
+	bool fromInside;
+
+	__device__ HitResult()
+	{
+		Clear();
+	}
+
+	__device__ inline void Clear()
+	{
+		point.Set(0, 0, 0);
+		normal.Set(0, 0, 0);
+		color.Set(1, 1, 1);
+		objectId.Clear();
+		innerObjectId.Clear();
+		distance = _INFINITY;
+		materialIndex = 0;
+		fromInside = false;
+
+		nodeTestCount = 0;
+		intersectionCount = 0;
+	}
+};
+
+#endif __hit_result_h
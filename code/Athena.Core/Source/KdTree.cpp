@@ -0,0 +1,731 @@
+#include <algorithm>
+#include "Athena.h"
+#include "Convert.h"
+#include "HitResult.h"
+#include "KdTree.h"
+#include "Log.h"
+#include "MemoryManager.h"
+#include "Objects.h"
+#include "Ray.h"
+#include "Rendering.h"
+#include "StringHelpers.h"
+#include "Timer.h"
+#include "Timers.h"
+
+
+// positive floats have sign bit set, negative ones are inverted, so keys compare like floats
+static ui32 GetPositionKey(f32 position)
+{
+	if (position == 0)
+		position = 0;
+
+	ui32 bits;
+	memcpy(&bits, &position, sizeof(bits));
+	return bits & 0x80000000 ? ~bits : bits | 0x80000000;
+}
+
+static f32 GetPosition(ui32 positionKey)
+{
+	const ui32 bits = positionKey & 0x80000000 ? positionKey & 0x7fffffff : ~positionKey;
+
+	f32 position;
+	memcpy(&position, &bits, sizeof(position));
+	return position;
+}
+
+struct KdTraversalItem
+{
+	ui32 nodeId;
+	real tmin, tmax;
+};
+
+
+void KdTree::Initialize(Objects* objects, MemoryManager* memoryManagerInstance)
+{
+	numOfTreesConstructed = numOfNodesUsed = numOfReferencesUsed = 0;
+	currentObjectsVersion = 0;
+	currentMaxDepth = 0;
+
+	rootCell.SetEmpty();
+
+	nodes.Initialize(memoryManagerInstance, "KdNode");
+	references.Initialize(memoryManagerInstance, "ObjectId");
+
+	objectIds = array_of<ObjectId>();
+	objectCells = array_of<AACell>();
+	objectSides = array_of<ui8>();
+	eventList.Initialize(memoryManagerInstance, "KdEvent");
+	straddlingObjects.Initialize(memoryManagerInstance, "ui32");
+
+	this->objects = objects;
+	this->memoryManagerInstance = memoryManagerInstance;
+}
+
+void KdTree::Destroy(MemoryManager* memoryManagerInstance)
+{
+	if (this->memoryManagerInstance)
+	{
+		ShowStats();
+
+		nodes.Destroy();
+		references.Destroy();
+
+		_MEM_FREE_ARRAY(memoryManagerInstance, ObjectId, &objectIds);
+		_MEM_FREE_ARRAY(memoryManagerInstance, AACell, &objectCells);
+		_MEM_FREE_ARRAY(memoryManagerInstance, ui8, &objectSides);
+		eventList.Destroy();
+		straddlingObjects.Destroy();
+
+		objects = null;
+		this->memoryManagerInstance = null;
+
+		LOG_DEBUG("KdTree::Destroy");
+	}
+}
+
+bool KdTree::Update(bool sceneChanged, AthenaStorage* athenaStorage)
+{
+	TIMED_BLOCK(&athenaStorage->timers[TimerId::KdTreeConstruction]);
+
+	if (athenaStorage->renderingParameters.tracingMethod != TracingMethod::KdTree)
+	{
+		Clear();
+		return false;
+	}
+
+	// existing tree is reused until objects move or are added
+	if (!sceneChanged && nodes.currentCount && objects->version == currentObjectsVersion)
+		return true;
+
+	return Construct();
+}
+
+void KdTree::Clear()
+{
+	nodes.currentCount = 0;
+	references.currentCount = 0;
+	currentObjectsVersion = 0;
+}
+
+bool KdTree::Construct()
+{
+	Clear();
+
+	const uint objectCount = objects->everything.currentCount;
+	if (!objectCount)
+		return false;
+
+	// buffers are kept for next constructions
+	if (objectIds.count < objectCount)
+	{
+		_MEM_FREE_ARRAY(memoryManagerInstance, ObjectId, &objectIds);
+		objectIds = _MEM_ALLOC_ARRAY(memoryManagerInstance, ObjectId, objectCount);
+		_MEM_FREE_ARRAY(memoryManagerInstance, AACell, &objectCells);
+		objectCells = _MEM_ALLOC_ARRAY(memoryManagerInstance, AACell, objectCount);
+		_MEM_FREE_ARRAY(memoryManagerInstance, ui8, &objectSides);
+		objectSides = _MEM_ALLOC_ARRAY(memoryManagerInstance, ui8, objectCount);
+	}
+
+	// planes and point lights are not part of tree
+	rootCell.SetEmpty();
+	uint boundedObjectCount = 0;
+	for (uint i = 0; i < objectCount; ++i)
+	{
+		if (GetObjectCell(objects->everything[i], objectCells[boundedObjectCount]))
+		{
+			objectIds[boundedObjectCount] = objects->everything[i];
+			rootCell.Add(objectCells[boundedObjectCount]);
+			boundedObjectCount++;
+		}
+	}
+
+	if (!boundedObjectCount)
+		return false;
+
+	ASSERT(boundedObjectCount < KD_MAX_OBJECTS);
+
+	for (ui32 axis = 0; axis < 3; ++axis)
+	{
+		rootCell.minCorner[axis] = ToFloatDown(rootCell.minCorner[axis]);
+		rootCell.maxCorner[axis] = ToFloatUp(rootCell.maxCorner[axis]);
+	}
+
+	currentMaxDepth = MIN2((ui32)(8 + 1.3 * log2((real)boundedObjectCount)), KD_MAX_DEPTH);
+
+	// events are sorted once, nodes only split sorted lists of their parents
+	eventList.currentCount = 0;
+	uint eventOffsets[3], eventCounts[3];
+	for (ui32 axis = 0; axis < 3; ++axis)
+	{
+		eventOffsets[axis] = eventList.currentCount;
+		for (ui32 i = 0; i < boundedObjectCount; ++i)
+			AddEvents(objectCells[i], i, axis);
+		eventCounts[axis] = eventList.currentCount - eventOffsets[axis];
+
+		std::sort(eventList.array.ptr + eventOffsets[axis],
+			eventList.array.ptr + eventOffsets[axis] + eventCounts[axis]);
+	}
+
+	ConstructNode(rootCell, eventOffsets, eventCounts, boundedObjectCount, 0);
+
+	currentObjectsVersion = objects->version;
+
+	numOfTreesConstructed++;
+	numOfNodesUsed += nodes.currentCount;
+	numOfReferencesUsed += references.currentCount;
+
+	return true;
+}
+
+void KdTree::ConstructNode(const AACell& cell, const uint* eventOffsets, const uint* eventCounts, uint objectCount,
+	ui32 depth)
+{
+	const uint nodeId = nodes.Add();
+
+	ui32 axis;
+	f32 split;
+	bool planarLeft;
+	if (depth >= currentMaxDepth || !FindSplit(cell, eventOffsets, eventCounts, objectCount, axis, split, planarLeft))
+	{
+		CreateLeaf(nodeId, eventOffsets[0], eventCounts[0]);
+		return;
+	}
+
+	AACell leftCell(cell), rightCell(cell);
+	leftCell.maxCorner[axis] = split;
+	rightCell.minCorner[axis] = split;
+
+	// events of children are removed when both subtrees are done
+	const uint eventTop = eventList.currentCount;
+
+	uint childEventOffsets[6], childEventCounts[6], childObjectCounts[2];
+	SplitEvents(leftCell, rightCell, eventOffsets, eventCounts, axis, split, planarLeft,
+		childEventOffsets, childEventCounts, childObjectCounts);
+
+	ConstructNode(leftCell, childEventOffsets, childEventCounts, childObjectCounts[0], depth + 1);
+
+	KdNode& node = nodes[nodeId];
+	node.split = split;
+	node.flags = (ui32)nodes.currentCount << 2 | axis;
+
+	ConstructNode(rightCell, childEventOffsets + 3, childEventCounts + 3, childObjectCounts[1], depth + 1);
+
+	eventList.currentCount = eventTop;
+}
+
+bool KdTree::FindSplit(const AACell& cell, const uint* eventOffsets, const uint* eventCounts, uint objectCount,
+	ui32& axis, f32& split, bool& planarLeft) const
+{
+	const v3f size = cell.maxCorner - cell.minCorner;
+	const real surfaceArea = 2 * (size.Get(0) * size.Get(1) + size.Get(1) * size.Get(2) + size.Get(2) * size.Get(0));
+	if (surfaceArea <= 0)
+		return false;
+
+	const real invSurfaceArea = 1 / surfaceArea;
+	real bestCost = KD_INTERSECTION_COST * objectCount;
+	bool found = false;
+
+	for (ui32 k = 0; k < 3; ++k)
+	{
+		// surface area of child is area of split plane and its sides along axis
+		const real a = size.Get((k + 1) % 3);
+		const real b = size.Get((k + 2) % 3);
+		const real planeArea = a * b;
+		const real sideLength = a + b;
+
+		const KdEvent* events = eventList.array.ptr + eventOffsets[k];
+		const uint eventCount = eventCounts[k];
+
+		uint leftCount = 0, rightCount = objectCount;
+		for (uint i = 0; i < eventCount;)
+		{
+			const ui32 positionKey = events[i].GetPositionKey();
+
+			uint endCount = 0, planarCount = 0, startCount = 0;
+			for (; i < eventCount && events[i].GetPositionKey() == positionKey &&
+				events[i].GetType() == KD_EVENT_END; ++i)
+				endCount++;
+			for (; i < eventCount && events[i].GetPositionKey() == positionKey &&
+				events[i].GetType() == KD_EVENT_PLANAR; ++i)
+				planarCount++;
+			for (; i < eventCount && events[i].GetPositionKey() == positionKey &&
+				events[i].GetType() == KD_EVENT_START; ++i)
+				startCount++;
+
+			// objects ending or lying at position are not right of it
+			rightCount -= planarCount + endCount;
+
+			// splits on cell bounds do not divide anything
+			const real position = GetPosition(positionKey);
+			if (position > cell.minCorner.Get(k) && position < cell.maxCorner.Get(k))
+			{
+				const real leftArea = 2 * (planeArea + sideLength * (position - cell.minCorner.Get(k)));
+				const real rightArea = 2 * (planeArea + sideLength * (cell.maxCorner.Get(k) - position));
+				const real pLeft = leftArea * invSurfaceArea;
+				const real pRight = rightArea * invSurfaceArea;
+
+				// objects lying in split plane are put to the cheaper side
+				for (ui32 side = 0; side < 2; ++side)
+				{
+					const uint left = leftCount + (side ? 0 : planarCount);
+					const uint right = rightCount + (side ? planarCount : 0);
+
+					real cost = KD_TRAVERSAL_COST + KD_INTERSECTION_COST * (pLeft * left + pRight * right);
+					if (!left || !right)
+						cost *= KD_EMPTY_BONUS;
+
+					if (cost < bestCost)
+					{
+						bestCost = cost;
+						axis = k;
+						split = GetPosition(positionKey);
+						planarLeft = side == 0;
+						found = true;
+					}
+				}
+			}
+
+			leftCount += planarCount + startCount;
+		}
+	}
+
+	return found;
+}
+
+void KdTree::SplitEvents(const AACell& leftCell, const AACell& rightCell, const uint* eventOffsets,
+	const uint* eventCounts, ui32 axis, f32 split, bool planarLeft, uint* childEventOffsets,
+	uint* childEventCounts, uint* childObjectCounts)
+{
+	// classify objects by their events on split axis, objects without any of these cases straddle split
+	const uint splitOffset = eventOffsets[axis];
+	for (uint i = splitOffset; i < splitOffset + eventCounts[axis]; ++i)
+		objectSides[eventList[i].GetObjectIndex()] = KD_SIDE_BOTH;
+
+	childObjectCounts[0] = childObjectCounts[1] = 0;
+	for (uint i = splitOffset; i < splitOffset + eventCounts[axis]; ++i)
+	{
+		const KdEvent& event = eventList[i];
+		const f32 position = GetPosition(event.GetPositionKey());
+		ui8& side = objectSides[event.GetObjectIndex()];
+
+		switch (event.GetType())
+		{
+			case KD_EVENT_END:
+				if (position <= split)
+					side = KD_SIDE_LEFT;
+				break;
+
+			case KD_EVENT_START:
+				if (position >= split)
+					side = KD_SIDE_RIGHT;
+				break;
+
+			case KD_EVENT_PLANAR:
+				if (position < split || (position == split && planarLeft))
+					side = KD_SIDE_LEFT;
+				else
+					side = KD_SIDE_RIGHT;
+				break;
+		}
+	}
+
+	// each object has one start or planar event
+	straddlingObjects.currentCount = 0;
+	for (uint i = splitOffset; i < splitOffset + eventCounts[axis]; ++i)
+	{
+		const KdEvent& event = eventList[i];
+		if (event.GetType() == KD_EVENT_END)
+			continue;
+
+		ui32 objectIndex = event.GetObjectIndex();
+		switch (objectSides[objectIndex])
+		{
+			case KD_SIDE_LEFT: childObjectCounts[0]++; break;
+			case KD_SIDE_RIGHT: childObjectCounts[1]++; break;
+
+			default:
+				childObjectCounts[0]++;
+				childObjectCounts[1]++;
+				straddlingObjects.Add(objectIndex);
+		}
+	}
+
+	// events of one side keep their order, new events of straddling objects are sorted and merged into them
+	for (ui32 childId = 0; childId < 2; ++childId)
+	{
+		const AACell& childCell = childId ? rightCell : leftCell;
+		const ui8 childSide = childId ? KD_SIDE_RIGHT : KD_SIDE_LEFT;
+
+		for (ui32 k = 0; k < 3; ++k)
+		{
+			const uint firstEventId = eventList.currentCount;
+			for (uint i = eventOffsets[k]; i < eventOffsets[k] + eventCounts[k]; ++i)
+			{
+				if (objectSides[eventList[i].GetObjectIndex()] == childSide)
+				{
+					KdEvent event = eventList[i];
+					eventList.Add(event);
+				}
+			}
+
+			const uint firstClippedEventId = eventList.currentCount;
+			for (uint i = 0; i < straddlingObjects.currentCount; ++i)
+			{
+				const ui32 objectIndex = straddlingObjects[i];
+				AACell clippedCell(objectCells[objectIndex]);
+				clippedCell.minCorner[k] = MAX2(clippedCell.minCorner[k], childCell.minCorner.Get(k));
+				clippedCell.maxCorner[k] = MIN2(clippedCell.maxCorner[k], childCell.maxCorner.Get(k));
+
+				AddEvents(clippedCell, objectIndex, k);
+			}
+
+			KdEvent* events = eventList.array.ptr;
+			std::sort(events + firstClippedEventId, events + eventList.currentCount);
+			std::inplace_merge(events + firstEventId, events + firstClippedEventId, events + eventList.currentCount);
+
+			childEventOffsets[childId * 3 + k] = firstEventId;
+			childEventCounts[childId * 3 + k] = eventList.currentCount - firstEventId;
+		}
+	}
+}
+
+void KdTree::AddEvents(const AACell& cell, ui32 objectIndex, ui32 axis)
+{
+	const f32 minPosition = ToFloatDown(cell.minCorner.Get(axis));
+	const f32 maxPosition = ToFloatUp(cell.maxCorner.Get(axis));
+
+	KdEvent event;
+	if (minPosition == maxPosition)
+	{
+		event.key = (ui64)GetPositionKey(minPosition) << 32 | (ui64)KD_EVENT_PLANAR << 30 | objectIndex;
+		eventList.Add(event);
+	}
+	else
+	{
+		event.key = (ui64)GetPositionKey(minPosition) << 32 | (ui64)KD_EVENT_START << 30 | objectIndex;
+		eventList.Add(event);
+		event.key = (ui64)GetPositionKey(maxPosition) << 32 | (ui64)KD_EVENT_END << 30 | objectIndex;
+		eventList.Add(event);
+	}
+}
+
+void KdTree::CreateLeaf(uint nodeId, uint eventOffset, uint eventCount)
+{
+	KdNode& node = nodes[nodeId];
+	node.firstReference = (ui32)references.currentCount;
+
+	// each object has one start or planar event
+	for (uint i = eventOffset; i < eventOffset + eventCount; ++i)
+	{
+		if (eventList[i].GetType() != KD_EVENT_END)
+			references.Add(objectIds[eventList[i].GetObjectIndex()]);
+	}
+
+	node.flags = (ui32)(references.currentCount - node.firstReference) << 2 | KD_LEAF_FLAG;
+}
+
+bool KdTree::GetObjectCell(const ObjectId& objectId, AACell& objectCell) const
+{
+	switch (objectId.Type())
+	{
+		case ObjectType::Sphere:
+			GetWorldCell(objects->spheres[objectId.index], objectCell);
+			return true;
+
+		case ObjectType::Box:
+			GetWorldCell(objects->boxes[objectId.index], objectCell);
+			return true;
+
+		case ObjectType::Mesh:
+			GetWorldCell(objects->meshes[objectId.index], objectCell);
+			return true;
+
+		case ObjectType::MeshInstance:
+			GetWorldCell(objects->meshInstances[objectId.index], objectCell);
+			return true;
+
+		case ObjectType::SphereLightSource:
+			GetWorldCell(objects->sphereLights[objectId.index], objectCell);
+			return true;
+
+		case ObjectType::BoxLightSource:
+			GetWorldCell(objects->boxLights[objectId.index], objectCell);
+			return true;
+
+		case ObjectType::Plane:
+		case ObjectType::PointLightSource:
+			break;
+	}
+
+	return false;
+}
+
+static bool ClipRay(const Ray& ray, const AACell& cell, real& tmin, real& tmax)
+{
+	// NOTE when ray is parallel with slab t can be NaN, comparisons below keep interval unchanged then
+	for (ui32 axis = 0; axis < 3; ++axis)
+	{
+		const real origin = ray.origin.Get(axis);
+		const real invDirection = ray.invDirection.Get(axis);
+
+		const real tNear = ((ray.sign.Get(axis) ? cell.maxCorner.Get(axis) : cell.minCorner.Get(axis)) -
+			origin) * invDirection;
+		const real tFar = ((ray.sign.Get(axis) ? cell.minCorner.Get(axis) : cell.maxCorner.Get(axis)) -
+			origin) * invDirection;
+
+		if (tNear > tmin)
+			tmin = tNear;
+		if (tFar < tmax)
+			tmax = tFar;
+	}
+
+	return tmin <= tmax;
+}
+
+void KdTree::Hit(const Ray& ray, HitResult& hitResult) const
+{
+	if (!nodes.currentCount)
+		return;
+
+	real tmin = EPSILON;
+	real tmax = hitResult.distance;
+	if (!ClipRay(ray, rootCell, tmin, tmax))
+		return;
+
+	KdTraversalItem stack[KD_STACK_SIZE];
+	ui32 stackSize = 0;
+	ui32 nodeId = 0;
+
+	while (true)
+	{
+		// node is skipped when hit is closer than any of its objects, nodes pushed by ray lying in split plane
+		// are not ordered by distance, so the rest of stack is checked too
+		if (hitResult.distance < tmin)
+		{
+			if (!stackSize)
+				return;
+
+			const KdTraversalItem& item = stack[--stackSize];
+			nodeId = item.nodeId;
+			tmin = item.tmin;
+			tmax = item.tmax;
+			continue;
+		}
+
+		hitResult.nodeTestCount++;
+
+		const KdNode& node = nodes[nodeId];
+		if (!node.IsLeaf())
+		{
+			const ui32 axis = node.GetAxis();
+			const real split = node.split;
+			const real origin = ray.origin.Get(axis);
+			const real direction = ray.direction.Get(axis);
+
+			// children are ordered by side of ray origin
+			const bool belowFirst = origin < split || (origin == split && direction <= 0);
+			const ui32 firstChild = belowFirst ? nodeId + 1 : node.GetAboveChild();
+			const ui32 secondChild = belowFirst ? node.GetAboveChild() : nodeId + 1;
+
+			// ray lying in split plane touches both children
+			if (direction == 0)
+			{
+				if (origin == split)
+					stack[stackSize++] = { secondChild, tmin, tmax };
+
+				nodeId = firstChild;
+				continue;
+			}
+
+			const real tSplit = (split - origin) * ray.invDirection.Get(axis);
+			if (tSplit > tmax || tSplit <= 0)
+				nodeId = firstChild;
+			else if (tSplit < tmin)
+				nodeId = secondChild;
+			else
+			{
+				stack[stackSize++] = { secondChild, tSplit, tmax };
+				nodeId = firstChild;
+				tmax = tSplit;
+			}
+
+			continue;
+		}
+
+		HitLeaf(ray, node, hitResult);
+
+		if (!stackSize)
+			return;
+
+		const KdTraversalItem& item = stack[--stackSize];
+		nodeId = item.nodeId;
+		tmin = item.tmin;
+		tmax = item.tmax;
+	}
+}
+
+void KdTree::HitLeaf(const Ray& ray, const KdNode& node, HitResult& hitResult) const
+{
+	ObjectId innerObjectId;
+	const ui32 referenceCount = node.GetReferenceCount();
+	for (ui32 i = node.firstReference; i < node.firstReference + referenceCount; ++i)
+	{
+		real t;
+		const ObjectId& objectId = references[i];
+		switch (objectId.Type())
+		{
+			case ObjectType::Sphere: t = objects->spheres[objectId.index].Hit(ray); break;
+			case ObjectType::Box: t = objects->boxes[objectId.index].Hit(ray); break;
+			case ObjectType::SphereLightSource: t = objects->sphereLights[objectId.index].Hit(ray); break;
+			case ObjectType::BoxLightSource: t = objects->boxLights[objectId.index].Hit(ray); break;
+			case ObjectType::Mesh: t = objects->meshes[objectId.index].Hit(ray, innerObjectId); break;
+			case ObjectType::MeshInstance:
+			{
+				const MeshInstance& instance = objects->meshInstances[objectId.index];
+				t = instance.Hit(ray, objects->sharedMeshes[instance.meshIndex], innerObjectId);
+				break;
+			}
+
+			default:
+				t = _INFINITY;
+		}
+
+		if (t > EPSILON && t < hitResult.distance)
+		{
+			hitResult.distance = t;
+			hitResult.objectId = objectId;
+			if (objectId.Type() == ObjectType::Mesh || objectId.Type() == ObjectType::MeshInstance)
+				hitResult.innerObjectId = innerObjectId;
+		}
+	}
+
+	hitResult.intersectionCount += referenceCount;
+}
+
+bool KdTree::Collide(const Ray& ray, real from, real to, const ObjectId* objectIdToSkip) const
+{
+	if (!nodes.currentCount)
+		return false;
+
+	real tmin = from;
+	real tmax = to;
+	if (!ClipRay(ray, rootCell, tmin, tmax))
+		return false;
+
+	KdTraversalItem stack[KD_STACK_SIZE];
+	ui32 stackSize = 0;
+	ui32 nodeId = 0;
+
+	while (true)
+	{
+		const KdNode& node = nodes[nodeId];
+		if (!node.IsLeaf())
+		{
+			const ui32 axis = node.GetAxis();
+			const real split = node.split;
+			const real origin = ray.origin.Get(axis);
+			const real direction = ray.direction.Get(axis);
+
+			const bool belowFirst = origin < split || (origin == split && direction <= 0);
+			const ui32 firstChild = belowFirst ? nodeId + 1 : node.GetAboveChild();
+			const ui32 secondChild = belowFirst ? node.GetAboveChild() : nodeId + 1;
+
+			if (direction == 0)
+			{
+				if (origin == split)
+					stack[stackSize++] = { secondChild, tmin, tmax };
+
+				nodeId = firstChild;
+				continue;
+			}
+
+			const real tSplit = (split - origin) * ray.invDirection.Get(axis);
+			if (tSplit > tmax || tSplit <= 0)
+				nodeId = firstChild;
+			else if (tSplit < tmin)
+				nodeId = secondChild;
+			else
+			{
+				stack[stackSize++] = { secondChild, tSplit, tmax };
+				nodeId = firstChild;
+				tmax = tSplit;
+			}
+
+			continue;
+		}
+
+		if (CollideLeaf(ray, node, from, to, objectIdToSkip))
+			return true;
+
+		if (!stackSize)
+			return false;
+
+		const KdTraversalItem& item = stack[--stackSize];
+		nodeId = item.nodeId;
+		tmin = item.tmin;
+		tmax = item.tmax;
+	}
+}
+
+bool KdTree::CollideLeaf(const Ray& ray, const KdNode& node, real from, real to,
+	const ObjectId* objectIdToSkip) const
+{
+	bool collision = false;
+	for (ui32 i = node.firstReference; i < node.firstReference + node.GetReferenceCount(); ++i)
+	{
+		const ObjectId& objectId = references[i];
+		if ((objectId.Type() != ObjectType::Mesh && objectId.Type() != ObjectType::MeshInstance) &&
+			(objectId.IsLight() || (objectIdToSkip != null && objectId._value == objectIdToSkip->_value)))
+			continue;
+
+		switch (objectId.Type())
+		{
+			case ObjectType::Sphere:
+				collision = objects->spheres[objectId.index].Collide(ray, from, to);
+				break;
+			case ObjectType::Box:
+				collision = objects->boxes[objectId.index].Collide(ray, from, to);
+				break;
+			case ObjectType::Mesh:
+				collision = objects->meshes[objectId.index].Collide(ray, from, to);
+				break;
+			case ObjectType::MeshInstance:
+			{
+				const MeshInstance& instance = objects->meshInstances[objectId.index];
+				collision = instance.Collide(ray, objects->sharedMeshes[instance.meshIndex], from, to);
+				break;
+			}
+
+			default:
+				break;
+		}
+
+		if (collision)
+			return true;
+	}
+
+	return false;
+}
+
+void KdTree::ShowStats()
+{
+	using namespace Common::Strings;
+
+	char tmpBuffer[256] = {};
+
+	if (numOfTreesConstructed)
+	{
+		LOG_TL(LogLevel::Info, "Kd-tree statistics:");
+		LOG_TL(LogLevel::Info, "\ttrees constructed:\t%I64d", numOfTreesConstructed);
+		LOG_TL(LogLevel::Info, "\tmax depth last:\t\t%d", currentMaxDepth);
+		LOG_TL(LogLevel::Info, "\tnodes used:\t\t%I64d (avg %I64d/tree)", numOfNodesUsed,
+			numOfNodesUsed / numOfTreesConstructed);
+		LOG_TL(LogLevel::Info, "\treferences used:\t%I64d (avg %I64d/tree)", numOfReferencesUsed,
+			numOfReferencesUsed / numOfTreesConstructed);
+		LOG_TL(LogLevel::Info, "\tmemory used:\t\tavg %s/tree",
+			GetMemSizeString(tmpBuffer, (numOfNodesUsed * sizeof(KdNode) + numOfReferencesUsed * sizeof(ObjectId)) /
+			numOfTreesConstructed));
+		LOG_TL(LogLevel::Info, "\tevent buffer:\t\t%s",
+			GetMemSizeString(tmpBuffer, eventList.array.count * sizeof(KdEvent)));
+	}
+}
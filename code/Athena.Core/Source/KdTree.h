@@ -0,0 +1,160 @@
+#ifndef __kd_tree_h
+#define __kd_tree_h
+
+// SAH kd-tree with O(N log N) construction
+// On building fast kd-Trees for Ray Tracing, and on doing that in O(N log N), IEEE Symposium on Interactive
+// Ray Tracing 2006
+//
+// Ingo Wald and Vlastimil Havran
+
+#include "AACell.h"
+#include "Array.h"
+#include "List.h"
+#include "Object.h"
+#include "TypeDefs.h"
+#include "Vectors.h"
+
+// cost of split is KD_TRAVERSAL_COST + KD_INTERSECTION_COST * (pL * NL + pR * NR), node is split only when it is
+// cheaper than intersecting all its objects, splits cutting off empty space are preferred
+#define KD_TRAVERSAL_COST				(real)1
+#define KD_INTERSECTION_COST			(real)1.5
+#define KD_EMPTY_BONUS					(real).8
+// max depth of tree is also limited by 8 + 1.3 * log2(N)
+#define KD_MAX_DEPTH					40
+#define KD_STACK_SIZE					(KD_MAX_DEPTH + 1)
+
+// events of one position are sorted ends, planar, starts
+#define KD_EVENT_END					0
+#define KD_EVENT_PLANAR					1
+#define KD_EVENT_START					2
+#define KD_MAX_OBJECTS					(1 << 30)
+
+// side of split where object is classified, straddling objects are in both children
+#define KD_SIDE_BOTH					0
+#define KD_SIDE_LEFT					1
+#define KD_SIDE_RIGHT					2
+
+// lower 2 bits of flags are axis of interior node or 3 for leaf
+#define KD_LEAF_FLAG					3
+
+
+// sizeof() = 8B, below child of interior node is the next node, above child is referenced
+struct KdNode
+{
+	union
+	{
+		// interior node
+		f32 split;
+		// leaf, index of the first object in references
+		ui32 firstReference;
+	};
+	union
+	{
+		ui32 flags;
+		// interior node, upper 30 bits of flags
+		ui32 aboveChild;
+		// leaf, upper 30 bits of flags
+		ui32 referenceCount;
+	};
+
+	inline bool IsLeaf() const { return (flags & KD_LEAF_FLAG) == KD_LEAF_FLAG; }
+	inline ui32 GetAxis() const { return flags & KD_LEAF_FLAG; }
+	inline ui32 GetAboveChild() const { return aboveChild >> 2; }
+	inline ui32 GetReferenceCount() const { return referenceCount >> 2; }
+};
+
+// sizeof() = 8B, start, end or planar bound of object on one axis
+struct KdEvent
+{
+	// sorted by position (upper 32 bits, float bits flipped to compare as integer), type (2 bits)
+	// and object index (lower 30 bits)
+	ui64 key;
+
+	inline bool operator<(const KdEvent& event) const { return key < event.key; }
+
+	inline ui32 GetPositionKey() const { return (ui32)(key >> 32); }
+	inline ui32 GetType() const { return (ui32)(key >> 30) & 3; }
+	inline ui32 GetObjectIndex() const { return (ui32)key & (KD_MAX_OBJECTS - 1); }
+};
+
+DLL_EXPORT_ARRAY_OF(KdNode);
+DLL_EXPORT_LIST_OF(KdNode);
+DLL_EXPORT_ARRAY_OF(KdEvent);
+DLL_EXPORT_LIST_OF(KdEvent);
+
+
+class MemoryManager;
+struct AthenaStorage;
+struct HitResult;
+struct Objects;
+struct ObjectId;
+struct Ray;
+
+class DLL_EXPORT KdTree
+{
+public:
+
+	void Initialize(Objects* objects, MemoryManager* memoryManagerInstance);
+	void Destroy(MemoryManager* memoryManagerInstance);
+	// tree is constructed only when objects moved (sceneChanged), so it is meant for static scenes
+	bool Update(bool sceneChanged, AthenaStorage* athenaStorage);
+
+	// nodes are visited front-to-back, traversal ends when the closest hit is before the next node
+	void Hit(const Ray& ray, HitResult& hitResult) const;
+	bool Collide(const Ray& ray, real from = EPSILON, real to = _INFINITY, const ObjectId* objectIdToSkip = null) const;
+
+	inline const uint GetCurrentNodeCount() const { return nodes.currentCount; }
+
+private:
+
+	void ShowStats();
+
+	void Clear();
+	bool Construct();
+	// events of node are in eventList at eventOffsets (for each axis sorted by position), events of children are
+	// appended after them and removed when subtree is done
+	void ConstructNode(const AACell& cell, const uint* eventOffsets, const uint* eventCounts, uint objectCount,
+		ui32 depth);
+	// sweeps over sorted events of each axis, returns false when no split is cheaper than leaf
+	bool FindSplit(const AACell& cell, const uint* eventOffsets, const uint* eventCounts, uint objectCount,
+		ui32& axis, f32& split, bool& planarLeft) const;
+	// objects are left, right or both (straddling split), straddling objects get new events clipped by child cells
+	void SplitEvents(const AACell& leftCell, const AACell& rightCell, const uint* eventOffsets,
+		const uint* eventCounts, ui32 axis, f32 split, bool planarLeft, uint* childEventOffsets,
+		uint* childEventCounts, uint* childObjectCounts);
+	void AddEvents(const AACell& cell, ui32 objectIndex, ui32 axis);
+	void CreateLeaf(uint nodeId, uint eventOffset, uint eventCount);
+
+	bool GetObjectCell(const ObjectId& objectId, AACell& objectCell) const;
+
+	void HitLeaf(const Ray& ray, const KdNode& node, HitResult& hitResult) const;
+	bool CollideLeaf(const Ray& ray, const KdNode& node, real from, real to, const ObjectId* objectIdToSkip) const;
+
+private:
+
+	// statistics
+	uint64 numOfTreesConstructed;
+	uint64 numOfNodesUsed;
+	uint64 numOfReferencesUsed;
+
+	ui64 currentObjectsVersion; // objects->version of constructed tree
+	ui32 currentMaxDepth;
+
+	AACell rootCell;
+
+	Objects* objects;
+
+	list_of<KdNode> nodes;
+	list_of<ObjectId> references;
+
+	// construction buffers, objects with bounds are referenced by their index in objectIds
+	array_of<ObjectId> objectIds;
+	array_of<AACell> objectCells;
+	array_of<ui8> objectSides;
+	list_of<KdEvent> eventList;
+	list_of<ui32> straddlingObjects;
+
+	MemoryManager* memoryManagerInstance;
+};
+
+#endif __kd_tree_h
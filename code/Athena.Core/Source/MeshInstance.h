@@ -0,0 +1,89 @@
+#ifndef __mesh_instance_h
+#define __mesh_instance_h
+
+#include "AACell.h"
+#include "Matrix.h"
+#include "Mesh.h"
+#include "Object.h"
+#include "Ray.h"
+#include "TypeDefs.h"
+#include "Vectors.h"
+
+
+// placed copy of shared mesh (geometry and its tree are not duplicated)
+// NOTE transform can also scale, ray direction is not normalized in object space, so distances along ray are the
+// same in both spaces
+struct MeshInstance : Object
+{
+	AACell cell;
+	ui32 meshIndex; // index to Objects::sharedMeshes
+	ui32 materialIndex;
+
+	Matrix4x4 transform; // object -> world
+	Matrix4x4 inverseTransform; // world -> object
+
+	__device__ real Hit(const Ray& ray, const Mesh& mesh, ObjectId& triangleId) const
+	{
+		return mesh.Hit(GetObjectRay(ray), triangleId);
+	}
+
+	__device__ bool Collide(const Ray& ray, const Mesh& mesh, real from = EPSILON, real to = _INFINITY) const
+	{
+		return mesh.Collide(GetObjectRay(ray), from, to);
+	}
+
+	__device__ bool IsInside(const v3f& point, const Mesh& mesh, const ObjectId* triangleId = null) const
+	{
+		v3f objectPoint;
+		inverseTransform.Transform(point, objectPoint);
+
+		return mesh.IsInside(objectPoint - mesh.position, triangleId);
+	}
+
+	__device__ void GetNormalAt(const v3f& point, const Mesh& mesh, v3f& normal, 
+		const ObjectId* triangleId = null) const
+	{
+		v3f objectPoint;
+		inverseTransform.Transform(point, objectPoint);
+
+		v3f objectNormal;
+		mesh.GetNormalAt(objectPoint - mesh.position, objectNormal, triangleId);
+		inverseTransform.TransformNormal(objectNormal, normal);
+		vectors::Normalize(normal);
+	}
+
+	// has to be called after transform or mesh changed
+	__device__ void Update(const Mesh& mesh)
+	{
+		inverseTransform = transform;
+		inverseTransform.InvertAffine();
+
+		position.Set(transform.box[Matrix4x4::TX], transform.box[Matrix4x4::TY], transform.box[Matrix4x4::TZ]);
+
+		// world bounds of transformed mesh cell, relative to position
+		cell.SetEmpty();
+		for (uint i = 0; i < 8; ++i)
+		{
+			const v3f corner(
+				(i & 1 ? mesh.cell.maxCorner.x : mesh.cell.minCorner.x) + mesh.position.x,
+				(i & 2 ? mesh.cell.maxCorner.y : mesh.cell.minCorner.y) + mesh.position.y,
+				(i & 4 ? mesh.cell.maxCorner.z : mesh.cell.minCorner.z) + mesh.position.z);
+
+			v3f worldCorner;
+			transform.Transform(corner, worldCorner);
+			cell.Add(worldCorner - position);
+		}
+	}
+
+	__device__ Ray GetObjectRay(const Ray& ray) const
+	{
+		Ray objectRay;
+		inverseTransform.Transform(ray.origin, objectRay.origin);
+		inverseTransform.TransformDirection(ray.direction, objectRay.direction);
+		objectRay.Prepare();
+
+		return objectRay;
+	}
+};
+
+#endif __mesh_instance_h
@@ -1,35 +1,40 @@
-#ifndef __objects_h
-#define __objects_h
-
-#include "AACell.h"
-#include "Array.h"
-#include "Box.h"
-#include "BoxLightSource.h"
-#include "Light.h"
-#include "List.h"
-#include "Mesh.h"
-#include "Object.h"
-#include "Plane.h"
-#include "PointLightSource.h"
-#include "Sphere.h"
-#include "SphereLightSource.h"
-#include "Triangle.h"
-
-
-struct Objects
-{
-	ui32 counts[ObjectType::Count];
-
-	list_of<ObjectId> everything;
-
-	list_of<Box> boxes;
-	list_of<Plane> planes;
-	list_of<Sphere> spheres;
-	list_of<Mesh> meshes;
-	list_of<PointLightSource> pointLights;
-	list_of<SphereLightSource> sphereLights;
-	list_of<BoxLightSource> boxLights;
-	list_of<Material> materials;
-};
-
-#endif __objects_h
+#ifndef __objects_h
+#define __objects_h
+
+#include "AACell.h"
+#include "Array.h"
+#include "Box.h"
+#include "BoxLightSource.h"
+#include "Light.h"
+#include "List.h"
+#include "Mesh.h"
+#include "MeshInstance.h"
+#include "Object.h"
+#include "Plane.h"
+#include "PointLightSource.h"
+#include "Sphere.h"
+#include "SphereLightSource.h"
+#include "Triangle.h"
+
+
+struct Objects
+{
+	ui32 counts[ObjectType::Count];
+	// incremented whenever object is added, trees built for older version are not reused
+	ui64 version;
+
+	list_of<ObjectId> everything;
+
+	list_of<Box> boxes;
+	list_of<Plane> planes;
+	list_of<Sphere> spheres;
+	list_of<Mesh> meshes;
+	list_of<Mesh> sharedMeshes; // geometry used only by mesh instances
+	list_of<MeshInstance> meshInstances;
+	list_of<PointLightSource> pointLights;
+	list_of<SphereLightSource> sphereLights;
+	list_of<BoxLightSource> boxLights;
+	list_of<Material> materials;
+};
+
+#endif __objects_h
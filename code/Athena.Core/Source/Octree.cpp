@@ -1,508 +1,1466 @@
-#include "Athena.h"
-#include "HitResult.h"
-#include "Log.h"
-#include "MemoryManager.h"
-#include "Octree.h"
-#include "Ray.h"
-#include "Rendering.h"
-#include "Scene.h"
-#include "Timers.h"
-#include "Timer.h"
-#include "ZOrder.h"
-
-#define NODE_MEM_POOL_PAGE_SIZE	1024
-
-
-ui8 Octree::octreeNodePositions[8];
-
-
-void Octree::Destroy(MemoryManager* memoryManagerInstance)
-{
-	if (objects)
-	{
-		ShowStats();
-
-		objects = null;
-
-		for (uint i = 0; i < threadNodes.count; ++i)
-			threadNodes[i].Destroy();
-		_MEM_FREE_ARRAY(memoryManagerInstance, list_of<OctreeNode>, &threadNodes);
-
-		LOG_DEBUG("Octree::Destroy");
-	}
-}
-
-void Octree::Initialize(Objects* objects, MemoryManager* memoryManagerInstance)
-{
-	numOfNodesUsed = numOfObjectsUsed = depthSum = numOfEmptyNodes = 0;
-	numOfTreesConstructed = 0;
-	currentDepth = currentMaxDepth = 0;
-	currentMinDepth = OCTREE_DEFAULT_MAX_DEPTH;
-	totalThreadsUsed = 0;
-
-	threadNodes = _MEM_ALLOC_ARRAY(memoryManagerInstance, list_of<OctreeNode>, 8);
-	for (uint i = 0; i < threadNodes.count; ++i)
-		threadNodes[i].Initialize(memoryManagerInstance, "OctreeNode", NODE_MEM_POOL_PAGE_SIZE);
-
-	octreeNodePositions[0] = OctreeNodePosition::x0y0z0;
-	octreeNodePositions[1] = OctreeNodePosition::x1y0z0;
-	octreeNodePositions[2] = OctreeNodePosition::x0y1z0;
-	octreeNodePositions[3] = OctreeNodePosition::x1y1z0;
-	octreeNodePositions[4] = OctreeNodePosition::x0y0z1;
-	octreeNodePositions[5] = OctreeNodePosition::x1y0z1;
-	octreeNodePositions[6] = OctreeNodePosition::x0y1z1;
-	octreeNodePositions[7] = OctreeNodePosition::x1y1z1;
-
-	this->objects = objects;
-}
-
-bool Octree::Update(array_of<std::thread>& threads, ui32 maxDepth, AthenaStorage* athenaStorage)
-{
-	TIMED_BLOCK(&athenaStorage->timers[TimerId::OctreeConstruction]);
-
-	// use multi-threading
-	const bool useThreads = threads.count >= 8;
-
-	for (uint i = 0; i < threadNodes.count; ++i)
-		threadNodes[i].Clear();
-
-	currentDepth = 0;
-	currentNumOfNodesUsed = 0;
-
-	if (!objects->everything.currentCount)
-		return false;
-
-	if (athenaStorage->renderingParameters.tracingMethod != TracingMethod::Octree)
-		return false;
-
-	// get root bounding box
-	UpdateRootCell();
-
-	ui32 nodesUsed[8] = {};
-	if (maxDepth)
-	{
-		const v3f childCellSize = (rootCell.maxCorner - rootCell.minCorner) * .5;
-		const v3f rootCellCenter = (rootCell.minCorner + rootCell.maxCorner) * .5;
-
-		AACell childNodeCell;
-		for (ui32 threadId = 0; threadId < 8; ++threadId)
-		{
-			const v3ui zorder3 = ZOrder::Decode3ui(threadId);
-			const v3f zorder3f(zorder3.x, zorder3.y, zorder3.z);
-
-			childNodeCell.minCorner = rootCell.minCorner + zorder3f * childCellSize;
-			childNodeCell.maxCorner = rootCellCenter + zorder3f * childCellSize;
-
-			if (useThreads)
-			{
-				threads[threadId] = std::thread(ProcessNode, threadNodes[threadId], objects, &nodesUsed[threadId],
-					childNodeCell, (ui32)threadNodes[threadId].Add(), maxDepth);
-			}
-			else
-				ProcessNode(threadNodes[threadId], objects, &nodesUsed[threadId],
-					childNodeCell, (ui32)threadNodes[threadId].Add(), maxDepth);
-		}
-
-		if (useThreads)
-			for (ui32 threadId = 0; threadId < 8; ++threadId)
-				threads[threadId].join();
-	}
-
-	totalThreadsUsed += 8;
-	
-	currentNumOfNodesUsed = 1; // root node
-	for (ui32 i = 0; i < 8; ++i)
-		currentNumOfNodesUsed += nodesUsed[i];
-
-	numOfNodesUsed += currentNumOfNodesUsed;
-	numOfEmptyNodes += GetTotalNodeCount(maxDepth) - currentNumOfNodesUsed;
-	
-	numOfTreesConstructed++;
-	numOfObjectsUsed += objects->everything.currentCount;
-
-	currentDepth = maxDepth;
-	depthSum += currentDepth;
-
-	if (currentDepth < currentMinDepth)
-		currentMinDepth = currentDepth;
-
-	if (currentDepth > currentMaxDepth)
-		currentMaxDepth = currentDepth;
-
-	return true;
-}
-
-ui64 Octree::GetTotalNodeCount(ui32 depth)
-{
-	ui64 count = 0;
-	for (ui32 i = 0; i <= depth; ++i)
-		count += (ui64)pow(pow(2, i), 3);
-
-	return count;
-}
-
-template <typename T> void AddObjectListToCell(const list_of<T>& objectList, AACell& cell)
-{
-	for (uint32 i = 0; i < (uint32)objectList.currentCount; ++i)
-	{
-		const T& object = objectList[i];
-		cell.minCorner.Set(
-			MIN2(object.cell.minCorner.x + object.position.x, cell.minCorner.x),
-			MIN2(object.cell.minCorner.y + object.position.y, cell.minCorner.y),
-			MIN2(object.cell.minCorner.z + object.position.z, cell.minCorner.z));
-		cell.maxCorner.Set(
-			MAX2(object.cell.maxCorner.x + object.position.x, cell.maxCorner.x),
-			MAX2(object.cell.maxCorner.y + object.position.y, cell.maxCorner.y),
-			MAX2(object.cell.maxCorner.z + object.position.z, cell.maxCorner.z));
-	}
-}
-
-void Octree::UpdateRootCell()
-{
-	rootCell.maxCorner.Set(-_INFINITY, -_INFINITY, -_INFINITY);
-	rootCell.minCorner.Set(_INFINITY, _INFINITY, _INFINITY);
-
-	AddObjectListToCell<Box>(objects->boxes, rootCell);
-	AddObjectListToCell<Sphere>(objects->spheres, rootCell);
-	//AddObjectListToCell<PointLightSource>(objects->lights, rootCell);
-	AddObjectListToCell<Mesh>(objects->meshes, rootCell);
-
-	// pre zjednodusenie, bude octree v tvare kocky
-	const real max = MAX3(rootCell.maxCorner.x, rootCell.maxCorner.y, rootCell.maxCorner.z);
-	const real min = MIN3(rootCell.minCorner.x, rootCell.minCorner.y, rootCell.minCorner.z);
-	rootCell.maxCorner.Set(max, max, max);
-	rootCell.minCorner.Set(min, min, min);
-}
-
-void Octree::ProcessNode(list_of<OctreeNode>& nodes, const Objects* objects, ui32* nodesUsed,
-	const AACell& nodeCell, ui32 nodeId, ui32 maxDepth)
-{
-	nodes[nodeId].Clear();
-
-	if (!maxDepth)
-		return;
-	maxDepth--;
-
-	const v3f childCellSize = (nodeCell.maxCorner - nodeCell.minCorner) * .5;
-	const v3f nodeCellCenter = (nodeCell.minCorner + nodeCell.maxCorner) * .5;
-
-	AACell childNodeCell;
-	for (ui32 i = 0; i < 8; ++i)
-	{
-		const v3ui zorder3 = ZOrder::Decode3ui(i);
-		const v3f zorder3f(zorder3.x, zorder3.y, zorder3.z);
-
-		childNodeCell.minCorner = nodeCell.minCorner + zorder3f * childCellSize;
-		childNodeCell.maxCorner = nodeCellCenter + zorder3f * childCellSize;
-		
-		if (!IsNodeEmpty(objects, childNodeCell))
-		{
-			nodes[nodeId].nodeMask |= octreeNodePositions[i];
-			nodes[nodeId].childNodeCount++;
-		}
-	}
-	
-	if (!maxDepth)
-	{
-		// IsParentNode() == true
-		// child nodes are leafs, so this will be called parent node
-		// processing ends here, because we dont need to allocate memory for child nodes (leaves)
-	}
-	else if (nodes[nodeId].childNodeCount)
-	{
-		nodes[nodeId].firstChildNodeId = (ui32)nodes.Add(nodes[nodeId].childNodeCount);
-
-		const ui8 nodeMask = nodes[nodeId].nodeMask;
-		ui32 nextChildNodeId = nodes[nodeId].firstChildNodeId;
-		for (ui32 i = 0; i < 8; ++i)
-		{
-			if (nodeMask & octreeNodePositions[i])
-			{
-				const v3ui zorder3 = ZOrder::Decode3ui(i);
-				const v3f zorder3f(zorder3.x, zorder3.y, zorder3.z);
-
-				childNodeCell.minCorner = nodeCell.minCorner + zorder3f * childCellSize;
-				childNodeCell.maxCorner = nodeCellCenter + zorder3f * childCellSize;
-
-				ProcessNode(nodes, objects, nodesUsed, childNodeCell, nextChildNodeId, maxDepth);
-				nextChildNodeId++;
-			}
-		}
-	}
-
-	*nodesUsed = (ui32)nodes.currentCount;
-}
-
-bool Octree::IsNodeEmpty(const Objects* objects, const AACell& nodeCell)
-{
-	for (uint i = 0; i < objects->everything.currentCount; ++i)
-	{
-		const ObjectId& objectId = objects->everything[i];
-		switch (objects->everything[i].Type())
-		{
-			case ObjectType::Sphere: 
-				if (objects->spheres[objectId.index].AndAACell(nodeCell))
-					return false;
-				break;
-		
-			case ObjectType::Box:
-				if (objects->boxes[objectId.index].AndAACell(nodeCell))
-					return false;
-				break;
-
-			case ObjectType::Plane:
-			case ObjectType::Mesh:
-			case ObjectType::PointLightSource:
-				break;
-		}
-	}
-
-	return true;
-}
-
-void Octree::Hit(const Ray& ray, HitResult& hitResult) const
-{
-	if (!currentDepth)
-		return;
-
-	hitResult.nodeTestCount++;
-
-	if (!Box(rootCell).Collide(ray, 0, hitResult.distance))
-		return;
-
-	const v3f childCellSize = (rootCell.maxCorner - rootCell.minCorner) * .5;
-	const v3f rootCellCenter = (rootCell.minCorner + rootCell.maxCorner) * .5;
-
-	AACell childNodeCell;
-	for (ui32 threadId = 0; threadId < 8; ++threadId)
-	{
-		if (!threadNodes[threadId].currentCount)
-			continue;
-
-		const v3ui zorder3 = ZOrder::Decode3ui(threadId);
-		const v3f zorder3f(zorder3.x, zorder3.y, zorder3.z);
-
-		childNodeCell.minCorner = rootCell.minCorner + zorder3f * childCellSize;
-		childNodeCell.maxCorner = rootCellCenter + zorder3f * childCellSize;
-
-		HitNode(ray, threadNodes[threadId], 0, childNodeCell, hitResult);
-	}
-}
-
-void Octree::HitNode(const Ray& ray, const list_of<OctreeNode>& nodes, ui32 nodeId, const AACell& nodeCell, 
-	HitResult& hitResult) const
-{
-	if (!nodes[nodeId].childNodeCount)
-		return;
-
-	hitResult.nodeTestCount++;
-
-	if (!Box(nodeCell).Collide(ray, 0, hitResult.distance))
-		return;
-
-	const v3f childCellSize = (nodeCell.maxCorner - nodeCell.minCorner) * .5;
-	const v3f nodeCellCenter = (nodeCell.minCorner + nodeCell.maxCorner) * .5;
-
-	AACell childNodeCell;
-	ui32 nextChildNodeId = nodes[nodeId].firstChildNodeId;
-	for (ui32 i = 0; i < 8; ++i)
-	{
-		if (nodes[nodeId].nodeMask & octreeNodePositions[i])
-		{
-			const v3ui zorder3 = ZOrder::Decode3ui(i);
-			const v3f zorder3f(zorder3.x, zorder3.y, zorder3.z);
-
-			childNodeCell.minCorner = nodeCell.minCorner + zorder3f * childCellSize;
-			childNodeCell.maxCorner = nodeCellCenter + zorder3f * childCellSize;
-
-			if (nodes[nodeId].IsParentNode())
-			{
-				hitResult.nodeTestCount++;
-
-				Box childNodeBox(childNodeCell);
-				const real distance = childNodeBox.Hit(ray);
-
-				if (distance < hitResult.distance)
-				{
-					hitResult.distance = distance;
-					hitResult.point = ray.origin + ray.direction * hitResult.distance;
-					childNodeBox.GetNormalAt(hitResult.point, hitResult.normal);
-					
-					hitResult.objectId.Set(ObjectType::Voxel, 0);
-				}
-			}
-			else
-			{
-				HitNode(ray, nodes, nextChildNodeId, childNodeCell, hitResult);
-				nextChildNodeId++;
-			}
-		}
-	}
-}
-
-bool Octree::Collide(const Ray& ray, real from, real to) const
-{
-	if (!Box(rootCell).Collide(ray, from, to))
-		return false;
-
-	const v3f childCellSize = (rootCell.maxCorner - rootCell.minCorner) * .5;
-	const v3f rootCellCenter = (rootCell.minCorner + rootCell.maxCorner) * .5;
-
-	AACell childNodeCell;
-	for (ui32 nodePoolId = 0; nodePoolId < 8; ++nodePoolId)
-	{
-		if (!threadNodes[nodePoolId].currentCount)
-			continue;
-
-		const v3ui zorder3 = ZOrder::Decode3ui(nodePoolId);
-		const v3f zorder3f(zorder3.x, zorder3.y, zorder3.z);
-
-		childNodeCell.minCorner = rootCell.minCorner + zorder3f * childCellSize;
-		childNodeCell.maxCorner = rootCellCenter + zorder3f * childCellSize;
-
-		if (CollideNode(ray, threadNodes[nodePoolId], 0, childNodeCell, from, to))
-			return true;
-	}
-
-	return false;
-}
-
-bool Octree::CollideNode(const Ray& ray, const list_of<OctreeNode>& nodes, uint32 nodeId, const AACell& nodeCell,
-	real from, real to) const
-{
-	if (!nodes[nodeId].childNodeCount)
-		return false;
-
-	if (!Box(nodeCell).Collide(ray, from, to))
-		return false;
-
-	const v3f childCellSize = (nodeCell.maxCorner - nodeCell.minCorner) * .5;
-	const v3f nodeCellCenter = (nodeCell.minCorner + nodeCell.maxCorner) * .5;
-
-	AACell childNodeCell;
-	ui32 nextChildNodeId = nodes[nodeId].firstChildNodeId;
-	for (ui32 i = 0; i < 8; ++i)
-	{
-		if (nodes[nodeId].nodeMask & octreeNodePositions[i])
-		{
-			const v3ui zorder3 = ZOrder::Decode3ui(i);
-			const v3f zorder3f(zorder3.x, zorder3.y, zorder3.z);
-
-			childNodeCell.minCorner = nodeCell.minCorner + zorder3f * childCellSize;
-			childNodeCell.maxCorner = nodeCellCenter + zorder3f * childCellSize;
-
-			if (nodes[nodeId].IsParentNode())
-			{
-				Box childNodeBox(childNodeCell);
-				if (/*!childNodeBox.IsInside(ray.origin) && */childNodeBox.Collide(ray, from, to))
-					return true;
-			}
-			else
-			{
-				if (CollideNode(ray, nodes, nextChildNodeId, childNodeCell, from, to))
-					return true;
-			
-				nextChildNodeId++;
-			}
-		}
-	}
-
-	return false;
-}
-
-void Octree::ShowStats()
-{
-	using namespace Common::Strings;
-
-	char tmpBuffer[256] = {};
-
-	if (numOfTreesConstructed)
-	{
-		const uint avgMemUsed = (uint)((real)numOfNodesUsed * sizeof(BIHNode)) / numOfTreesConstructed;
-
-		LOG_TL(LogLevel::Info, "Octree statistics:");
-		LOG_TL(LogLevel::Info, "\ttrees constructed:\t%I64d", numOfTreesConstructed);
-		LOG_TL(LogLevel::Info, "\tthreads used:\t\t~%d/tree", totalThreadsUsed / numOfTreesConstructed);
-		//LOG_TL(LogLevel::Info, "\tconstruction time:\t%.3fms (avg %.3fms/tree)",
-		//	constructionTime, constructionTime / numOfTreesConstructed);
-		LOG_TL(LogLevel::Info, "\tdepth min/max/avg:\t%d/%d/%d",
-			currentMinDepth, currentMaxDepth, depthSum / numOfTreesConstructed);
-		LOG_TL(LogLevel::Info, "\tobjects used:\t\t%I64d (avg %d/tree)", numOfObjectsUsed,
-			numOfObjectsUsed / numOfTreesConstructed);
-		LOG_TL(LogLevel::Info, "\tnodes used:\t\t%d (avg %d/tree %s)",
-			numOfNodesUsed,
-			numOfNodesUsed / numOfTreesConstructed,
-			GetMemSizeString(tmpBuffer, avgMemUsed));
-		LOG_TL(LogLevel::Info, "\ttree fill:\t\t~%.3f%%", 
-			((real)numOfNodesUsed / (numOfNodesUsed + numOfEmptyNodes)) * 100);
-	}
-}
-
-//void Voxelizer::FillVoxelAsAverage(OctreeNode* node)
-//{
-//	int childNodesCount = 0;
-//	int nextChildNodeId = node->firstChildNodeId;
-//
-//	vector4i color;
-//	xyzw_SET(color, 0, 0, 0, 0);
-//
-//	for (int i = 1; i != 256; i *= 2)
-//		if (node->nodeMask & (unsigned char)i)
-//		{
-//			const Voxel* voxel = &nodeMemPool->Get(nextChildNodeId)->voxel;
-//
-//			xyzw_ADD_VECTOR(color, voxel->color);
-//			xyz_ADD_VECTOR(node->voxel.normal, voxel->normal);
-//			
-//			nextChildNodeId++;
-//			childNodesCount++;
-//		}
-//
-//	const float childNodesCountRec = 1.0f / (float)childNodesCount;
-//	xyz_MUL(node->voxel.normal, childNodesCountRec);
-//	xyzw_SET(node->voxel.color, 
-//		(unsigned char)(color.x / childNodesCount),
-//		(unsigned char)(color.y / childNodesCount),
-//		(unsigned char)(color.z / childNodesCount),
-//		(unsigned char)(color.w / childNodesCount));
-//}
-//
-//int Voxelizer::CountNodes(const OctreeNode* node)
-//{
-//	if (node->nodeMask == 0)
-//		return 1;
-//
-//	int nodesCount = 1;
-//	int nextChildNodeId = node->firstChildNodeId;
-//
-//	for (int i = 1; i != 256; i *= 2)
-//		if (node->nodeMask & (unsigned char)i)
-//		{
-//			nodesCount += CountNodes(nodeMemPool->Get(nextChildNodeId));
-//			nextChildNodeId++;
-//		}
-//	
-//	return nodesCount;
-//}
-//
-//int Octree::GetDepth(const OctreeNode* node)
-//{
-//	if (node->nodeMask == 0)
-//		return 1;
-//
-//	int maxDepth = 0;
-//	int nextChildNodeId = node->firstChildNodeId;
-//	
-//	for (int i = 1; i != 256; i *= 2)
-//		if (node->nodeMask & (unsigned char)i)
-//		{
-//			int depth = GetDepth(nodeMemPool->Get(nextChildNodeId));
-//			
-//			if (depth > maxDepth)
-//				maxDepth = depth;
-//
-//			nextChildNodeId++;
-//		}
-//
-//	return maxDepth + 1;
-//}
+#include "Athena.h"
+#include "Bits.h"
+#include "Convert.h"
+#include "HitResult.h"
+#include "Log.h"
+#include "MemoryManager.h"
+#include "Mutex.h"
+#include "Octree.h"
+#include "Ray.h"
+#include "Rendering.h"
+#include "Scene.h"
+#include "Timers.h"
+#include "Timer.h"
+#include "ZOrder.h"
+
+#define NODE_MEM_POOL_PAGE_SIZE	1024
+
+
+// stored before nodes (then leaves and leaf objects of object tree) in scene cache
+struct OctreeCacheHeader
+{
+	ui64 objectCount;
+	ui64 nodeCount;
+	ui64 leafCount;
+	ui64 leafObjectCount;
+	// voxel attributes of voxel tree, stored after child voxel ids (one per node)
+	ui64 voxelCount;
+
+	ui32 depth;
+	ui32 objectLeaves;
+
+	AACell rootCell;
+};
+
+ui8 Octree::octreeNodePositions[8];
+
+
+void Octree::Destroy(MemoryManager* memoryManagerInstance)
+{
+	if (objects)
+	{
+		ShowStats();
+
+		objects = null;
+
+		nodes.Destroy();
+		leaves.Destroy();
+		leafObjectIds.Destroy();
+		voxels.Destroy();
+		childVoxelIds.Destroy();
+		triangles.Destroy();
+		tasks.Destroy();
+
+		for (uint i = 0; i < workers.count; ++i)
+		{
+			workers[i].nodes.Destroy();
+			workers[i].leaves.Destroy();
+			workers[i].leafObjectIds.Destroy();
+			workers[i].voxels.Destroy();
+			workers[i].childVoxelIds.Destroy();
+			workers[i].objectIds.Destroy();
+			workers[i].objectCells.Destroy();
+			workers[i].taskIds.Destroy();
+		}
+		_MEM_FREE_ARRAY(memoryManagerInstance, OctreeBuildWorker, &workers);
+
+		LOG_DEBUG("Octree::Destroy");
+	}
+}
+
+void Octree::Initialize(Objects* objects, MemoryManager* memoryManagerInstance)
+{
+	numOfNodesUsed = numOfObjectsUsed = numOfLeafObjectsUsed = numOfTrianglesUsed = depthSum = numOfEmptyNodes = 0;
+	numOfTreesConstructed = numOfTreesLoaded = 0;
+	currentDepth = currentMaxDepth = 0;
+	currentNumOfNodesUsed = currentNumOfObjects = 0;
+	currentObjectsVersion = 0;
+	currentObjectLeaves = false;
+	currentLodFraction = 0;
+	currentMinDepth = OCTREE_DEFAULT_MAX_DEPTH;
+	totalThreadsUsed = totalTasksUsed = 0;
+
+	nodes.Initialize(memoryManagerInstance, "OctreeNode", NODE_MEM_POOL_PAGE_SIZE);
+	leaves.Initialize(memoryManagerInstance, "OctreeLeaf", NODE_MEM_POOL_PAGE_SIZE);
+	leafObjectIds.Initialize(memoryManagerInstance, "ObjectId", NODE_MEM_POOL_PAGE_SIZE);
+	voxels.Initialize(memoryManagerInstance, "OctreeVoxel", NODE_MEM_POOL_PAGE_SIZE);
+	childVoxelIds.Initialize(memoryManagerInstance, "ui32", NODE_MEM_POOL_PAGE_SIZE);
+	triangles.Initialize(memoryManagerInstance, "OctreeTriangle", NODE_MEM_POOL_PAGE_SIZE);
+	tasks.Initialize(memoryManagerInstance, "OctreeBuildTask");
+
+	// lists of workers are initialized when worker is used for the first time
+	workers = _MEM_ALLOC_ARRAY(memoryManagerInstance, OctreeBuildWorker, OCTREE_MAX_BUILD_WORKERS);
+	// allocated memory can contain old data
+	memset(workers.ptr, 0, sizeof(OctreeBuildWorker) * workers.count);
+	workerCount = 0;
+	pendingTaskCount = 0;
+	tasksMutex = null;
+
+	octreeNodePositions[0] = OctreeNodePosition::x0y0z0;
+	octreeNodePositions[1] = OctreeNodePosition::x1y0z0;
+	octreeNodePositions[2] = OctreeNodePosition::x0y1z0;
+	octreeNodePositions[3] = OctreeNodePosition::x1y1z0;
+	octreeNodePositions[4] = OctreeNodePosition::x0y0z1;
+	octreeNodePositions[5] = OctreeNodePosition::x1y0z1;
+	octreeNodePositions[6] = OctreeNodePosition::x0y1z1;
+	octreeNodePositions[7] = OctreeNodePosition::x1y1z1;
+
+	this->objects = objects;
+	this->memoryManagerInstance = memoryManagerInstance;
+}
+
+bool Octree::Update(array_of<std::thread>& threads, ui32 maxDepth, bool sceneChanged, AthenaStorage* athenaStorage)
+{
+	TIMED_BLOCK(&athenaStorage->timers[TimerId::OctreeConstruction]);
+
+	// voxels of tree are ray casted also through SVO, which can not reference objects
+	const TracingMethod::Enum tracingMethod = athenaStorage->renderingParameters.tracingMethod;
+	const bool treeUsed = tracingMethod == TracingMethod::Octree || tracingMethod == TracingMethod::SparseVoxelOctree;
+	const bool objectLeaves = athenaStorage->renderingParameters.octreeObjectLeaves != 0 &&
+		tracingMethod == TracingMethod::Octree;
+	currentLodFraction = athenaStorage->renderingParameters.voxelLodFraction;
+
+	// existing tree can be reused if it was built with the same depth for the same objects
+	if (!sceneChanged && currentNumOfNodesUsed && maxDepth == currentDepth &&
+		objects->version == currentObjectsVersion && objectLeaves == (currentObjectLeaves != 0) &&
+		treeUsed)
+		return true;
+
+	nodes.Clear();
+	leaves.Clear();
+	leafObjectIds.Clear();
+	voxels.Clear();
+	childVoxelIds.Clear();
+	triangles.Clear();
+
+	currentDepth = 0;
+	currentNumOfNodesUsed = currentNumOfObjects = 0;
+	currentObjectsVersion = 0;
+	currentObjectLeaves = objectLeaves;
+
+	if (!objects->everything.currentCount)
+		return false;
+
+	if (!treeUsed)
+		return false;
+
+	UpdateTriangles();
+
+	// get root bounding box
+	UpdateRootCell(objectLeaves);
+
+	// without threads whole tree is built by one worker on calling thread
+	workerCount = (ui32)MAX2(MIN2(threads.count, OCTREE_MAX_BUILD_WORKERS), 1);
+	for (ui32 i = 0; i < workerCount; ++i)
+	{
+		OctreeBuildWorker& worker = workers[i];
+		if (!worker.nodes.memoryManagerInstance)
+		{
+			worker.nodes.Initialize(memoryManagerInstance, "OctreeNode", NODE_MEM_POOL_PAGE_SIZE);
+			worker.leaves.Initialize(memoryManagerInstance, "OctreeLeaf", NODE_MEM_POOL_PAGE_SIZE);
+			worker.leafObjectIds.Initialize(memoryManagerInstance, "ObjectId", NODE_MEM_POOL_PAGE_SIZE);
+			worker.voxels.Initialize(memoryManagerInstance, "OctreeVoxel", NODE_MEM_POOL_PAGE_SIZE);
+			worker.childVoxelIds.Initialize(memoryManagerInstance, "ui32", NODE_MEM_POOL_PAGE_SIZE);
+			worker.objectIds.Initialize(memoryManagerInstance, "ObjectId", NODE_MEM_POOL_PAGE_SIZE);
+			worker.objectCells.Initialize(memoryManagerInstance, "AACell", NODE_MEM_POOL_PAGE_SIZE);
+			worker.taskIds.Initialize(memoryManagerInstance, "ui32");
+		}
+
+		worker.nodes.Clear();
+		worker.leaves.Clear();
+		worker.leafObjectIds.Clear();
+		worker.voxels.Clear();
+		worker.childVoxelIds.Clear();
+		worker.objectIds.Clear();
+		worker.objectCells.Clear();
+		worker.taskIds.Clear();
+		worker.firstTaskId = 0;
+	}
+
+	if (maxDepth)
+	{
+		// objects without bounds (planes, point lights) are not part of tree
+		list_of<ObjectId>& objectIds = workers[0].objectIds;
+		list_of<AACell>& objectCells = workers[0].objectCells;
+
+		AACell objectCell;
+		for (uint i = 0; i < objects->everything.currentCount; ++i)
+		{
+			// voxel tree is made of triangles of meshes
+			const ObjectType::Enum type = objects->everything[i].Type();
+			if (!objectLeaves && (type == ObjectType::Mesh || type == ObjectType::MeshInstance))
+				continue;
+
+			if (GetObjectCell(objects->everything[i], objectCell))
+			{
+				objectIds.Add(objects->everything[i]);
+				objectCells.Add(objectCell);
+			}
+		}
+
+		ObjectId triangleId;
+		for (uint i = 0; i < triangles.currentCount; ++i)
+		{
+			triangleId.Set(ObjectType::Triangle, i);
+			GetObjectCell(triangleId, objectCell);
+
+			objectIds.Add(triangleId);
+			objectCells.Add(objectCell);
+		}
+
+		Mutex mutex;
+		tasksMutex = &mutex;
+		tasks.Clear();
+		pendingTaskCount = 0;
+
+		// whole tree is the first task, children of root are one level deeper than maxDepth says
+		const ui32 rootTaskId = CreateTask(0, rootCell, maxDepth + 1, 0, objectIds.currentCount);
+		objectIds.Clear();
+		objectCells.Clear();
+
+		if (workerCount > 1)
+		{
+			for (ui32 workerId = 0; workerId < workerCount; ++workerId)
+				threads[workerId] = std::thread(&Octree::ProcessTasks, this, workerId);
+			for (ui32 workerId = 0; workerId < workerCount; ++workerId)
+				threads[workerId].join();
+		}
+		else
+			ProcessTasks(0);
+
+		tasksMutex = null;
+
+		nodes.Add();
+		if (!objectLeaves)
+			childVoxelIds.Add();
+		StitchNode(0, tasks[rootTaskId].workerId, tasks[rootTaskId].nodeId);
+
+		totalTasksUsed += tasks.currentCount;
+
+		if (!objectLeaves)
+			FilterVoxels();
+	}
+
+	totalThreadsUsed += workerCount;
+
+	currentNumOfNodesUsed = (uint)nodes.currentCount;
+
+	numOfNodesUsed += currentNumOfNodesUsed;
+	numOfEmptyNodes += GetTotalNodeCount(maxDepth + 1) - currentNumOfNodesUsed;
+
+	numOfTreesConstructed++;
+	numOfObjectsUsed += objects->everything.currentCount;
+	numOfLeafObjectsUsed += leafObjectIds.currentCount;
+	numOfTrianglesUsed += triangles.currentCount;
+
+	currentNumOfObjects = objects->everything.currentCount;
+	currentObjectsVersion = objects->version;
+	currentDepth = maxDepth;
+	depthSum += currentDepth;
+
+	if (currentDepth < currentMinDepth)
+		currentMinDepth = currentDepth;
+
+	if (currentDepth > currentMaxDepth)
+		currentMaxDepth = currentDepth;
+
+	return true;
+}
+
+void Octree::ProcessTasks(ui32 workerId)
+{
+	OctreeBuildTask task;
+	ui32 taskId;
+
+	for (;;)
+	{
+		if (TakeTask(workerId, task, taskId))
+		{
+			ProcessTask(workerId, taskId, task);
+			continue;
+		}
+
+		// subtrees still under construction can create new tasks
+		tasksMutex->Lock();
+		const bool done = !pendingTaskCount;
+		tasksMutex->UnLock();
+
+		if (done)
+			break;
+
+		std::this_thread::yield();
+	}
+}
+
+bool Octree::TakeTask(ui32 workerId, OctreeBuildTask& task, ui32& taskId)
+{
+	bool result = false;
+
+	tasksMutex->Lock();
+
+	OctreeBuildWorker& worker = workers[workerId];
+	if (worker.firstTaskId < worker.taskIds.currentCount)
+	{
+		// own task created last continues depth first construction
+		taskId = worker.taskIds[worker.taskIds.currentCount - 1];
+		worker.taskIds.currentCount--;
+		result = true;
+	}
+	else
+	{
+		for (ui32 i = 1; i < workerCount && !result; ++i)
+		{
+			OctreeBuildWorker& victim = workers[(workerId + i) % workerCount];
+			if (victim.firstTaskId < victim.taskIds.currentCount)
+			{
+				taskId = victim.taskIds[victim.firstTaskId++];
+				result = true;
+			}
+		}
+	}
+
+	if (result)
+		task = tasks[taskId];
+
+	// emptied queue is reused from beginning
+	if (worker.firstTaskId == worker.taskIds.currentCount)
+		worker.firstTaskId = worker.taskIds.currentCount = 0;
+
+	tasksMutex->UnLock();
+
+	return result;
+}
+
+void Octree::ProcessTask(ui32 workerId, ui32 taskId, OctreeBuildTask& task)
+{
+	OctreeBuildWorker& worker = workers[workerId];
+
+	// candidate objects of task are moved to scratch lists of worker
+	const uint firstObjectId = worker.objectIds.currentCount;
+	if (task.objectIds.count)
+	{
+		worker.objectIds.Add(task.objectIds.count);
+		worker.objectCells.Add(task.objectCells.count);
+		memcpy(&worker.objectIds[firstObjectId], task.objectIds.ptr, task.objectIds.count * sizeof(ObjectId));
+		memcpy(&worker.objectCells[firstObjectId], task.objectCells.ptr, task.objectCells.count * sizeof(AACell));
+
+		_MEM_FREE_ARRAY(memoryManagerInstance, ObjectId, &task.objectIds);
+		_MEM_FREE_ARRAY(memoryManagerInstance, AACell, &task.objectCells);
+	}
+
+	const ui32 nodeId = (ui32)worker.nodes.Add();
+	worker.childVoxelIds.Add();
+	ProcessNode(workerId, task.cell, nodeId, firstObjectId, worker.objectIds.currentCount - firstObjectId, task.depth);
+
+	worker.objectIds.currentCount = worker.objectCells.currentCount = firstObjectId;
+
+	tasksMutex->Lock();
+	tasks[taskId].workerId = workerId;
+	tasks[taskId].nodeId = nodeId;
+	pendingTaskCount--;
+	tasksMutex->UnLock();
+}
+
+ui32 Octree::CreateTask(ui32 workerId, const AACell& cell, ui32 depth, uint firstObjectId, uint objectCount)
+{
+	const OctreeBuildWorker& worker = workers[workerId];
+
+	OctreeBuildTask task;
+	task.cell = cell;
+	task.depth = depth;
+	task.workerId = task.nodeId = 0;
+	task.objectIds = array_of<ObjectId>();
+	task.objectCells = array_of<AACell>();
+	if (objectCount)
+	{
+		task.objectIds = _MEM_ALLOC_ARRAY(memoryManagerInstance, ObjectId, objectCount);
+		task.objectCells = _MEM_ALLOC_ARRAY(memoryManagerInstance, AACell, objectCount);
+		memcpy(task.objectIds.ptr, &worker.objectIds[firstObjectId], objectCount * sizeof(ObjectId));
+		memcpy(task.objectCells.ptr, &worker.objectCells[firstObjectId], objectCount * sizeof(AACell));
+	}
+
+	tasksMutex->Lock();
+	ui32 taskId = (ui32)tasks.Add(task);
+	workers[workerId].taskIds.Add(taskId);
+	pendingTaskCount++;
+	tasksMutex->UnLock();
+
+	return taskId;
+}
+
+void Octree::StitchNode(ui32 nodeId, ui32 workerId, ui32 workerNodeId)
+{
+	OctreeNode node = workers[workerId].nodes[workerNodeId];
+	if (node.childNodeCount == OCTREE_TASK_NODE)
+	{
+		// subtree was built by task, possibly by another worker
+		const OctreeBuildTask& task = tasks[node.firstChildNodeId];
+		workerId = task.workerId;
+		workerNodeId = task.nodeId;
+		node = workers[workerId].nodes[workerNodeId];
+	}
+
+	if (!node.childNodeCount)
+	{
+		if (currentObjectLeaves)
+		{
+			const OctreeLeaf& workerLeaf = workers[workerId].leaves[node.firstChildNodeId];
+			const list_of<ObjectId>& workerLeafObjectIds = workers[workerId].leafObjectIds;
+
+			const ui32 leafId = (ui32)leaves.Add();
+			leaves[leafId].firstObjectId = (ui32)leafObjectIds.currentCount;
+			leaves[leafId].objectCount = workerLeaf.objectCount;
+
+			if (workerLeaf.objectCount)
+			{
+				leafObjectIds.Add(workerLeaf.objectCount);
+				memcpy(&leafObjectIds[leaves[leafId].firstObjectId], &workerLeafObjectIds[workerLeaf.firstObjectId],
+					workerLeaf.objectCount * sizeof(ObjectId));
+			}
+
+			node.firstChildNodeId = leafId;
+		}
+	}
+	else if (node.firstChildNodeId)
+	{
+		const ui32 firstChildNodeId = (ui32)nodes.Add(node.childNodeCount);
+		if (!currentObjectLeaves)
+			childVoxelIds.Add((uint)node.childNodeCount);
+		for (ui32 i = 0; i < node.childNodeCount; ++i)
+			StitchNode(firstChildNodeId + i, workerId, node.firstChildNodeId + i);
+
+		node.firstChildNodeId = firstChildNodeId;
+	}
+	else
+	{
+		// voxels of parent node
+		const OctreeBuildWorker& worker = workers[workerId];
+
+		const ui32 firstVoxelId = (ui32)voxels.Add((uint)node.childNodeCount);
+		memcpy(&voxels[firstVoxelId], &worker.voxels[worker.childVoxelIds[workerNodeId]],
+			node.childNodeCount * sizeof(OctreeVoxel));
+		childVoxelIds[nodeId] = firstVoxelId;
+	}
+
+	nodes[nodeId] = node;
+}
+
+uint Octree::GetCacheSize() const
+{
+	uint size = sizeof(OctreeCacheHeader);
+	if (currentNumOfNodesUsed)
+		size += nodes.currentCount * sizeof(OctreeNode) + leaves.currentCount * sizeof(OctreeLeaf) +
+			leafObjectIds.currentCount * sizeof(ObjectId) + childVoxelIds.currentCount * sizeof(ui32) +
+			voxels.currentCount * sizeof(OctreeVoxel);
+
+	return size;
+}
+
+void Octree::WriteCache(ui8* memory) const
+{
+	OctreeCacheHeader* header = (OctreeCacheHeader*)memory;
+	memset(header, 0, sizeof(OctreeCacheHeader));
+
+	// empty tree is stored only as header
+	if (!currentNumOfNodesUsed)
+		return;
+
+	header->objectCount = currentNumOfObjects;
+	header->nodeCount = nodes.currentCount;
+	header->leafCount = leaves.currentCount;
+	header->leafObjectCount = leafObjectIds.currentCount;
+	header->voxelCount = voxels.currentCount;
+	header->depth = currentDepth;
+	header->objectLeaves = currentObjectLeaves;
+	header->rootCell = rootCell;
+
+	memory += sizeof(OctreeCacheHeader);
+	memcpy(memory, nodes.array.ptr, nodes.currentCount * sizeof(OctreeNode));
+	memory += nodes.currentCount * sizeof(OctreeNode);
+
+	memcpy(memory, leaves.array.ptr, leaves.currentCount * sizeof(OctreeLeaf));
+	memory += leaves.currentCount * sizeof(OctreeLeaf);
+
+	memcpy(memory, leafObjectIds.array.ptr, leafObjectIds.currentCount * sizeof(ObjectId));
+	memory += leafObjectIds.currentCount * sizeof(ObjectId);
+
+	memcpy(memory, childVoxelIds.array.ptr, childVoxelIds.currentCount * sizeof(ui32));
+	memory += childVoxelIds.currentCount * sizeof(ui32);
+
+	memcpy(memory, voxels.array.ptr, voxels.currentCount * sizeof(OctreeVoxel));
+}
+
+bool Octree::ReadCache(const ui8* memory, uint size)
+{
+	if (size < sizeof(OctreeCacheHeader))
+		return false;
+
+	const OctreeCacheHeader* header = (const OctreeCacheHeader*)memory;
+	if (!header->nodeCount || header->objectCount != objects->everything.currentCount)
+		return false;
+
+	// only object tree has leaves, only voxel tree has voxels
+	if (!header->objectLeaves && (header->leafCount || header->leafObjectCount))
+		return false;
+	if (header->objectLeaves && header->voxelCount)
+		return false;
+
+	// voxel tree has child voxel id for each node
+	const uint childVoxelIdCount = header->objectLeaves ? 0 : header->nodeCount;
+	if (size != sizeof(OctreeCacheHeader) + header->nodeCount * sizeof(OctreeNode) +
+		header->leafCount * sizeof(OctreeLeaf) + header->leafObjectCount * sizeof(ObjectId) +
+		childVoxelIdCount * sizeof(ui32) + header->voxelCount * sizeof(OctreeVoxel))
+		return false;
+
+	// damaged file must not break traversal, children are always stored after parent
+	const OctreeNode* cachedNodes = (const OctreeNode*)(memory + sizeof(OctreeCacheHeader));
+	for (uint i = 0; i < header->nodeCount; ++i)
+	{
+		const OctreeNode& node = cachedNodes[i];
+		if (header->objectLeaves && !node.childNodeCount)
+		{
+			if (node.firstChildNodeId >= header->leafCount)
+				return false;
+		}
+		else if (node.childNodeCount > 8 || (node.firstChildNodeId &&
+			(node.firstChildNodeId <= i || node.firstChildNodeId + node.childNodeCount > header->nodeCount)))
+			return false;
+	}
+
+	const OctreeLeaf* cachedLeaves = (const OctreeLeaf*)(cachedNodes + header->nodeCount);
+	for (uint i = 0; i < header->leafCount; ++i)
+		if ((ui64)cachedLeaves[i].firstObjectId + cachedLeaves[i].objectCount > header->leafObjectCount)
+			return false;
+
+	const ObjectId* cachedLeafObjectIds = (const ObjectId*)(cachedLeaves + header->leafCount);
+	for (uint i = 0; i < header->leafObjectCount; ++i)
+	{
+		const ObjectId& objectId = cachedLeafObjectIds[i];
+		if (objectId.type >= ObjectType::Count || objectId.index >= objects->counts[objectId.type])
+			return false;
+	}
+
+	const ui32* cachedChildVoxelIds = (const ui32*)(cachedLeafObjectIds + header->leafObjectCount);
+	for (uint i = 0; i < childVoxelIdCount; ++i)
+		if ((ui64)cachedChildVoxelIds[i] + cachedNodes[i].childNodeCount > header->voxelCount)
+			return false;
+
+	const OctreeVoxel* cachedVoxels = (const OctreeVoxel*)(cachedChildVoxelIds + childVoxelIdCount);
+
+	nodes.Clear();
+	nodes.Add(header->nodeCount);
+	memcpy(nodes.array.ptr, cachedNodes, header->nodeCount * sizeof(OctreeNode));
+
+	leaves.Clear();
+	if (header->leafCount)
+	{
+		leaves.Add(header->leafCount);
+		memcpy(leaves.array.ptr, cachedLeaves, header->leafCount * sizeof(OctreeLeaf));
+	}
+
+	leafObjectIds.Clear();
+	if (header->leafObjectCount)
+	{
+		leafObjectIds.Add(header->leafObjectCount);
+		memcpy(leafObjectIds.array.ptr, cachedLeafObjectIds, header->leafObjectCount * sizeof(ObjectId));
+	}
+
+	childVoxelIds.Clear();
+	if (childVoxelIdCount)
+	{
+		childVoxelIds.Add(childVoxelIdCount);
+		memcpy(childVoxelIds.array.ptr, cachedChildVoxelIds, childVoxelIdCount * sizeof(ui32));
+	}
+
+	voxels.Clear();
+	if (header->voxelCount)
+	{
+		voxels.Add(header->voxelCount);
+		memcpy(voxels.array.ptr, cachedVoxels, header->voxelCount * sizeof(OctreeVoxel));
+	}
+
+	currentNumOfObjects = (uint)header->objectCount;
+	currentObjectsVersion = objects->version;
+	currentNumOfNodesUsed = (uint)header->nodeCount;
+	currentObjectLeaves = header->objectLeaves != 0;
+	currentDepth = header->depth;
+	rootCell = header->rootCell;
+
+	numOfTreesLoaded++;
+
+	return true;
+}
+
+ui64 Octree::GetTotalNodeCount(ui32 depth)
+{
+	ui64 count = 0;
+	for (ui32 i = 0; i <= depth; ++i)
+		count += (ui64)pow(pow(2, i), 3);
+
+	return count;
+}
+
+template <typename T> void AddObjectListToCell(const list_of<T>& objectList, AACell& cell)
+{
+	for (uint32 i = 0; i < (uint32)objectList.currentCount; ++i)
+	{
+		const T& object = objectList[i];
+		cell.minCorner.Set(
+			MIN2(object.cell.minCorner.x + object.position.x, cell.minCorner.x),
+			MIN2(object.cell.minCorner.y + object.position.y, cell.minCorner.y),
+			MIN2(object.cell.minCorner.z + object.position.z, cell.minCorner.z));
+		cell.maxCorner.Set(
+			MAX2(object.cell.maxCorner.x + object.position.x, cell.maxCorner.x),
+			MAX2(object.cell.maxCorner.y + object.position.y, cell.maxCorner.y),
+			MAX2(object.cell.maxCorner.z + object.position.z, cell.maxCorner.z));
+	}
+}
+
+void Octree::UpdateRootCell(bool objectLeaves)
+{
+	rootCell.maxCorner.Set(-_INFINITY, -_INFINITY, -_INFINITY);
+	rootCell.minCorner.Set(_INFINITY, _INFINITY, _INFINITY);
+
+	AddObjectListToCell<Box>(objects->boxes, rootCell);
+	AddObjectListToCell<Sphere>(objects->spheres, rootCell);
+	//AddObjectListToCell<PointLightSource>(objects->lights, rootCell);
+	AddObjectListToCell<Mesh>(objects->meshes, rootCell);
+
+	AddObjectListToCell<MeshInstance>(objects->meshInstances, rootCell);
+
+	// object tree contains all objects with bounds
+	if (objectLeaves)
+	{
+		AddObjectListToCell<SphereLightSource>(objects->sphereLights, rootCell);
+		AddObjectListToCell<BoxLightSource>(objects->boxLights, rootCell);
+	}
+
+	// pre zjednodusenie, bude octree v tvare kocky
+	const real max = MAX3(rootCell.maxCorner.x, rootCell.maxCorner.y, rootCell.maxCorner.z);
+	const real min = MIN3(rootCell.minCorner.x, rootCell.minCorner.y, rootCell.minCorner.z);
+	rootCell.maxCorner.Set(max, max, max);
+	rootCell.minCorner.Set(min, min, min);
+}
+
+void Octree::ProcessNode(ui32 workerId, const AACell& nodeCell, ui32 nodeId, uint firstObjectId, uint objectCount,
+	ui32 maxDepth)
+{
+	OctreeBuildWorker& worker = workers[workerId];
+	list_of<OctreeNode>& workerNodes = worker.nodes;
+	list_of<ObjectId>& objectIds = worker.objectIds;
+	list_of<AACell>& objectCells = worker.objectCells;
+
+	workerNodes[nodeId].Clear();
+
+	if (!maxDepth)
+	{
+		// leaf of object tree, firstChildNodeId is its id
+		if (currentObjectLeaves)
+		{
+			const uint leafId = worker.leaves.Add();
+			worker.leaves[leafId].firstObjectId = (ui32)worker.leafObjectIds.currentCount;
+			worker.leaves[leafId].objectCount = (ui32)objectCount;
+
+			for (uint i = firstObjectId; i < firstObjectId + objectCount; ++i)
+				worker.leafObjectIds.Add(objectIds[i]);
+
+			workerNodes[nodeId].firstChildNodeId = (ui32)leafId;
+		}
+		return;
+	}
+	maxDepth--;
+
+	// voxels are not stored, object tree needs leaf nodes
+	const bool childrenAreVoxels = !maxDepth && !currentObjectLeaves;
+
+	// big enough subtrees of children are built by tasks, any idle worker can take them
+	bool createTasks = false;
+	if (workerCount > 1 && maxDepth >= OCTREE_MIN_BUILD_TASK_DEPTH)
+	{
+		// when there is enough work for all workers, subtrees are built directly
+		tasksMutex->Lock();
+		createTasks = pendingTaskCount < workerCount * OCTREE_TASKS_PER_WORKER;
+		tasksMutex->UnLock();
+	}
+
+	const v3f childCellSize = (nodeCell.maxCorner - nodeCell.minCorner) * .5;
+	const v3f nodeCellCenter = (nodeCell.minCorner + nodeCell.maxCorner) * .5;
+
+	// child ranges are released when node is processed
+	const uint objectIdsUsed = objectIds.currentCount;
+	const ui32 firstVoxelId = (ui32)worker.voxels.currentCount;
+	uint childFirstObjectIds[8] = {};
+	uint childObjectCounts[8] = {};
+
+	AACell childNodeCell;
+	for (ui32 i = 0; i < 8; ++i)
+	{
+		const v3ui zorder3 = ZOrder::Decode3ui(i);
+		const v3f zorder3f(zorder3.x, zorder3.y, zorder3.z);
+
+		childNodeCell.minCorner = nodeCell.minCorner + zorder3f * childCellSize;
+		childNodeCell.maxCorner = nodeCellCenter + zorder3f * childCellSize;
+
+		if (childrenAreVoxels)
+		{
+			// children are leafs, one overlapping object is enough
+			OctreeVoxel voxel;
+			if (GetVoxel(objectIds, objectCells, firstObjectId, objectCount, childNodeCell, voxel))
+			{
+				workerNodes[nodeId].nodeMask |= octreeNodePositions[i];
+				workerNodes[nodeId].childNodeCount++;
+				worker.voxels.Add(voxel);
+			}
+			continue;
+		}
+
+		childFirstObjectIds[i] = objectIds.currentCount;
+		for (uint j = firstObjectId; j < firstObjectId + objectCount; ++j)
+		{
+			// lists can be reallocated by Add
+			ObjectId objectId = objectIds[j];
+			AACell objectCell = objectCells[j];
+			if (IsObjectInNode(objectId, objectCell, childNodeCell, currentObjectLeaves != 0))
+			{
+				objectIds.Add(objectId);
+				objectCells.Add(objectCell);
+			}
+		}
+		childObjectCounts[i] = objectIds.currentCount - childFirstObjectIds[i];
+
+		if (childObjectCounts[i])
+		{
+			workerNodes[nodeId].nodeMask |= octreeNodePositions[i];
+			workerNodes[nodeId].childNodeCount++;
+		}
+	}
+
+	if (childrenAreVoxels)
+	{
+		// IsParentNode() == true
+		// child nodes are leafs, so this will be called parent node
+		// processing ends here, because we dont need to allocate memory for child nodes (leaves)
+		worker.childVoxelIds[nodeId] = firstVoxelId;
+	}
+	else if (workerNodes[nodeId].childNodeCount)
+	{
+		workerNodes[nodeId].firstChildNodeId = (ui32)workerNodes.Add(workerNodes[nodeId].childNodeCount);
+		worker.childVoxelIds.Add((uint)workerNodes[nodeId].childNodeCount);
+
+		const ui8 nodeMask = workerNodes[nodeId].nodeMask;
+		ui32 nextChildNodeId = workerNodes[nodeId].firstChildNodeId;
+		for (ui32 i = 0; i < 8; ++i)
+		{
+			if (nodeMask & octreeNodePositions[i])
+			{
+				const v3ui zorder3 = ZOrder::Decode3ui(i);
+				const v3f zorder3f(zorder3.x, zorder3.y, zorder3.z);
+
+				childNodeCell.minCorner = nodeCell.minCorner + zorder3f * childCellSize;
+				childNodeCell.maxCorner = nodeCellCenter + zorder3f * childCellSize;
+
+				if (createTasks)
+				{
+					// replaced by root of task subtree when tree is stitched
+					workerNodes[nextChildNodeId].Clear();
+					workerNodes[nextChildNodeId].childNodeCount = OCTREE_TASK_NODE;
+					workerNodes[nextChildNodeId].firstChildNodeId = CreateTask(workerId, childNodeCell, maxDepth,
+						childFirstObjectIds[i], childObjectCounts[i]);
+				}
+				else
+					ProcessNode(workerId, childNodeCell, nextChildNodeId, childFirstObjectIds[i], childObjectCounts[i],
+						maxDepth);
+				nextChildNodeId++;
+			}
+		}
+	}
+
+	objectIds.currentCount = objectCells.currentCount = objectIdsUsed;
+}
+
+void Octree::UpdateTriangles()
+{
+	if (currentObjectLeaves)
+		return;
+
+	// meshes are hit with the first material
+	const v3f meshColor = objects->materials.currentCount ? objects->materials[0].diffuseColor : v3f(1, 1, 1);
+
+	OctreeTriangle triangle;
+	for (uint i = 0; i < objects->meshes.currentCount; ++i)
+	{
+		const Mesh& mesh = objects->meshes[i];
+		for (uint j = 0; j < mesh.triangles.count; ++j)
+		{
+			const Triangle& meshTriangle = mesh.triangles[j];
+			triangle.v0 = mesh.vertices[meshTriangle.v.x] + mesh.position;
+			triangle.v1 = mesh.vertices[meshTriangle.v.y] + mesh.position;
+			triangle.v2 = mesh.vertices[meshTriangle.v.z] + mesh.position;
+
+			triangle.voxel.color = Vector3fToVector4b(meshColor);
+			SetVoxelNormal(triangle.voxel, meshTriangle.normal);
+
+			triangles.Add(triangle);
+		}
+	}
+
+	for (uint i = 0; i < objects->meshInstances.currentCount; ++i)
+	{
+		const MeshInstance& instance = objects->meshInstances[i];
+		const Mesh& mesh = objects->sharedMeshes[instance.meshIndex];
+		const v3f color = instance.materialIndex < objects->materials.currentCount ?
+			objects->materials[instance.materialIndex].diffuseColor : v3f(1, 1, 1);
+
+		v3f normal;
+		for (uint j = 0; j < mesh.triangles.count; ++j)
+		{
+			const Triangle& meshTriangle = mesh.triangles[j];
+			instance.transform.Transform(mesh.vertices[meshTriangle.v.x] + mesh.position, triangle.v0);
+			instance.transform.Transform(mesh.vertices[meshTriangle.v.y] + mesh.position, triangle.v1);
+			instance.transform.Transform(mesh.vertices[meshTriangle.v.z] + mesh.position, triangle.v2);
+
+			instance.transform.TransformDirection(meshTriangle.normal, normal);
+			triangle.voxel.color = Vector3fToVector4b(color);
+			SetVoxelNormal(triangle.voxel, normal);
+
+			triangles.Add(triangle);
+		}
+	}
+}
+
+void Octree::FilterVoxels()
+{
+	// children are stored after their parent, so their voxels are ready when nodes are processed from the last one
+	for (uint nodeId = nodes.currentCount; nodeId-- > 0;)
+	{
+		const OctreeNode node = nodes[nodeId];
+		if (!node.childNodeCount || node.IsParentNode())
+			continue;
+
+		const ui32 firstVoxelId = (ui32)voxels.Add((uint)node.childNodeCount);
+		childVoxelIds[nodeId] = firstVoxelId;
+
+		for (ui32 i = 0; i < node.childNodeCount; ++i)
+		{
+			const ui32 childNodeId = node.firstChildNodeId + i;
+			const ui32 childCount = nodes[childNodeId].childNodeCount;
+
+			// prefiltered attributes, opposite normals of thin parts can cancel out
+			OctreeVoxel& voxel = voxels[firstVoxelId + i];
+			memset(&voxel, 0, sizeof(OctreeVoxel));
+			if (!childCount)
+				continue;
+
+			ui32 color[4] = {};
+			v3f normal;
+			for (ui32 j = 0; j < childCount; ++j)
+			{
+				const OctreeVoxel& childVoxel = voxels[childVoxelIds[childNodeId] + j];
+				color[0] += childVoxel.color.x;
+				color[1] += childVoxel.color.y;
+				color[2] += childVoxel.color.z;
+				color[3] += childVoxel.color.w;
+				normal += GetVoxelNormal(childVoxel);
+			}
+
+			voxel.color.Set((ui8)(color[0] / childCount), (ui8)(color[1] / childCount),
+				(ui8)(color[2] / childCount), (ui8)(color[3] / childCount));
+
+			if (vectors::Length2(normal) > EPSILON)
+				SetVoxelNormal(voxel, normal);
+			else
+				SetVoxelNormal(voxel, GetVoxelNormal(voxels[childVoxelIds[childNodeId]]));
+		}
+	}
+}
+
+void Octree::GetObjectVoxel(const ObjectId& objectId, const AACell& voxelCell, OctreeVoxel& voxel) const
+{
+	const v3f voxelCenter = (voxelCell.minCorner + voxelCell.maxCorner) * .5;
+
+	v3f normal;
+	ui32 materialIndex = 0;
+	switch (objectId.Type())
+	{
+		case ObjectType::Sphere:
+			objects->spheres[objectId.index].GetNormalAt(voxelCenter, normal);
+			materialIndex = objects->spheres[objectId.index].materialIndex;
+			break;
+
+		case ObjectType::Box:
+			objects->boxes[objectId.index].GetNormalAt(voxelCenter, normal);
+			materialIndex = objects->boxes[objectId.index].materialIndex;
+			break;
+
+		case ObjectType::Triangle:
+			voxel = triangles[objectId.index].voxel;
+			return;
+	}
+
+	// normal of voxel in the center of sphere is not defined
+	if (!(vectors::Length2(normal) > EPSILON))
+		normal.Set(0, 0, 1);
+
+	voxel.color = Vector3fToVector4b(materialIndex < objects->materials.currentCount ?
+		objects->materials[materialIndex].diffuseColor : v3f(1, 1, 1));
+	SetVoxelNormal(voxel, normal);
+}
+
+bool Octree::GetVoxel(const list_of<ObjectId>& objectIds, const list_of<AACell>& objectCells,
+	uint firstObjectId, uint objectCount, const AACell& voxelCell, OctreeVoxel& voxel) const
+{
+	for (uint i = firstObjectId; i < firstObjectId + objectCount; ++i)
+	{
+		if (IsObjectInNode(objectIds[i], objectCells[i], voxelCell, false))
+		{
+			GetObjectVoxel(objectIds[i], voxelCell, voxel);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool Octree::IsObjectInNode(const ObjectId& objectId, const AACell& objectCell, const AACell& nodeCell,
+	bool objectLeaves) const
+{
+	// world cell is checked first, objects are touched only when it overlaps
+	if (!objectCell.AndAACell(nodeCell))
+		return false;
+
+	// object tree uses bounds of objects (as BIH does), so rays starting inside of them find them too
+	if (objectLeaves)
+		return true;
+
+	// object not overlapping cell does not overlap any of its children either
+	switch (objectId.Type())
+	{
+		case ObjectType::Sphere: 
+			return objects->spheres[objectId.index].AndAACell(nodeCell);
+		
+		case ObjectType::Box:
+			return objects->boxes[objectId.index].AndAACell(nodeCell);
+
+		case ObjectType::Triangle:
+		{
+			const OctreeTriangle& triangle = triangles[objectId.index];
+			return Triangle::AndAACell(triangle.v0, triangle.v1, triangle.v2, nodeCell);
+		}
+
+		case ObjectType::Plane:
+		case ObjectType::Mesh:
+		case ObjectType::MeshInstance:
+		case ObjectType::PointLightSource:
+			break;
+	}
+
+	return false;
+}
+
+bool Octree::GetObjectCell(const ObjectId& objectId, AACell& objectCell) const
+{
+	switch (objectId.Type())
+	{
+		case ObjectType::Triangle:
+		{
+			const OctreeTriangle& triangle = triangles[objectId.index];
+			objectCell.SetEmpty();
+			objectCell.Add(triangle.v0);
+			objectCell.Add(triangle.v1);
+			objectCell.Add(triangle.v2);
+			return true;
+		}
+
+		case ObjectType::Sphere:
+			GetWorldCell(objects->spheres[objectId.index], objectCell);
+			return true;
+
+		case ObjectType::Box:
+			GetWorldCell(objects->boxes[objectId.index], objectCell);
+			return true;
+
+		case ObjectType::Mesh:
+			GetWorldCell(objects->meshes[objectId.index], objectCell);
+			return true;
+
+		case ObjectType::MeshInstance:
+			GetWorldCell(objects->meshInstances[objectId.index], objectCell);
+			return true;
+
+		case ObjectType::SphereLightSource:
+			GetWorldCell(objects->sphereLights[objectId.index], objectCell);
+			return true;
+
+		case ObjectType::BoxLightSource:
+			GetWorldCell(objects->boxLights[objectId.index], objectCell);
+			return true;
+
+		case ObjectType::Plane:
+		case ObjectType::PointLightSource:
+			break;
+	}
+
+	return false;
+}
+
+// distances of cell slabs along ray, entry slab first (in the order given by ray.sign)
+static bool GetCellDistances(const Ray& ray, const AACell& cell, real* t0, real* t1)
+{
+	for (ui32 i = 0; i < 3; ++i)
+	{
+		const real origin = ray.origin.Get(i);
+		if (ray.direction.Get(i) == 0)
+		{
+			// ray parallel with slab never crosses its planes
+			if (origin < cell.minCorner.Get(i) || origin > cell.maxCorner.Get(i))
+				return false;
+
+			t0[i] = -_INFINITY;
+			t1[i] = _INFINITY;
+			continue;
+		}
+
+		const real entry = ray.sign.Get(i) ? cell.maxCorner.Get(i) : cell.minCorner.Get(i);
+		const real exit = ray.sign.Get(i) ? cell.minCorner.Get(i) : cell.maxCorner.Get(i);
+
+		t0[i] = (entry - origin) * ray.invDirection.Get(i);
+		t1[i] = (exit - origin) * ray.invDirection.Get(i);
+	}
+
+	return true;
+}
+
+// distances of cell midplanes along ray
+static void GetMidplaneDistances(const Ray& ray, const AACell& cell, real* tm)
+{
+	for (ui32 i = 0; i < 3; ++i)
+	{
+		const real center = (cell.minCorner.Get(i) + cell.maxCorner.Get(i)) * .5;
+		const real origin = ray.origin.Get(i);
+
+		if (ray.direction.Get(i) == 0)
+			// parallel ray stays in the half it starts in, midplane is crossed never or "before" entry
+			tm[i] = (origin < center) != (ray.sign.Get(i) != 0) ? _INFINITY : -_INFINITY;
+		else
+			tm[i] = (center - origin) * ray.invDirection.Get(i);
+	}
+}
+
+// first child entered by ray, child index is mirrored so ray goes from lower to upper half in every axis
+static ui32 GetFirstChild(const real* t0, const real* tm)
+{
+	if (t0[0] >= t0[1] && t0[0] >= t0[2])
+		return (tm[1] < t0[0] ? 2 : 0) | (tm[2] < t0[0] ? 4 : 0);
+
+	if (t0[1] >= t0[2])
+		return (tm[0] < t0[1] ? 1 : 0) | (tm[2] < t0[1] ? 4 : 0);
+
+	return (tm[0] < t0[2] ? 1 : 0) | (tm[1] < t0[2] ? 2 : 0);
+}
+
+// child entered after leaving mirrored child through its nearest exit plane, 8 when ray leaves node
+static ui32 GetNextChild(ui32 child, const real* childT1)
+{
+	const ui32 exitAxis = childT1[0] <= childT1[1] ?
+		(childT1[0] <= childT1[2] ? 0 : 2) : (childT1[1] <= childT1[2] ? 1 : 2);
+
+	if (child & (1 << exitAxis))
+		return 8;
+
+	return child | (1 << exitAxis);
+}
+
+static void GetChildDistances(ui32 child, const real* t0, const real* tm, const real* t1,
+	real* childT0, real* childT1)
+{
+	for (ui32 i = 0; i < 3; ++i)
+	{
+		childT0[i] = (child & (1 << i)) ? tm[i] : t0[i];
+		childT1[i] = (child & (1 << i)) ? t1[i] : tm[i];
+	}
+}
+
+static void GetChildCell(const AACell& nodeCell, ui32 position, AACell& childCell)
+{
+	const v3f childCellSize = (nodeCell.maxCorner - nodeCell.minCorner) * .5;
+	const v3ui zorder3 = ZOrder::Decode3ui(position);
+	const v3f zorder3f(zorder3.x, zorder3.y, zorder3.z);
+
+	childCell.minCorner = nodeCell.minCorner + zorder3f * childCellSize;
+	childCell.maxCorner = childCell.minCorner + childCellSize;
+}
+
+// child nodes are stored in order of their positions, only non-empty ones
+static ui32 GetChildOffset(ui8 nodeMask, ui32 position)
+{
+	return CountBits(nodeMask & ((1u << position) - 1));
+}
+
+static ui32 GetMirrorMask(const Ray& ray)
+{
+	return (ui32)(ray.sign.x | (ray.sign.y << 1) | (ray.sign.z << 2));
+}
+
+void Octree::Hit(const Ray& ray, HitResult& hitResult) const
+{
+	if (!nodes.currentCount)
+		return;
+
+	real t0[3], t1[3];
+	if (!GetCellDistances(ray, rootCell, t0, t1))
+		return;
+
+	HitNode(ray, 0, rootCell, t0, t1, hitResult);
+}
+
+bool Octree::HitNode(const Ray& ray, ui32 nodeId, const AACell& nodeCell,
+	const real* t0, const real* t1, HitResult& hitResult) const
+{
+	const OctreeNode& node = nodes[nodeId];
+	if (!node.childNodeCount && !currentObjectLeaves)
+		return false;
+
+	hitResult.nodeTestCount++;
+
+	const real tMin = MAX3(t0[0], t0[1], t0[2]);
+	const real tMax = MIN3(t1[0], t1[1], t1[2]);
+	if (tMin > tMax || tMax <= 0 || tMin >= hitResult.distance)
+		return false;
+
+	if (!node.childNodeCount)
+	{
+		// hit inside of this leaf is nearer than anything in cells behind it
+		HitLeaf(ray, node.firstChildNodeId, hitResult);
+		return hitResult.distance <= tMax;
+	}
+
+	real tm[3];
+	GetMidplaneDistances(ray, nodeCell, tm);
+
+	const ui32 mirrorMask = GetMirrorMask(ray);
+	// children smaller than this at distance 1 are hit as voxels with prefiltered attributes
+	const real lodSize = childVoxelIds.currentCount ? currentLodFraction * ray.footprint : 0;
+
+	AACell childNodeCell;
+	real childT0[3], childT1[3];
+	for (ui32 child = GetFirstChild(t0, tm); child < 8; child = GetNextChild(child, childT1))
+	{
+		GetChildDistances(child, t0, tm, t1, childT0, childT1);
+
+		const ui32 position = child ^ mirrorMask;
+		if (!(node.nodeMask & octreeNodePositions[position]))
+			continue;
+
+		if (node.IsParentNode() ||
+			(lodSize > 0 && (nodeCell.maxCorner.x - nodeCell.minCorner.x) * .5 < lodSize * MAX3(childT0[0], childT0[1], childT0[2])))
+		{
+			hitResult.nodeTestCount++;
+
+			// children are voxels, first one hit is the nearest
+			if (HitVoxel(ray, childT0, childT1, hitResult))
+			{
+				SetVoxelHit(nodeId, position, hitResult);
+				return true;
+			}
+		}
+		else
+		{
+			GetChildCell(nodeCell, position, childNodeCell);
+			if (HitNode(ray, node.firstChildNodeId + GetChildOffset(node.nodeMask, position),
+				childNodeCell, childT0, childT1, hitResult))
+				return true;
+		}
+	}
+
+	return false;
+}
+
+bool Octree::HitVoxel(const Ray& ray, const real* t0, const real* t1, HitResult& hitResult)
+{
+	const real tMin = MAX3(t0[0], t0[1], t0[2]);
+	const real tMax = MIN3(t1[0], t1[1], t1[2]);
+	if (tMin > tMax || tMax <= 0)
+		return false;
+
+	// ray starting inside of voxel hits it from inside
+	const bool fromInside = tMin <= 0;
+	const real distance = fromInside ? tMax : tMin;
+	if (distance >= hitResult.distance)
+		return false;
+
+	ui32 axis;
+	if (fromInside)
+		axis = t1[0] <= t1[1] ? (t1[0] <= t1[2] ? 0 : 2) : (t1[1] <= t1[2] ? 1 : 2);
+	else
+		axis = t0[0] >= t0[1] ? (t0[0] >= t0[2] ? 0 : 2) : (t0[1] >= t0[2] ? 1 : 2);
+
+	hitResult.distance = distance;
+	hitResult.point = ray.origin + ray.direction * hitResult.distance;
+	hitResult.normal.Set(0, 0, 0);
+	hitResult.normal[axis] = (ray.sign.Get(axis) != 0) != fromInside ? (real)1 : (real)-1;
+
+	hitResult.objectId.Set(ObjectType::Voxel, 0);
+
+	return true;
+}
+
+void Octree::SetVoxelHit(ui32 nodeId, ui32 position, HitResult& hitResult) const
+{
+	if (!childVoxelIds.currentCount)
+		return;
+
+	const OctreeVoxel& voxel = voxels[childVoxelIds[nodeId] + GetChildOffset(nodes[nodeId].nodeMask, position)];
+	hitResult.color = Vector4bToVector3f(voxel.color);
+
+	// voxel normal is turned to the same side as hit face of voxel
+	v3f normal = GetVoxelNormal(voxel);
+	if (vectors::Dot(normal, hitResult.normal) < 0)
+		vectors::Inv(normal);
+	hitResult.normal = normal;
+}
+
+void Octree::HitLeaf(const Ray& ray, ui32 leafId, HitResult& hitResult) const
+{
+	const OctreeLeaf& leaf = leaves[leafId];
+
+	ObjectId innerObjectId;
+	for (uint i = leaf.firstObjectId; i < leaf.firstObjectId + leaf.objectCount; ++i)
+	{
+		real t;
+		const ObjectId& objectId = leafObjectIds[i];
+		switch (objectId.Type())
+		{
+			case ObjectType::Sphere: t = objects->spheres[objectId.index].Hit(ray); break;
+			case ObjectType::Box: t = objects->boxes[objectId.index].Hit(ray); break;
+			case ObjectType::SphereLightSource: t = objects->sphereLights[objectId.index].Hit(ray); break;
+			case ObjectType::BoxLightSource: t = objects->boxLights[objectId.index].Hit(ray); break;
+			case ObjectType::Mesh: t = objects->meshes[objectId.index].Hit(ray, innerObjectId); break;
+			case ObjectType::MeshInstance:
+			{
+				const MeshInstance& instance = objects->meshInstances[objectId.index];
+				t = instance.Hit(ray, objects->sharedMeshes[instance.meshIndex], innerObjectId);
+				break;
+			}
+
+			default:
+				t = _INFINITY;
+		}
+
+		if (t > EPSILON && t < hitResult.distance)
+		{
+			hitResult.distance = t;
+			hitResult.objectId = objectId;
+			if (objectId.Type() == ObjectType::Mesh || objectId.Type() == ObjectType::MeshInstance)
+				hitResult.innerObjectId = innerObjectId;
+		}
+	}
+
+	hitResult.intersectionCount += leaf.objectCount;
+}
+
+bool Octree::Collide(const Ray& ray, real from, real to, const ObjectId* objectIdToSkip) const
+{
+	if (!nodes.currentCount)
+		return false;
+
+	real t0[3], t1[3];
+	if (!GetCellDistances(ray, rootCell, t0, t1))
+		return false;
+
+	return CollideNode(ray, 0, rootCell, t0, t1, from, to, objectIdToSkip);
+}
+
+bool Octree::CollideNode(const Ray& ray, uint32 nodeId, const AACell& nodeCell,
+	const real* t0, const real* t1, real from, real to, const ObjectId* objectIdToSkip) const
+{
+	const OctreeNode& node = nodes[nodeId];
+	if (!node.childNodeCount && !currentObjectLeaves)
+		return false;
+
+	const real tMin = MAX3(t0[0], t0[1], t0[2]);
+	const real tMax = MIN3(t1[0], t1[1], t1[2]);
+	if (tMin > tMax || tMin >= to || tMax <= from)
+		return false;
+
+	if (!node.childNodeCount)
+		return CollideLeaf(ray, node.firstChildNodeId, from, to, objectIdToSkip);
+
+	real tm[3];
+	GetMidplaneDistances(ray, nodeCell, tm);
+
+	const ui32 mirrorMask = GetMirrorMask(ray);
+	const real lodSize = childVoxelIds.currentCount ? currentLodFraction * ray.footprint : 0;
+
+	AACell childNodeCell;
+	real childT0[3], childT1[3];
+	for (ui32 child = GetFirstChild(t0, tm); child < 8; child = GetNextChild(child, childT1))
+	{
+		GetChildDistances(child, t0, tm, t1, childT0, childT1);
+
+		const ui32 position = child ^ mirrorMask;
+		if (!(node.nodeMask & octreeNodePositions[position]))
+			continue;
+
+		if (node.IsParentNode() ||
+			(lodSize > 0 && (nodeCell.maxCorner.x - nodeCell.minCorner.x) * .5 < lodSize * MAX3(childT0[0], childT0[1], childT0[2])))
+		{
+			const real voxelMin = MAX3(childT0[0], childT0[1], childT0[2]);
+			const real voxelMax = MIN3(childT1[0], childT1[1], childT1[2]);
+			if (voxelMin <= voxelMax && voxelMin < to && voxelMax > from)
+				return true;
+		}
+		else
+		{
+			GetChildCell(nodeCell, position, childNodeCell);
+			if (CollideNode(ray, node.firstChildNodeId + GetChildOffset(node.nodeMask, position),
+				childNodeCell, childT0, childT1, from, to, objectIdToSkip))
+				return true;
+		}
+	}
+
+	return false;
+}
+
+bool Octree::CollideLeaf(const Ray& ray, ui32 leafId, real from, real to, const ObjectId* objectIdToSkip) const
+{
+	const OctreeLeaf& leaf = leaves[leafId];
+
+	bool collision = false;
+	for (uint i = leaf.firstObjectId; i < leaf.firstObjectId + leaf.objectCount; ++i)
+	{
+		const ObjectId& objectId = leafObjectIds[i];
+		if ((objectId.Type() != ObjectType::Mesh && objectId.Type() != ObjectType::MeshInstance) &&
+			(objectId.IsLight() || (objectIdToSkip != null && objectId._value == objectIdToSkip->_value)))
+			continue;
+
+		switch (objectId.Type())
+		{
+			case ObjectType::Sphere:
+				collision = objects->spheres[objectId.index].Collide(ray, from, to);
+				break;
+			case ObjectType::Box:
+				collision = objects->boxes[objectId.index].Collide(ray, from, to);
+				break;
+			case ObjectType::Mesh:
+				collision = objects->meshes[objectId.index].Collide(ray, from, to);
+				break;
+			case ObjectType::MeshInstance:
+			{
+				const MeshInstance& instance = objects->meshInstances[objectId.index];
+				collision = instance.Collide(ray, objects->sharedMeshes[instance.meshIndex], from, to);
+				break;
+			}
+
+			default:
+				break;
+		}
+
+		if (collision)
+			return true;
+	}
+
+	return false;
+}
+
+void Octree::ShowStats()
+{
+	using namespace Common::Strings;
+
+	char tmpBuffer[256] = {};
+
+	if (numOfTreesConstructed)
+	{
+		const uint avgMemUsed = (uint)((real)numOfNodesUsed * sizeof(BIHNode)) / numOfTreesConstructed;
+
+		LOG_TL(LogLevel::Info, "Octree statistics:");
+		LOG_TL(LogLevel::Info, "\ttrees constructed:\t%I64d", numOfTreesConstructed);
+		LOG_TL(LogLevel::Info, "\ttrees loaded:\t\t%I64d", numOfTreesLoaded);
+		LOG_TL(LogLevel::Info, "\tthreads used:\t\t~%d/tree", totalThreadsUsed / numOfTreesConstructed);
+		LOG_TL(LogLevel::Info, "\ttasks used:\t\t~%d/tree", totalTasksUsed / numOfTreesConstructed);
+		//LOG_TL(LogLevel::Info, "\tconstruction time:\t%.3fms (avg %.3fms/tree)",
+		//	constructionTime, constructionTime / numOfTreesConstructed);
+		LOG_TL(LogLevel::Info, "\tdepth min/max/avg:\t%d/%d/%d",
+			currentMinDepth, currentMaxDepth, depthSum / numOfTreesConstructed);
+		LOG_TL(LogLevel::Info, "\tobjects used:\t\t%I64d (avg %d/tree)", numOfObjectsUsed,
+			numOfObjectsUsed / numOfTreesConstructed);
+		LOG_TL(LogLevel::Info, "\tleaf objects used:\t%I64d (avg %d/tree)", numOfLeafObjectsUsed,
+			numOfLeafObjectsUsed / numOfTreesConstructed);
+		LOG_TL(LogLevel::Info, "\ttriangles used:\t\t%I64d (avg %d/tree)", numOfTrianglesUsed,
+			numOfTrianglesUsed / numOfTreesConstructed);
+		LOG_TL(LogLevel::Info, "\tnodes used:\t\t%d (avg %d/tree %s)",
+			numOfNodesUsed,
+			numOfNodesUsed / numOfTreesConstructed,
+			GetMemSizeString(tmpBuffer, avgMemUsed));
+		LOG_TL(LogLevel::Info, "\ttree fill:\t\t~%.3f%%", 
+			((real)numOfNodesUsed / (numOfNodesUsed + numOfEmptyNodes)) * 100);
+	}
+}
+
+//void Voxelizer::FillVoxelAsAverage(OctreeNode* node)
+//{
+//	int childNodesCount = 0;
+//	int nextChildNodeId = node->firstChildNodeId;
+//
+//	vector4i color;
+//	xyzw_SET(color, 0, 0, 0, 0);
+//
+//	for (int i = 1; i != 256; i *= 2)
+//		if (node->nodeMask & (unsigned char)i)
+//		{
+//			const Voxel* voxel = &nodeMemPool->Get(nextChildNodeId)->voxel;
+//
+//			xyzw_ADD_VECTOR(color, voxel->color);
+//			xyz_ADD_VECTOR(node->voxel.normal, voxel->normal);
+//			
+//			nextChildNodeId++;
+//			childNodesCount++;
+//		}
+//
+//	const float childNodesCountRec = 1.0f / (float)childNodesCount;
+//	xyz_MUL(node->voxel.normal, childNodesCountRec);
+//	xyzw_SET(node->voxel.color, 
+//		(unsigned char)(color.x / childNodesCount),
+//		(unsigned char)(color.y / childNodesCount),
+//		(unsigned char)(color.z / childNodesCount),
+//		(unsigned char)(color.w / childNodesCount));
+//}
+//
+//int Voxelizer::CountNodes(const OctreeNode* node)
+//{
+//	if (node->nodeMask == 0)
+//		return 1;
+//
+//	int nodesCount = 1;
+//	int nextChildNodeId = node->firstChildNodeId;
+//
+//	for (int i = 1; i != 256; i *= 2)
+//		if (node->nodeMask & (unsigned char)i)
+//		{
+//			nodesCount += CountNodes(nodeMemPool->Get(nextChildNodeId));
+//			nextChildNodeId++;
+//		}
+//	
+//	return nodesCount;
+//}
+//
+//int Octree::GetDepth(const OctreeNode* node)
+//{
+//	if (node->nodeMask == 0)
+//		return 1;
+//
+//	int maxDepth = 0;
+//	int nextChildNodeId = node->firstChildNodeId;
+//	
+//	for (int i = 1; i != 256; i *= 2)
+//		if (node->nodeMask & (unsigned char)i)
+//		{
+//			int depth = GetDepth(nodeMemPool->Get(nextChildNodeId));
+//			
+//			if (depth > maxDepth)
+//				maxDepth = depth;
+//
+//			nextChildNodeId++;
+//		}
+//
+//	return maxDepth + 1;
+//}
@@ -1,115 +1,282 @@
-#ifndef __octree_h
-#define __octree_h
-
-#include "AACell.h"
-#include "Array.h"
-#include "thread"
-#include "TypeDefs.h"
-#include "Vectors.h"
-
-#define OCTREE_NODE_POSITION_VALUES(_) \
-	_(x0y0z0, = 1) \
-	_(x1y0z0, = 2) \
-	_(x0y1z0, = 4) \
-	_(x1y1z0, = 8) \
-	_(x0y0z1, = 16) \
-	_(x1y0z1, = 32) \
-	_(x0y1z1, = 64) \
-	_(x1y1z1, = 128)
-DECLARE_ENUM(OctreeNodePosition, OCTREE_NODE_POSITION_VALUES)
-#undef OCTREE_NODE_POSITION_VALUES
-
-
-struct OctreeNode
-{
-	union
-	{
-		ui8 nodeMask;
-		struct
-		{
-			ui8 nodeMask_x0y0z0 : 1;
-			ui8 nodeMask_x1y0z0 : 1;
-			ui8 nodeMask_x0y1z0 : 1;
-			ui8 nodeMask_x1y1z0 : 1;
-			ui8 nodeMask_x0y0z1 : 1;
-			ui8 nodeMask_x1y0z1 : 1;
-			ui8 nodeMask_x0y1z1 : 1;
-			ui8 nodeMask_x1y1z1 : 1;
-		};
-	};
-	ui8 childNodeCount;
-	
-	ui32 firstChildNodeId;
-
-	inline b32 IsParentNode() const { return childNodeCount && !firstChildNodeId; }
-
-	void Clear()
-	{
-		nodeMask = childNodeCount = 0;
-		firstChildNodeId = 0;
-	}
-};
-
-DLL_EXPORT_ARRAY_OF(OctreeNode);
-DLL_EXPORT_LIST_OF(OctreeNode);
-DLL_EXPORT_ARRAY_OF(list_of<OctreeNode>);
-
-
-class MemoryManager;
-struct Ray;
-struct HitResult;
-struct Objects;
-struct AthenaStorage;
-
-class DLL_EXPORT Octree
-{
-public:
-
-	void Initialize(Objects* objects, MemoryManager* memoryManagerInstance);
-	void Destroy(MemoryManager* memoryManagerInstance);
-	bool Update(array_of<std::thread>& threads, ui32 maxDepth, AthenaStorage* athenaStorage);
-
-	void Hit(const Ray& ray, HitResult& hitResult) const;
-	bool Collide(const Ray& ray, real from = EPSILON, real to = _INFINITY) const;
-
-	uint GetCurrentNodeCount() const { return currentNumOfNodesUsed; }
-
-private:
-
-	void HitNode(const Ray& ray, const list_of<OctreeNode>& nodes, ui32 nodeId, const AACell& nodeCell,
-		HitResult& hitResult) const;
-	bool CollideNode(const Ray& ray, const list_of<OctreeNode>& nodes, uint32 nodeId, const AACell& nodeCell,
-		real from, real to) const;
-
-	void ShowStats();
-
-	void UpdateRootCell();
-
-	static void ProcessNode(list_of<OctreeNode>& nodes, const Objects* objects, ui32* nodesUsed,
-		const AACell& nodeCell, ui32 nodeId, ui32 maxDepth);
-	
-	static bool IsNodeEmpty(const Objects* objects, const AACell& nodeCell);
-	ui64 GetTotalNodeCount(ui32 depth);
-
-private:
-
-	// statistics
-	ui64 totalThreadsUsed;
-	ui64 numOfNodesUsed;
-	ui64 numOfEmptyNodes;
-
-	ui64 numOfObjectsUsed;
-	ui64 numOfTreesConstructed;
-	ui64 depthSum;
-
-	uint currentDepth, currentMaxDepth, currentMinDepth, currentNumOfNodesUsed;
-
-	// main tree properties
-	AACell rootCell;
-	array_of<list_of<OctreeNode>> threadNodes;
-
-	Objects* objects;
-	static ui8 octreeNodePositions[8];
-};
-
-#endif __octree_h
+#ifndef __octree_h
+#define __octree_h
+
+#include "AACell.h"
+#include "Array.h"
+#include "List.h"
+#include "Object.h"
+#include "thread"
+#include "TypeDefs.h"
+#include "Vectors.h"
+
+#define OCTREE_MAX_BUILD_WORKERS		64
+#define OCTREE_MIN_BUILD_TASK_DEPTH		3 // shallower subtrees are not worth of separate task
+#define OCTREE_TASKS_PER_WORKER			4 // more waiting tasks are not created
+#define OCTREE_TASK_NODE				0xff // childNodeCount of node built by task with id firstChildNodeId
+
+#define OCTREE_NODE_POSITION_VALUES(_) \
+	_(x0y0z0, = 1) \
+	_(x1y0z0, = 2) \
+	_(x0y1z0, = 4) \
+	_(x1y1z0, = 8) \
+	_(x0y0z1, = 16) \
+	_(x1y0z1, = 32) \
+	_(x0y1z1, = 64) \
+	_(x1y1z1, = 128)
+DECLARE_ENUM(OctreeNodePosition, OCTREE_NODE_POSITION_VALUES)
+#undef OCTREE_NODE_POSITION_VALUES
+
+
+struct OctreeNode
+{
+	union
+	{
+		ui8 nodeMask;
+		struct
+		{
+			ui8 nodeMask_x0y0z0 : 1;
+			ui8 nodeMask_x1y0z0 : 1;
+			ui8 nodeMask_x0y1z0 : 1;
+			ui8 nodeMask_x1y1z0 : 1;
+			ui8 nodeMask_x0y0z1 : 1;
+			ui8 nodeMask_x1y0z1 : 1;
+			ui8 nodeMask_x0y1z1 : 1;
+			ui8 nodeMask_x1y1z1 : 1;
+		};
+	};
+	ui8 childNodeCount;
+	
+	ui32 firstChildNodeId;
+
+	inline b32 IsParentNode() const { return childNodeCount && !firstChildNodeId; }
+
+	void Clear()
+	{
+		nodeMask = childNodeCount = 0;
+		firstChildNodeId = 0;
+	}
+};
+
+// attributes of voxel, or of node prefiltered from its children (seen from far), normal is stored as direction
+// to point on face (axis, sign) of unit cube
+struct OctreeVoxel
+{
+	v4b color;
+	ui32 sign : 1;
+	ui32 axis : 2;
+	ui32 u : 15;
+	ui32 v : 14;
+};
+
+template <typename T> inline void SetVoxelNormal(T& voxel, const v3f& normal)
+{
+	v3f n = normal;
+	vectors::Abs(n);
+	const ui32 axis = n.x >= n.y ? (n.x >= n.z ? 0 : 2) : (n.y >= n.z ? 1 : 2);
+	const real major = n.Get(axis) > 0 ? n.Get(axis) : 1;
+
+	voxel.sign = normal.Get(axis) < 0;
+	voxel.axis = axis;
+	voxel.u = (ui32)((normal.Get((axis + 1) % 3) / major * .5 + .5) * 0x7fff + .5);
+	voxel.v = (ui32)((normal.Get((axis + 2) % 3) / major * .5 + .5) * 0x3fff + .5);
+}
+
+template <typename T> inline v3f GetVoxelNormal(const T& voxel)
+{
+	v3f normal;
+	normal[voxel.axis] = voxel.sign ? (real)-1 : (real)1;
+	normal[(voxel.axis + 1) % 3] = (real)voxel.u / 0x7fff * 2 - 1;
+	normal[(voxel.axis + 2) % 3] = (real)voxel.v / 0x3fff * 2 - 1;
+
+	return vectors::Normalize(normal);
+}
+
+// triangle of mesh (or mesh instance) in world space, voxel tree is built from triangles instead of meshes,
+// voxel attributes of triangle are prepared with it
+struct OctreeTriangle
+{
+	v3f v0, v1, v2;
+	OctreeVoxel voxel;
+};
+
+// objects referenced by leaf of object tree, ranges of all leaves are stored in one list
+struct OctreeLeaf
+{
+	ui32 firstObjectId;
+	ui32 objectCount;
+};
+
+// subtree built by any worker, candidate objects are copied to task so it does not depend on worker which created it
+struct OctreeBuildTask
+{
+	AACell cell;
+	ui32 depth;
+	array_of<ObjectId> objectIds;
+	array_of<AACell> objectCells;
+
+	// subtree root in node list of worker which built it
+	ui32 workerId, nodeId;
+};
+
+// subtrees built on one thread, they are merged to single tree when all tasks are done
+struct OctreeBuildWorker
+{
+	list_of<OctreeNode> nodes;
+	list_of<OctreeLeaf> leaves;
+	list_of<ObjectId> leafObjectIds;
+	// voxel attributes of children of parent nodes, childVoxelIds are parallel to nodes
+	list_of<OctreeVoxel> voxels;
+	list_of<ui32> childVoxelIds;
+
+	// candidate objects of nodes under construction
+	list_of<ObjectId> objectIds;
+	list_of<AACell> objectCells;
+
+	// own tasks are taken from the end, other workers steal the oldest (biggest) ones from firstTaskId
+	list_of<ui32> taskIds;
+	uint firstTaskId;
+};
+
+DLL_EXPORT_ARRAY_OF(OctreeNode);
+DLL_EXPORT_LIST_OF(OctreeNode);
+DLL_EXPORT_ARRAY_OF(OctreeVoxel);
+DLL_EXPORT_LIST_OF(OctreeVoxel);
+DLL_EXPORT_ARRAY_OF(OctreeTriangle);
+DLL_EXPORT_LIST_OF(OctreeTriangle);
+DLL_EXPORT_ARRAY_OF(OctreeLeaf);
+DLL_EXPORT_LIST_OF(OctreeLeaf);
+DLL_EXPORT_ARRAY_OF(OctreeBuildTask);
+DLL_EXPORT_LIST_OF(OctreeBuildTask);
+DLL_EXPORT_ARRAY_OF(OctreeBuildWorker);
+DLL_EXPORT_ARRAY_OF(ui32);
+DLL_EXPORT_LIST_OF(ui32);
+
+
+class MemoryManager;
+class Mutex;
+struct Ray;
+struct HitResult;
+struct Objects;
+struct AthenaStorage;
+
+class DLL_EXPORT Octree
+{
+public:
+
+	void Initialize(Objects* objects, MemoryManager* memoryManagerInstance);
+	void Destroy(MemoryManager* memoryManagerInstance);
+	// constructs new tree, existing one is kept when nothing moved (sceneChanged)
+	// with octreeObjectLeaves leaves reference objects and rays hit the objects instead of voxels, otherwise
+	// meshes are voxelized by their triangles
+	// voxel traversal stops at nodes smaller than voxelLodFraction of ray footprint
+	bool Update(array_of<std::thread>& threads, ui32 maxDepth, bool sceneChanged, AthenaStorage* athenaStorage);
+
+	void Hit(const Ray& ray, HitResult& hitResult) const;
+	bool Collide(const Ray& ray, real from = EPSILON, real to = _INFINITY, const ObjectId* objectIdToSkip = null) const;
+
+	// constructed tree stored in scene cache, reading fails when cached tree does not fit current objects
+	uint GetCacheSize() const;
+	void WriteCache(ui8* memory) const;
+	bool ReadCache(const ui8* memory, uint size);
+
+	uint GetCurrentNodeCount() const { return currentNumOfNodesUsed; }
+
+	// voxel tree is converted to SVO, voxels are one level below currentDepth (root node is level 0)
+	const list_of<OctreeNode>& GetNodes() const { return nodes; }
+	const AACell& GetRootCell() const { return rootCell; }
+	uint GetCurrentDepth() const { return currentDepth; }
+	bool HasObjectLeaves() const { return currentObjectLeaves != 0; }
+	// attributes of children of node are stored from childVoxelIds[nodeId] (in order of node mask bits)
+	const list_of<OctreeVoxel>& GetVoxels() const { return voxels; }
+	const list_of<ui32>& GetChildVoxelIds() const { return childVoxelIds; }
+	// changes whenever tree is constructed or loaded
+	ui64 GetBuildNumber() const { return numOfTreesConstructed + numOfTreesLoaded; }
+
+private:
+
+	// front to back traversal (Revelles et al.), t0/t1 are distances of node slabs along ray
+	bool HitNode(const Ray& ray, ui32 nodeId, const AACell& nodeCell,
+		const real* t0, const real* t1, HitResult& hitResult) const;
+	bool CollideNode(const Ray& ray, uint32 nodeId, const AACell& nodeCell,
+		const real* t0, const real* t1, real from, real to, const ObjectId* objectIdToSkip) const;
+
+	static bool HitVoxel(const Ray& ray, const real* t0, const real* t1, HitResult& hitResult);
+	void SetVoxelHit(ui32 nodeId, ui32 position, HitResult& hitResult) const;
+	void HitLeaf(const Ray& ray, ui32 leafId, HitResult& hitResult) const;
+	bool CollideLeaf(const Ray& ray, ui32 leafId, real from, real to, const ObjectId* objectIdToSkip) const;
+
+	void ShowStats();
+
+	void UpdateRootCell(bool objectLeaves);
+	// world space triangles of meshes and mesh instances, only voxel tree uses them
+	void UpdateTriangles();
+	// attributes of interior nodes are averaged from their children (voxels are filled during construction)
+	void FilterVoxels();
+	void GetObjectVoxel(const ObjectId& objectId, const AACell& voxelCell, OctreeVoxel& voxel) const;
+
+	// work stealing construction, workers take tasks until none is left (pendingTaskCount)
+	void ProcessTasks(ui32 workerId);
+	bool TakeTask(ui32 workerId, OctreeBuildTask& task, ui32& taskId);
+	void ProcessTask(ui32 workerId, ui32 taskId, OctreeBuildTask& task);
+	ui32 CreateTask(ui32 workerId, const AACell& cell, ui32 depth, uint firstObjectId, uint objectCount);
+	// copies subtrees of all workers to nodes, children are stored after their parent (as with serial construction)
+	void StitchNode(ui32 nodeId, ui32 workerId, ui32 workerNodeId);
+
+	// objects overlapping node are range of worker objectIds (with world cells in objectCells),
+	// child ranges are appended behind it, leaves are created only for object tree
+	void ProcessNode(ui32 workerId, const AACell& nodeCell, ui32 nodeId, uint firstObjectId, uint objectCount,
+		ui32 maxDepth);
+	
+	// attributes of voxel are taken from the first overlapping object, returns false when voxel is empty
+	bool GetVoxel(const list_of<ObjectId>& objectIds, const list_of<AACell>& objectCells,
+		uint firstObjectId, uint objectCount, const AACell& voxelCell, OctreeVoxel& voxel) const;
+	bool IsObjectInNode(const ObjectId& objectId, const AACell& objectCell, const AACell& nodeCell,
+		bool objectLeaves) const;
+	bool GetObjectCell(const ObjectId& objectId, AACell& objectCell) const;
+	ui64 GetTotalNodeCount(ui32 depth);
+
+private:
+
+	// statistics
+	ui64 totalThreadsUsed;
+	ui64 totalTasksUsed;
+	ui64 numOfNodesUsed;
+	ui64 numOfEmptyNodes;
+
+	ui64 numOfObjectsUsed;
+	ui64 numOfLeafObjectsUsed;
+	ui64 numOfTrianglesUsed;
+	ui64 numOfTreesConstructed;
+	ui64 numOfTreesLoaded;
+	ui64 depthSum;
+
+	uint currentDepth, currentMaxDepth, currentMinDepth, currentNumOfNodesUsed, currentNumOfObjects;
+	ui64 currentObjectsVersion; // objects->version of constructed tree
+	b32 currentObjectLeaves;
+
+	// main tree properties
+	AACell rootCell;
+	list_of<OctreeNode> nodes;
+	// leaves of object tree, ranges of leafObjectIds
+	list_of<OctreeLeaf> leaves;
+	list_of<ObjectId> leafObjectIds;
+	// prefiltered attributes of voxel tree
+	list_of<OctreeVoxel> voxels;
+	list_of<ui32> childVoxelIds;
+	real currentLodFraction;
+	// triangles are referenced by ObjectType::Triangle object ids during construction of voxel tree
+	list_of<OctreeTriangle> triangles;
+
+	// parallel construction
+	array_of<OctreeBuildWorker> workers;
+	list_of<OctreeBuildTask> tasks;
+	ui32 workerCount;
+	uint pendingTaskCount;
+	Mutex* tasksMutex;
+
+	Objects* objects;
+	MemoryManager* memoryManagerInstance;
+	static ui8 octreeNodePositions[8];
+};
+
+#endif __octree_h
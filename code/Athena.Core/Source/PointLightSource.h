@@ -1,11 +1,11 @@
-#ifndef __point_sphere_light_h
-#define __point_sphere_light_h
-
-#include "Light.h"
-
-
-struct PointLightSource : Light
-{
-};
-
-#endif __point_sphere_light_h
+#ifndef __point_sphere_light_h
+#define __point_sphere_light_h
+
+#include "Light.h"
+
+
+struct PointLightSource : Light
+{
+};
+
+#endif __point_sphere_light_h
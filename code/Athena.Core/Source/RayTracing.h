@@ -1,27 +1,29 @@
-#ifndef __ray_tracing_h
-#define __ray_tracing_h
-
-#include "Object.h"
-#include "TypeDefs.h"
-#include "Vectors.h"
-
-
-struct RayTraceResult
-{
-	v3f color;
-	v3f normal;
-	real distance;
-	ObjectId objectId;
-
-	uint testCount;
-};
-
-class BIH;
-struct Objects;
-class Octree;
-struct RenderingParameters;
-
-__device__ RayTraceResult RayTrace(const Objects& objects, const RenderingParameters& parameters, const Ray& ray,
-	const array_of<v3f>& randomDirections, const BIH* bih, const Octree* octree, ui32 depth);
-
-#endif __ray_tracing_h
+#ifndef __ray_tracing_h
+#define __ray_tracing_h
+
+#include "Object.h"
+#include "TypeDefs.h"
+#include "Vectors.h"
+
+
+struct RayTraceResult
+{
+	v3f color;
+	v3f normal;
+	real distance;
+	ObjectId objectId;
+
+	uint testCount;
+};
+
+struct Accelerators;
+struct Objects;
+struct RenderingParameters;
+
+__device__ RayTraceResult RayTrace(const Objects& objects, const RenderingParameters& parameters, const Ray& ray,
+	const array_of<v3f>& randomDirections, const Accelerators* accelerators, ui32 depth);
+// traces BIH_PACKET_SIZE coherent primary rays together
+__device__ void RayTracePacket(const Objects& objects, const RenderingParameters& parameters, const Ray* rays,
+	const array_of<v3f>& randomDirections, const Accelerators* accelerators, RayTraceResult* results);
+
+#endif __ray_tracing_h
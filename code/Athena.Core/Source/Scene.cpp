@@ -1,324 +1,607 @@
-#include "Athena.h"
-#include "Log.h"
-#include "MemoryManager.h"
-#include "Scene.h"
-
-
-Scene::Scene()
-{
-}
-
-Scene::Scene(const char* name, MemoryManager* memoryManagerInstance)
-{
-	Create(name, memoryManagerInstance);
-}
-
-Scene::~Scene()
-{
-	Destroy();
-}
-
-void Scene::Destroy()
-{
-	if (memoryManagerInstance)
-	{
-		bih.Destroy();
-		octree.Destroy(memoryManagerInstance);
-
-		sceneObjects.everything.Destroy();
-		sceneObjects.boxes.Destroy();
-		sceneObjects.planes.Destroy();
-		sceneObjects.spheres.Destroy();
-		sceneObjects.pointLights.Destroy();
-		sceneObjects.sphereLights.Destroy();
-		sceneObjects.boxLights.Destroy();
-		sceneObjects.materials.Destroy();
-
-		for (uint i = 0; i < sceneObjects.meshes.currentCount; ++i)
-		{
-			_MEM_FREE_ARRAY(memoryManagerInstance, v3f, &sceneObjects.meshes[i].vertices);
-			_MEM_FREE_ARRAY(memoryManagerInstance, v3f, &sceneObjects.meshes[i].vertexNormals);
-			_MEM_FREE_ARRAY(memoryManagerInstance, v2f, &sceneObjects.meshes[i].textureCoords);
-			_MEM_FREE_ARRAY(memoryManagerInstance, Triangle, &sceneObjects.meshes[i].triangles);
-			_MEM_FREE_ARRAY(memoryManagerInstance, Material, &sceneObjects.meshes[i].materials);
-		}
-		sceneObjects.meshes.Destroy();
-
-		rotateAroundAnimations.Destroy();
-
-		_MEM_FREE_ARRAY(memoryManagerInstance, v3f, &randomDirections);
-
-		LOG_DEBUG("Scene::Destroy [%s]", name.ptr);
-
-		_MEM_FREE_ARRAY(memoryManagerInstance, char, &name);
-		memoryManagerInstance = null;
-	}
-}
-
-void Scene::Create(const char* name, MemoryManager* memoryManagerInstance)
-{
-	this->memoryManagerInstance = memoryManagerInstance;
-
-	sceneObjects.everything.Initialize(memoryManagerInstance, "ObjectId");
-	sceneObjects.boxes.Initialize(memoryManagerInstance, "Box");
-	sceneObjects.planes.Initialize(memoryManagerInstance, "Plane");
-	sceneObjects.spheres.Initialize(memoryManagerInstance, "Sphere");
-	sceneObjects.pointLights.Initialize(memoryManagerInstance, "PointLightSource");
-	sceneObjects.sphereLights.Initialize(memoryManagerInstance, "SphereLightSource");
-	sceneObjects.boxLights.Initialize(memoryManagerInstance, "BoxLightSource");
-	sceneObjects.meshes.Initialize(memoryManagerInstance, "Mesh");
-	sceneObjects.materials.Initialize(memoryManagerInstance, "Material");
-	rotateAroundAnimations.Initialize(memoryManagerInstance, "RotateAround");
-
-	memset(sceneObjects.counts, 0, sizeof(*sceneObjects.counts) * ObjectType::Count);
-
-	this->name = _MEM_ALLOC_STRING(memoryManagerInstance, name);
-
-	bih.Initialize(&sceneObjects, memoryManagerInstance);
-	octree.Initialize(&sceneObjects, memoryManagerInstance);
-
-	randomDirections = _MEM_ALLOC_ARRAY(memoryManagerInstance, v3f, 1024);
-	for (uint i = 0; i < randomDirections.count; ++i)
-		vectors::RandomSpherePoint3f(randomDirections[i]);
-}
-
-bool Scene::Update(real timeElapsed, AthenaStorage* athenaStorage, ui32 octreeDepth, ui32 bihDepth, ui32 bihMaxObjects)
-{
-	bool changed = false;
-
-	// update animations
-	for (uint i = 0; i < rotateAroundAnimations.currentCount; i++)
-	{
-		RotateAround& animation = rotateAroundAnimations[i];
-		vectors::RotatePointAround(*animation.center, animation.axis, timeElapsed * animation.speed, *animation.point);
-	}
-	if (rotateAroundAnimations.currentCount)
-		changed = true;
-
-	// update dynamic meshes
-	if (changed)
-		for (uint i = 0; i < sceneObjects.meshes.currentCount; ++i)
-			sceneObjects.meshes[i].Update();
-
-	//if (changed || !athenaStorage->frame.count)
-	{
-		// update scene acceleration structures
-		
-		octree.Update(
-			athenaStorage->renderingParameters.multiThreadedOctreeUpdate ?
-			athenaStorage->threads : array_of<std::thread>(),
-			octreeDepth, athenaStorage);
-	
-		bih.Update(bihMaxObjects, bihDepth, athenaStorage);
-	}
-
-	// generate new random directions each frame
-	for (uint i = 0; i < randomDirections.count; ++i)
-		vectors::RandomSpherePoint3f(randomDirections[i]);
-
-	return changed;
-}
-
-void Scene::AddObjectId(ObjectId objectId)
-{
-	sceneObjects.everything.Add(objectId);
-}
-
-uint Scene::AddBox(const v3f& position, const v3f& size, ui32 materialId)
-{
-	return AddBox(position.x, position.y, position.z, size.x, size.y, size.z, materialId);
-}
-
-uint Scene::AddBox(real x, real y, real z, real width, real height, real depth, ui32 materialId)
-{
-	Box newBox;
-	newBox.position.Set(x, y, z);
-	newBox.cell.minCorner.Set(-width/2, -height/2, -depth/2);
-	newBox.cell.maxCorner.Set(width/2, height/2, depth/2);
-	newBox.materialIndex = materialId;
-
-	auto index = sceneObjects.boxes.Add(newBox);
-	AddObjectId(sceneObjects.boxes[index].id.Set(ObjectType::Box, index));
-	
-	sceneObjects.counts[ObjectType::Box] = (uint32)sceneObjects.boxes.currentCount;
-	return index;
-}
-
-uint Scene::AddPlane(const v3f& position, const v3f& normal, ui32 materialId)
-{
-	return AddPlane(position.x, position.y, position.z, normal.x, normal.y, normal.z, materialId);
-}
-
-uint Scene::AddPlane(real x, real y, real z, real normalx, real normaly, real normalz, ui32 materialId)
-{
-	Plane newPlane;
-	newPlane.position.Set(x, y, z);
-	newPlane.normal.Set(normalx, normaly, normalz);
-	vectors::Normalize(newPlane.normal);
-	newPlane.materialIndex = materialId;
-
-	auto index = sceneObjects.planes.Add(newPlane);
-	AddObjectId(sceneObjects.planes[index].id.Set(ObjectType::Plane, index));
-
-	sceneObjects.counts[ObjectType::Plane] = (uint32)sceneObjects.planes.currentCount;
-	return index;
-}
-
-uint Scene::AddSphere(const v3f& position, real radius, ui32 materialId)
-{
-	return AddSphere(position.x, position.y, position.z, radius, materialId);
-}
-
-uint Scene::AddSphere(real x, real y, real z, real radius, ui32 materialId)
-{
-	Sphere newSphere;
-	newSphere.position.Set(x, y, z);
-	newSphere.radius = radius;
-	newSphere.materialIndex = materialId;
-	newSphere.UpdateCell();
-
-	auto index = sceneObjects.spheres.Add(newSphere);
-	AddObjectId(sceneObjects.spheres[index].id.Set(ObjectType::Sphere, index));
-
-	sceneObjects.counts[ObjectType::Sphere] = (uint32)sceneObjects.spheres.currentCount;
-	return index;
-}
-
-uint Scene::AddPointLightSource(const v3f& position, real intensity, const v3f& color)
-{
-	return AddPointLightSource(position.x, position.y, position.z, intensity, color.x, color.y, color.z);
-}
-
-uint Scene::AddPointLightSource(real x, real y, real z, real intensity,
-	real r, real g, real b)
-{
-	PointLightSource newLight;
-	newLight.position.Set(x, y, z);
-	newLight.intensity = intensity;
-	newLight.color.Set(r, g, b);
-
-	auto index = sceneObjects.pointLights.Add(newLight);
-	AddObjectId(sceneObjects.pointLights[index].id.Set(ObjectType::PointLightSource, index));
-
-	sceneObjects.counts[ObjectType::PointLightSource] = (uint32)sceneObjects.pointLights.currentCount;
-	return index;
-}
-
-uint Scene::AddSphereLightSource(const v3f& position, real radius, real intensity, const v3f& color)
-{
-	return AddSphereLightSource(position.x, position.y, position.z, radius, intensity, color.x, color.y, color.z);
-}
-
-uint Scene::AddSphereLightSource(real x, real y, real z, real radius, real intensity,
-	real r, real g, real b)
-{
-	SphereLightSource newLight;
-	newLight.position.Set(x, y, z);
-	newLight.radius = radius;
-	newLight.intensity = intensity;
-	newLight.color.Set(r, g, b);
-	newLight.lightPointCount = 8;
-	newLight.UpdateCell();
-
-	auto index = sceneObjects.sphereLights.Add(newLight);
-	AddObjectId(sceneObjects.sphereLights[index].id.Set(ObjectType::SphereLightSource, index));
-
-	sceneObjects.counts[ObjectType::SphereLightSource] = (uint32)sceneObjects.sphereLights.currentCount;
-	return index;
-}
-
-uint Scene::AddBoxLightSource(const v3f& position, const v3f& size, real intensity, const v3f& color)
-{
-	return AddBoxLightSource(position.x, position.y, position.z, size.x, size.y, size.z, intensity, 
-		color.x, color.y, color.z);
-}
-
-uint Scene::AddBoxLightSource(real x, real y, real z, real width, real height, real depth, real intensity,
-	real r, real g, real b)
-{
-	BoxLightSource newLight;
-	newLight.position.Set(x, y, z);
-	newLight.cell.minCorner.Set(-width/2, -height/2, -depth/2);
-	newLight.cell.maxCorner.Set(width/2, height/2, depth/2);
-	newLight.intensity = intensity;
-	newLight.color.Set(r, g, b);
-	
-	auto index = sceneObjects.boxLights.Add(newLight);
-	AddObjectId(sceneObjects.boxLights[index].id.Set(ObjectType::BoxLightSource, index));
-	
-	sceneObjects.counts[ObjectType::BoxLightSource] = (uint32)sceneObjects.boxLights.currentCount;
-	return index;
-}
-
-uint Scene::AddRotationAroundAnimation(v3f* point, v3f center, v3f axis, real speed)
-{
-	RotateAround animation;
-	animation.point = point;
-	animation.localCenter = center;
-	animation.center = &animation.localCenter;
-	animation.axis = axis;
-	animation.speed = speed;
-	animation.point = point;
-
-	return rotateAroundAnimations.Add(animation);
-}
-
-uint Scene::AddMesh(Mesh& mesh)
-{
-	mesh.Update(true);
-
-	auto index = sceneObjects.meshes.Add(mesh);
-	mesh.vertices.ptr = null;
-	mesh.vertexNormals.ptr = null;
-	mesh.textureCoords.ptr = null;
-	mesh.triangles.ptr = null;
-	mesh.materials.ptr = null;
-
-	// TODO add mesh triangles to scene triangle list ?
-
-	AddObjectId(sceneObjects.meshes[index].id.Set(ObjectType::Mesh, index));
-	sceneObjects.counts[ObjectType::Mesh] = (uint32)sceneObjects.meshes.currentCount;
-	return index;
-}
-
-uint Scene::AddMesh(v3f position, const char* meshFileName)
-{
-	Mesh newMesh;
-	if (LoadWavefrontObjectFromFile(meshFileName, memoryManagerInstance, newMesh))
-	{
-		newMesh.position = position;
-		newMesh.UpdateCell();
-
-		auto index = sceneObjects.meshes.Add(newMesh);
-		AddObjectId(sceneObjects.meshes[index].id.Set(ObjectType::Mesh, index));
-
-		sceneObjects.counts[ObjectType::Mesh] = (uint32)sceneObjects.meshes.currentCount;
-		return index;
-	}
-	
-	return 0;
-}
-
-ui32 Scene::AddMaterial(const v3f& diffuseColor, const v3f& specularColor,
-	real shininess, real reflection, real refraction, real refractionIndex)
-{
-	return AddMaterial(
-		diffuseColor.x, diffuseColor.y, diffuseColor.z, 
-		specularColor.x, specularColor.y, specularColor.z,
-		shininess, reflection, refraction, refractionIndex);
-}
-
-ui32 Scene::AddMaterial(real diffuseR, real diffuseG, real diffuseB,
-	real specularR, real specularG, real specularB,
-	real shininess, real reflection, real refraction, real refractionIndex)
-{
-	Material newMaterial;
-	newMaterial.diffuseColor.Set(diffuseR, diffuseG, diffuseB);
-	newMaterial.specularColor.Set(specularR, specularG, specularB);
-	newMaterial.reflection = reflection;
-	newMaterial.refraction = refraction;
-	newMaterial.refractionIndex = refractionIndex;
-	newMaterial.shininess = shininess;
-	
-	return (ui32)sceneObjects.materials.Add(newMaterial);
-}
+#include "Athena.h"
+#include "Hash.h"
+#include "Log.h"
+#include "MemoryManager.h"
+#include "Scene.h"
+#include "StringHelpers.h"
+#include "Win32.h"
+
+
+// header of scene cache file, followed by BIH and Octree sections
+struct SceneCacheHeader
+{
+	ui32 magic;
+	ui32 version;
+	ui64 hash;
+
+	ui64 bihSize;
+	ui64 octreeSize;
+};
+
+// everything cached trees are built from (geometry, transforms, materials), not only bounds of objects
+ui64 HashObject(ui64 hash, const Box& box)
+{
+	return HashData(hash, &box.materialIndex, sizeof(ui32));
+}
+
+ui64 HashObject(ui64 hash, const Sphere& sphere)
+{
+	hash = HashData(hash, &sphere.radius, sizeof(real));
+	return HashData(hash, &sphere.materialIndex, sizeof(ui32));
+}
+
+ui64 HashObject(ui64 hash, const Mesh& mesh)
+{
+	hash = HashData(hash, &mesh.vertices.count, sizeof(uint));
+	hash = HashData(hash, mesh.vertices.ptr, mesh.vertices.count * sizeof(v3f));
+
+	// triangle normals are computed from vertices
+	hash = HashData(hash, &mesh.triangles.count, sizeof(uint));
+	for (uint i = 0; i < mesh.triangles.count; ++i)
+	{
+		hash = HashData(hash, &mesh.triangles[i].v, sizeof(v3i));
+		hash = HashData(hash, &mesh.triangles[i].materialIndex, sizeof(int));
+	}
+
+	hash = HashData(hash, &mesh.materials.count, sizeof(uint));
+	return HashData(hash, mesh.materials.ptr, mesh.materials.count * sizeof(Material));
+}
+
+ui64 HashObject(ui64 hash, const MeshInstance& meshInstance)
+{
+	hash = HashData(hash, &meshInstance.meshIndex, sizeof(ui32));
+	hash = HashData(hash, &meshInstance.materialIndex, sizeof(ui32));
+	return HashData(hash, meshInstance.transform.box, sizeof(meshInstance.transform.box));
+}
+
+ui64 HashObject(ui64 hash, const SphereLightSource& sphereLight)
+{
+	hash = HashData(hash, &sphereLight.color, sizeof(v3f));
+	hash = HashData(hash, &sphereLight.intensity, sizeof(real));
+	return HashData(hash, &sphereLight.radius, sizeof(real));
+}
+
+ui64 HashObject(ui64 hash, const BoxLightSource& boxLight)
+{
+	hash = HashData(hash, &boxLight.color, sizeof(v3f));
+	return HashData(hash, &boxLight.intensity, sizeof(real));
+}
+
+template <typename T> ui64 HashObjectList(ui64 hash, const list_of<T>& objectList)
+{
+	hash = HashData(hash, &objectList.currentCount, sizeof(uint));
+	for (uint i = 0; i < objectList.currentCount; ++i)
+	{
+		hash = HashData(hash, &objectList[i].position, sizeof(v3f));
+		hash = HashData(hash, &objectList[i].cell, sizeof(AACell));
+		hash = HashObject(hash, objectList[i]);
+	}
+
+	return hash;
+}
+
+void DestroyMeshes(MemoryManager* memoryManagerInstance, list_of<Mesh>& meshes)
+{
+	for (uint i = 0; i < meshes.currentCount; ++i)
+	{
+		DestroyMeshTree(memoryManagerInstance, meshes[i]);
+		_MEM_FREE_ARRAY(memoryManagerInstance, v3f, &meshes[i].vertices);
+		_MEM_FREE_ARRAY(memoryManagerInstance, v3f, &meshes[i].vertexNormals);
+		_MEM_FREE_ARRAY(memoryManagerInstance, v2f, &meshes[i].textureCoords);
+		_MEM_FREE_ARRAY(memoryManagerInstance, Triangle, &meshes[i].triangles);
+		_MEM_FREE_ARRAY(memoryManagerInstance, Material, &meshes[i].materials);
+	}
+	meshes.Destroy();
+}
+
+Scene::Scene()
+{
+}
+
+Scene::Scene(const char* name, MemoryManager* memoryManagerInstance)
+{
+	Create(name, memoryManagerInstance);
+}
+
+Scene::~Scene()
+{
+	Destroy();
+}
+
+void Scene::Destroy()
+{
+	if (memoryManagerInstance)
+	{
+#ifdef SCENE_CACHE_ENABLED
+		// trees of animated scene are different on each start
+		if (!rotateAroundAnimations.currentCount)
+			SaveCache();
+#endif
+
+		bih.Destroy(memoryManagerInstance);
+		octree.Destroy(memoryManagerInstance);
+		svo.Destroy(memoryManagerInstance);
+		grid.Destroy(memoryManagerInstance);
+		kdTree.Destroy(memoryManagerInstance);
+
+		sceneObjects.everything.Destroy();
+		sceneObjects.boxes.Destroy();
+		sceneObjects.planes.Destroy();
+		sceneObjects.spheres.Destroy();
+		sceneObjects.pointLights.Destroy();
+		sceneObjects.sphereLights.Destroy();
+		sceneObjects.boxLights.Destroy();
+		sceneObjects.materials.Destroy();
+
+		DestroyMeshes(memoryManagerInstance, sceneObjects.meshes);
+		DestroyMeshes(memoryManagerInstance, sceneObjects.sharedMeshes);
+		sceneObjects.meshInstances.Destroy();
+
+		rotateAroundAnimations.Destroy();
+
+		_MEM_FREE_ARRAY(memoryManagerInstance, v3f, &randomDirections);
+
+		LOG_DEBUG("Scene::Destroy [%s]", name.ptr);
+
+		_MEM_FREE_ARRAY(memoryManagerInstance, char, &name);
+		memoryManagerInstance = null;
+	}
+}
+
+void Scene::Create(const char* name, MemoryManager* memoryManagerInstance)
+{
+	this->memoryManagerInstance = memoryManagerInstance;
+
+	sceneObjects.everything.Initialize(memoryManagerInstance, "ObjectId");
+	sceneObjects.boxes.Initialize(memoryManagerInstance, "Box");
+	sceneObjects.planes.Initialize(memoryManagerInstance, "Plane");
+	sceneObjects.spheres.Initialize(memoryManagerInstance, "Sphere");
+	sceneObjects.pointLights.Initialize(memoryManagerInstance, "PointLightSource");
+	sceneObjects.sphereLights.Initialize(memoryManagerInstance, "SphereLightSource");
+	sceneObjects.boxLights.Initialize(memoryManagerInstance, "BoxLightSource");
+	sceneObjects.meshes.Initialize(memoryManagerInstance, "Mesh");
+	sceneObjects.sharedMeshes.Initialize(memoryManagerInstance, "Mesh");
+	sceneObjects.meshInstances.Initialize(memoryManagerInstance, "MeshInstance");
+	sceneObjects.materials.Initialize(memoryManagerInstance, "Material");
+	rotateAroundAnimations.Initialize(memoryManagerInstance, "RotateAround");
+
+	memset(sceneObjects.counts, 0, sizeof(*sceneObjects.counts) * ObjectType::Count);
+	sceneObjects.version = 0;
+
+	this->name = _MEM_ALLOC_STRING(memoryManagerInstance, name);
+
+	bih.Initialize(&sceneObjects, memoryManagerInstance);
+	octree.Initialize(&sceneObjects, memoryManagerInstance);
+	svo.Initialize(memoryManagerInstance);
+	grid.Initialize(&sceneObjects, memoryManagerInstance);
+	kdTree.Initialize(&sceneObjects, memoryManagerInstance);
+	cacheChecked = false;
+
+	accelerators.bih = &bih;
+	accelerators.octree = &octree;
+	accelerators.svo = &svo;
+	accelerators.grid = &grid;
+	accelerators.kdTree = &kdTree;
+
+	randomDirections = _MEM_ALLOC_ARRAY(memoryManagerInstance, v3f, 1024);
+	for (uint i = 0; i < randomDirections.count; ++i)
+		vectors::RandomSpherePoint3f(randomDirections[i]);
+}
+
+bool Scene::Update(real timeElapsed, AthenaStorage* athenaStorage, ui32 octreeDepth, ui32 bihDepth, ui32 bihMaxObjects)
+{
+	bool changed = false;
+
+	// update animations
+	for (uint i = 0; i < rotateAroundAnimations.currentCount; i++)
+	{
+		RotateAround& animation = rotateAroundAnimations[i];
+		vectors::RotatePointAround(*animation.center, animation.axis, timeElapsed * animation.speed, *animation.point);
+	}
+	if (rotateAroundAnimations.currentCount)
+		changed = true;
+
+	// update dynamic meshes
+	if (changed)
+	{
+		for (uint i = 0; i < sceneObjects.meshes.currentCount; ++i)
+			sceneObjects.meshes[i].Update();
+
+		for (uint i = 0; i < sceneObjects.sharedMeshes.currentCount; ++i)
+			sceneObjects.sharedMeshes[i].Update();
+
+		for (uint i = 0; i < sceneObjects.meshInstances.currentCount; ++i)
+		{
+			MeshInstance& instance = sceneObjects.meshInstances[i];
+			if (sceneObjects.sharedMeshes[instance.meshIndex].dynamic)
+				instance.Update(sceneObjects.sharedMeshes[instance.meshIndex]);
+		}
+	}
+
+#ifdef SCENE_CACHE_ENABLED
+	// objects are added after scene is created, so cache can be checked only before first update
+	if (!cacheChecked)
+	{
+		cacheChecked = true;
+		LoadCache();
+	}
+#endif
+
+	//if (changed || !athenaStorage->frame.count)
+	{
+		// update scene acceleration structures, trees are reused when nothing changed
+		
+		octree.Update(
+			athenaStorage->renderingParameters.multiThreadedOctreeUpdate ?
+			athenaStorage->threads : array_of<std::thread>(),
+			octreeDepth, changed, athenaStorage);
+
+		// voxels of octree are converted to svo block, streamed block is mapped from file <scene name>.svo
+		char svoFileName[256];
+		sprintf(svoFileName, "%s.svo", name.ptr);
+		svo.Update(&octree, athenaStorage, svoFileName);
+	
+		bih.Update(
+			athenaStorage->renderingParameters.multiThreadedBihUpdate ?
+			athenaStorage->threads : array_of<std::thread>(),
+			bihMaxObjects, bihDepth, changed, athenaStorage);
+
+		grid.Update(
+			athenaStorage->renderingParameters.multiThreadedGridUpdate ?
+			athenaStorage->threads : array_of<std::thread>(),
+			changed, athenaStorage);
+
+		kdTree.Update(changed, athenaStorage);
+	}
+
+	// generate new random directions each frame
+	for (uint i = 0; i < randomDirections.count; ++i)
+		vectors::RandomSpherePoint3f(randomDirections[i]);
+
+	return changed;
+}
+
+void Scene::AddObjectId(ObjectId objectId)
+{
+	sceneObjects.everything.Add(objectId);
+	++sceneObjects.version;
+}
+
+ui64 Scene::GetCacheHash() const
+{
+	// order of everything is changed by BIH, so only count is used
+	ui64 hash = HashData(HASH_SEED, &sceneObjects.everything.currentCount, sizeof(uint));
+
+	hash = HashObjectList<Box>(hash, sceneObjects.boxes);
+	hash = HashObjectList<Sphere>(hash, sceneObjects.spheres);
+	hash = HashObjectList<Mesh>(hash, sceneObjects.meshes);
+	hash = HashObjectList<Mesh>(hash, sceneObjects.sharedMeshes);
+	hash = HashObjectList<MeshInstance>(hash, sceneObjects.meshInstances);
+	hash = HashObjectList<SphereLightSource>(hash, sceneObjects.sphereLights);
+	hash = HashObjectList<BoxLightSource>(hash, sceneObjects.boxLights);
+
+	hash = HashData(hash, &sceneObjects.materials.currentCount, sizeof(uint));
+	hash = HashData(hash, sceneObjects.materials.array.ptr, sceneObjects.materials.currentCount * sizeof(Material));
+
+	return hash;
+}
+
+bool Scene::LoadCache()
+{
+	char fileName[256];
+	sprintf(fileName, "%s.cache", name.ptr);
+
+	win32_mapped_file file = Win32MapFile(fileName);
+	if (!file.memory)
+		return false;
+
+	bool result = false;
+
+	const SceneCacheHeader* header = (const SceneCacheHeader*)file.memory;
+	if (file.memorySize < sizeof(SceneCacheHeader) ||
+		header->magic != SCENE_CACHE_MAGIC || header->version != SCENE_CACHE_VERSION ||
+		file.memorySize != sizeof(SceneCacheHeader) + header->bihSize + header->octreeSize)
+	{
+		LOG_TL(LogLevel::Warning, "Scene::LoadCache [%s is not valid]", fileName);
+	}
+	else if (header->hash != GetCacheHash())
+	{
+		LOG_TL(LogLevel::Info, "Scene::LoadCache [%s is outdated]", fileName);
+	}
+	else
+	{
+		// sections which do not fit current objects are constructed again
+		const ui8* memory = (const ui8*)file.memory + sizeof(SceneCacheHeader);
+		const bool bihLoaded = bih.ReadCache(memory, header->bihSize);
+		const bool octreeLoaded = octree.ReadCache(memory + header->bihSize, header->octreeSize);
+
+		LOG_TL(LogLevel::Info, "Scene::LoadCache [%s; bih: %s; octree: %s]", fileName,
+			bihLoaded ? "loaded" : "no", octreeLoaded ? "loaded" : "no");
+
+		result = bihLoaded || octreeLoaded;
+	}
+
+	Win32UnmapFile(&file);
+	return result;
+}
+
+void Scene::SaveCache()
+{
+	SceneCacheHeader header;
+	header.magic = SCENE_CACHE_MAGIC;
+	header.version = SCENE_CACHE_VERSION;
+	header.hash = GetCacheHash();
+	header.bihSize = bih.GetCacheSize();
+	header.octreeSize = octree.GetCacheSize();
+
+	const uint size = sizeof(SceneCacheHeader) + header.bihSize + header.octreeSize;
+
+	array_of<ui8> memory = _MEM_ALLOC_ARRAY(memoryManagerInstance, ui8, size);
+	memcpy(memory.ptr, &header, sizeof(SceneCacheHeader));
+	bih.WriteCache(memory.ptr + sizeof(SceneCacheHeader));
+	octree.WriteCache(memory.ptr + sizeof(SceneCacheHeader) + header.bihSize);
+
+	char fileName[256];
+	sprintf(fileName, "%s.cache", name.ptr);
+
+	char tmpBuffer[256] = {};
+	if (Win32WriteFile(fileName, size, memory.ptr))
+	{
+		LOG_TL(LogLevel::Info, "Scene::SaveCache [%s; %s]", fileName,
+			Common::Strings::GetMemSizeString(tmpBuffer, size));
+	}
+	else
+	{
+		LOG_TL(LogLevel::Warning, "Scene::SaveCache [%s could not be written]", fileName);
+	}
+
+	_MEM_FREE_ARRAY(memoryManagerInstance, ui8, &memory);
+}
+
+uint Scene::AddBox(const v3f& position, const v3f& size, ui32 materialId)
+{
+	return AddBox(position.x, position.y, position.z, size.x, size.y, size.z, materialId);
+}
+
+uint Scene::AddBox(real x, real y, real z, real width, real height, real depth, ui32 materialId)
+{
+	Box newBox;
+	newBox.position.Set(x, y, z);
+	newBox.cell.minCorner.Set(-width/2, -height/2, -depth/2);
+	newBox.cell.maxCorner.Set(width/2, height/2, depth/2);
+	newBox.materialIndex = materialId;
+
+	auto index = sceneObjects.boxes.Add(newBox);
+	AddObjectId(sceneObjects.boxes[index].id.Set(ObjectType::Box, index));
+	
+	sceneObjects.counts[ObjectType::Box] = (uint32)sceneObjects.boxes.currentCount;
+	return index;
+}
+
+uint Scene::AddPlane(const v3f& position, const v3f& normal, ui32 materialId)
+{
+	return AddPlane(position.x, position.y, position.z, normal.x, normal.y, normal.z, materialId);
+}
+
+uint Scene::AddPlane(real x, real y, real z, real normalx, real normaly, real normalz, ui32 materialId)
+{
+	Plane newPlane;
+	newPlane.position.Set(x, y, z);
+	newPlane.normal.Set(normalx, normaly, normalz);
+	vectors::Normalize(newPlane.normal);
+	newPlane.materialIndex = materialId;
+
+	auto index = sceneObjects.planes.Add(newPlane);
+	AddObjectId(sceneObjects.planes[index].id.Set(ObjectType::Plane, index));
+
+	sceneObjects.counts[ObjectType::Plane] = (uint32)sceneObjects.planes.currentCount;
+	return index;
+}
+
+uint Scene::AddSphere(const v3f& position, real radius, ui32 materialId)
+{
+	return AddSphere(position.x, position.y, position.z, radius, materialId);
+}
+
+uint Scene::AddSphere(real x, real y, real z, real radius, ui32 materialId)
+{
+	Sphere newSphere;
+	newSphere.position.Set(x, y, z);
+	newSphere.radius = radius;
+	newSphere.materialIndex = materialId;
+	newSphere.UpdateCell();
+
+	auto index = sceneObjects.spheres.Add(newSphere);
+	AddObjectId(sceneObjects.spheres[index].id.Set(ObjectType::Sphere, index));
+
+	sceneObjects.counts[ObjectType::Sphere] = (uint32)sceneObjects.spheres.currentCount;
+	return index;
+}
+
+uint Scene::AddPointLightSource(const v3f& position, real intensity, const v3f& color)
+{
+	return AddPointLightSource(position.x, position.y, position.z, intensity, color.x, color.y, color.z);
+}
+
+uint Scene::AddPointLightSource(real x, real y, real z, real intensity,
+	real r, real g, real b)
+{
+	PointLightSource newLight;
+	newLight.position.Set(x, y, z);
+	newLight.intensity = intensity;
+	newLight.color.Set(r, g, b);
+
+	auto index = sceneObjects.pointLights.Add(newLight);
+	AddObjectId(sceneObjects.pointLights[index].id.Set(ObjectType::PointLightSource, index));
+
+	sceneObjects.counts[ObjectType::PointLightSource] = (uint32)sceneObjects.pointLights.currentCount;
+	return index;
+}
+
+uint Scene::AddSphereLightSource(const v3f& position, real radius, real intensity, const v3f& color)
+{
+	return AddSphereLightSource(position.x, position.y, position.z, radius, intensity, color.x, color.y, color.z);
+}
+
+uint Scene::AddSphereLightSource(real x, real y, real z, real radius, real intensity,
+	real r, real g, real b)
+{
+	SphereLightSource newLight;
+	newLight.position.Set(x, y, z);
+	newLight.radius = radius;
+	newLight.intensity = intensity;
+	newLight.color.Set(r, g, b);
+	newLight.lightPointCount = 8;
+	newLight.UpdateCell();
+
+	auto index = sceneObjects.sphereLights.Add(newLight);
+	AddObjectId(sceneObjects.sphereLights[index].id.Set(ObjectType::SphereLightSource, index));
+
+	sceneObjects.counts[ObjectType::SphereLightSource] = (uint32)sceneObjects.sphereLights.currentCount;
+	return index;
+}
+
+uint Scene::AddBoxLightSource(const v3f& position, const v3f& size, real intensity, const v3f& color)
+{
+	return AddBoxLightSource(position.x, position.y, position.z, size.x, size.y, size.z, intensity, 
+		color.x, color.y, color.z);
+}
+
+uint Scene::AddBoxLightSource(real x, real y, real z, real width, real height, real depth, real intensity,
+	real r, real g, real b)
+{
+	BoxLightSource newLight;
+	newLight.position.Set(x, y, z);
+	newLight.cell.minCorner.Set(-width/2, -height/2, -depth/2);
+	newLight.cell.maxCorner.Set(width/2, height/2, depth/2);
+	newLight.intensity = intensity;
+	newLight.color.Set(r, g, b);
+	
+	auto index = sceneObjects.boxLights.Add(newLight);
+	AddObjectId(sceneObjects.boxLights[index].id.Set(ObjectType::BoxLightSource, index));
+	
+	sceneObjects.counts[ObjectType::BoxLightSource] = (uint32)sceneObjects.boxLights.currentCount;
+	return index;
+}
+
+uint Scene::AddRotationAroundAnimation(v3f* point, v3f center, v3f axis, real speed)
+{
+	RotateAround animation;
+	animation.point = point;
+	animation.localCenter = center;
+	animation.center = &animation.localCenter;
+	animation.axis = axis;
+	animation.speed = speed;
+	animation.point = point;
+
+	return rotateAroundAnimations.Add(animation);
+}
+
+uint Scene::AddMesh(Mesh& mesh)
+{
+	mesh.Update(true);
+
+	auto index = sceneObjects.meshes.Add(mesh);
+	mesh.vertices.ptr = null;
+	mesh.vertexNormals.ptr = null;
+	mesh.textureCoords.ptr = null;
+	mesh.triangles.ptr = null;
+	mesh.materials.ptr = null;
+
+	// scene BIH sees mesh as single object, which has its own tree over triangles
+	CreateMeshTree(memoryManagerInstance, sceneObjects.meshes[index]);
+
+	AddObjectId(sceneObjects.meshes[index].id.Set(ObjectType::Mesh, index));
+	sceneObjects.counts[ObjectType::Mesh] = (uint32)sceneObjects.meshes.currentCount;
+	return index;
+}
+
+uint Scene::AddMesh(v3f position, const char* meshFileName)
+{
+	Mesh newMesh;
+	if (LoadWavefrontObjectFromFile(meshFileName, memoryManagerInstance, newMesh))
+	{
+		newMesh.position = position;
+		newMesh.UpdateCell();
+
+		auto index = sceneObjects.meshes.Add(newMesh);
+		CreateMeshTree(memoryManagerInstance, sceneObjects.meshes[index]);
+		AddObjectId(sceneObjects.meshes[index].id.Set(ObjectType::Mesh, index));
+
+		sceneObjects.counts[ObjectType::Mesh] = (uint32)sceneObjects.meshes.currentCount;
+		return index;
+	}
+	
+	return 0;
+}
+
+uint Scene::AddSharedMesh(Mesh& mesh)
+{
+	mesh.Update(true);
+
+	auto index = sceneObjects.sharedMeshes.Add(mesh);
+	mesh.vertices.ptr = null;
+	mesh.vertexNormals.ptr = null;
+	mesh.textureCoords.ptr = null;
+	mesh.triangles.ptr = null;
+	mesh.materials.ptr = null;
+
+	CreateMeshTree(memoryManagerInstance, sceneObjects.sharedMeshes[index]);
+
+	return index;
+}
+
+uint Scene::AddSharedMesh(const char* meshFileName)
+{
+	Mesh newMesh;
+	if (LoadWavefrontObjectFromFile(meshFileName, memoryManagerInstance, newMesh))
+	{
+		newMesh.Update(true);
+
+		auto index = sceneObjects.sharedMeshes.Add(newMesh);
+		CreateMeshTree(memoryManagerInstance, sceneObjects.sharedMeshes[index]);
+
+		return index;
+	}
+
+	return 0;
+}
+
+uint Scene::AddMeshInstance(uint sharedMeshIndex, const Matrix4x4& transform, ui32 materialId)
+{
+	MeshInstance instance;
+	instance.meshIndex = (ui32)sharedMeshIndex;
+	instance.materialIndex = materialId;
+	instance.transform = transform;
+	instance.Update(sceneObjects.sharedMeshes[sharedMeshIndex]);
+
+	auto index = sceneObjects.meshInstances.Add(instance);
+	AddObjectId(sceneObjects.meshInstances[index].id.Set(ObjectType::MeshInstance, index));
+
+	sceneObjects.counts[ObjectType::MeshInstance] = (uint32)sceneObjects.meshInstances.currentCount;
+	return index;
+}
+
+ui32 Scene::AddMaterial(const v3f& diffuseColor, const v3f& specularColor,
+	real shininess, real reflection, real refraction, real refractionIndex)
+{
+	return AddMaterial(
+		diffuseColor.x, diffuseColor.y, diffuseColor.z, 
+		specularColor.x, specularColor.y, specularColor.z,
+		shininess, reflection, refraction, refractionIndex);
+}
+
+ui32 Scene::AddMaterial(real diffuseR, real diffuseG, real diffuseB,
+	real specularR, real specularG, real specularB,
+	real shininess, real reflection, real refraction, real refractionIndex)
+{
+	Material newMaterial;
+	newMaterial.diffuseColor.Set(diffuseR, diffuseG, diffuseB);
+	newMaterial.specularColor.Set(specularR, specularG, specularB);
+	newMaterial.reflection = reflection;
+	newMaterial.refraction = refraction;
+	newMaterial.refractionIndex = refractionIndex;
+	newMaterial.shininess = shininess;
+	
+	return (ui32)sceneObjects.materials.Add(newMaterial);
+}
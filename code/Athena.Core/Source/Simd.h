@@ -0,0 +1,70 @@
+#ifndef __simd_h
+#define __simd_h
+
+#include <emmintrin.h>
+#include "TypeDefs.h"
+
+// SSE2 operations over reals, one register holds SIMD_WIDTH values
+#ifdef REAL_AS_DOUBLE
+typedef __m128d								simd_real;
+#define SIMD_WIDTH							2
+#define SIMD_SET1(value)					_mm_set1_pd(value)
+#define SIMD_LOAD(ptr)						_mm_loadu_pd(ptr)
+#define SIMD_STORE(ptr, value)				_mm_storeu_pd(ptr, value)
+#define SIMD_ADD(a, b)						_mm_add_pd(a, b)
+#define SIMD_SUB(a, b)						_mm_sub_pd(a, b)
+#define SIMD_MUL(a, b)						_mm_mul_pd(a, b)
+// NOTE when one of values is NaN, second one is returned
+#define SIMD_MIN(a, b)						_mm_min_pd(a, b)
+#define SIMD_MAX(a, b)						_mm_max_pd(a, b)
+#define SIMD_CMPLE(a, b)					_mm_cmple_pd(a, b)
+#define SIMD_MOVEMASK(a)					(ui32)_mm_movemask_pd(a)
+#else
+typedef __m128								simd_real;
+#define SIMD_WIDTH							4
+#define SIMD_SET1(value)					_mm_set1_ps(value)
+#define SIMD_LOAD(ptr)						_mm_loadu_ps(ptr)
+#define SIMD_STORE(ptr, value)				_mm_storeu_ps(ptr, value)
+#define SIMD_ADD(a, b)						_mm_add_ps(a, b)
+#define SIMD_SUB(a, b)						_mm_sub_ps(a, b)
+#define SIMD_MUL(a, b)						_mm_mul_ps(a, b)
+// NOTE when one of values is NaN, second one is returned
+#define SIMD_MIN(a, b)						_mm_min_ps(a, b)
+#define SIMD_MAX(a, b)						_mm_max_ps(a, b)
+#define SIMD_CMPLE(a, b)					_mm_cmple_ps(a, b)
+#define SIMD_MOVEMASK(a)					(ui32)_mm_movemask_ps(a)
+#endif
+
+// operations over 32b floats (e.g. bounds of wide tree nodes), AVX build holds 8 values in one register
+#ifdef __AVX__
+#include <immintrin.h>
+typedef __m256								simd_f32;
+#define SIMD_F32_WIDTH						8
+#define SIMD_F32_SET1(value)				_mm256_set1_ps(value)
+// ptr has to be aligned to register size
+#define SIMD_F32_LOAD(ptr)					_mm256_load_ps(ptr)
+#define SIMD_F32_STORE(ptr, value)			_mm256_store_ps(ptr, value)
+#define SIMD_F32_SUB(a, b)					_mm256_sub_ps(a, b)
+#define SIMD_F32_MUL(a, b)					_mm256_mul_ps(a, b)
+// NOTE when one of values is NaN, second one is returned
+#define SIMD_F32_MIN(a, b)					_mm256_min_ps(a, b)
+#define SIMD_F32_MAX(a, b)					_mm256_max_ps(a, b)
+#define SIMD_F32_CMPLE(a, b)				_mm256_cmp_ps(a, b, _CMP_LE_OQ)
+#define SIMD_F32_MOVEMASK(a)				(ui32)_mm256_movemask_ps(a)
+#else
+typedef __m128								simd_f32;
+#define SIMD_F32_WIDTH						4
+#define SIMD_F32_SET1(value)				_mm_set1_ps(value)
+// ptr has to be aligned to register size
+#define SIMD_F32_LOAD(ptr)					_mm_load_ps(ptr)
+#define SIMD_F32_STORE(ptr, value)			_mm_store_ps(ptr, value)
+#define SIMD_F32_SUB(a, b)					_mm_sub_ps(a, b)
+#define SIMD_F32_MUL(a, b)					_mm_mul_ps(a, b)
+// NOTE when one of values is NaN, second one is returned
+#define SIMD_F32_MIN(a, b)					_mm_min_ps(a, b)
+#define SIMD_F32_MAX(a, b)					_mm_max_ps(a, b)
+#define SIMD_F32_CMPLE(a, b)				_mm_cmple_ps(a, b)
+#define SIMD_F32_MOVEMASK(a)				(ui32)_mm_movemask_ps(a)
+#endif
+
+#endif __simd_h
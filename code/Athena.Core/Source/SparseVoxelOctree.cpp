@@ -1,263 +1,1159 @@
-
-#include "Voxelizer.h"
-#include "Timers.h"
-#include "SparseVoxelOctree.h"
-
-#include <stdio.h>
-// Common
-#include <Log.h>
-#include <Vectors.h>
-#include <Timer.h>
-#include <StringHelpers.h>
-
-using namespace Common::Strings;
-
-
-SVO::SVO()
-{
-
-}
-
-
-SVO::~SVO()
-{
-
-}
-
-
-SVO_BlockDescriptor SVO::CreateBlock(const VoxelOctree* voxelOctree)
-{
-	// TODO: check later if this size number was not exceeded while processing of child nodes
-	int nodeBufferMaxLength = voxelOctree->nodeCount * 2;
-
-	// create node buffer
-	SVO_Node* nodeBuffer = new SVO_Node[nodeBufferMaxLength];
-	memset(nodeBuffer, 0, nodeBufferMaxLength * sizeof(*nodeBuffer));
-
-	// create lookup-entry buffer
-	SVO_MaterialLookUpEntry* lookUpEntryBuffer = new SVO_MaterialLookUpEntry[nodeBufferMaxLength];
-	memset(lookUpEntryBuffer, 0, nodeBufferMaxLength * sizeof(*lookUpEntryBuffer));
-
-	// create material buffer
-	SVO_Material* materialBuffer = new SVO_Material[voxelOctree->nodeCount];
-	memset(materialBuffer, 0, voxelOctree->nodeCount * sizeof(*materialBuffer));
-
-	// create and prepare svo block descriptor
-	SVO_BlockDescriptor blockDescriptor;
-	blockDescriptor.buffer = (int*)nodeBuffer;
-
-	// block start is aligned to pageSize
-	const int blockOffset = ((int)nodeBuffer % SVO_PAGE_SIZE == 0) ? 0 : (int)ALIGN_TO(nodeBuffer, SVO_PAGE_SIZE) - (int)nodeBuffer;
-	
-	// relative address of block info (one per block)
-	SVO_BlockInfo* blockInfo = (SVO_BlockInfo*)((int)nodeBuffer + blockOffset + sizeof(int*));
-	blockInfo->firstPageOffset = ((int)nodeBuffer + blockOffset) - (int)blockInfo;
-	blockInfo->nodeCount = voxelOctree->nodeCount;
-
-	// relative pointer to nodes from this block info (in this example nodes start right after block info)
-	blockInfo->nodesOffset = sizeof(SVO_BlockInfo);
-	
-	// set first page header (at block start)
-	*(int*)((int)nodeBuffer + blockOffset) = (int)blockInfo - (int)nodeBuffer - blockOffset;
-
-	// copy root cell
-	blockInfo->cell = voxelOctree->rootCell;
-
-	// get root octree node from memory pool
-	const OctreeNode* octreeRootNode = Voxelizer::Instance()->GetMemPool()->Get(voxelOctree->rootNodeId);
-
-	// set root svo node
-	SVO_Node* svoRootNode = (SVO_Node*)((int)blockInfo + blockInfo->nodesOffset);
-	svoRootNode->validMask = octreeRootNode->nodeMask;
-	svoRootNode->leafMask = octreeRootNode->nodeMask;
-	svoRootNode->farPtr = 0;
-	svoRootNode->childPtr = sizeof(SVO_Node);
-
-	// process recursively child nodes
-	const int nodeBufferLength = 1/*first page header*/ + sizeof(SVO_BlockInfo) / sizeof(SVO_Node) + 1/*root svo_node*/ + ProcessChildNodes(octreeRootNode, svoRootNode, svoRootNode + 1);
-	const int materialBufferLength = voxelOctree->nodeCount * (sizeof(SVO_Material) / sizeof(SVO_Node));
-
-	// total effective length of block (without alignment)
-	blockInfo->blockLength = nodeBufferLength/*nodes*/ + nodeBufferLength/*lookup*/ + materialBufferLength/*materials*/;
-
-	// set offsets for other tables
-	blockInfo->materialLookUpEntryOffset = (nodeBufferLength - 1) * sizeof(SVO_Node);
-	blockInfo->materialTableOffset = (2 * nodeBufferLength - 1) * sizeof(SVO_Node);
-
-	// create page headers betwneen nodes
-	FixPageHeaders(blockDescriptor);
-
-	// copy all 3 buffers together
-	blockDescriptor.bufferLength = blockInfo->blockLength + SVO_PAGE_SIZE;
-	blockDescriptor.buffer = new int[blockDescriptor.bufferLength];
-	memset(blockDescriptor.buffer, 0, blockDescriptor.bufferLength * sizeof(int));
-
-	int* alignedBuffer = ((int)blockDescriptor.buffer % SVO_PAGE_SIZE == 0) ? blockDescriptor.buffer : ALIGN_TO(blockDescriptor.buffer, SVO_PAGE_SIZE);
-
-	// copy nodes buffer
-	memcpy(alignedBuffer, (int*)((int)nodeBuffer + blockOffset), nodeBufferLength * sizeof(int));
-	
-	// copy look-up entry table buffer
-	memcpy(alignedBuffer + nodeBufferLength, lookUpEntryBuffer, nodeBufferLength * sizeof(int));
-
-	// copy material buffer
-	memcpy(alignedBuffer + nodeBufferLength + nodeBufferLength, (int*)materialBuffer, materialBufferLength * sizeof(int));
-	
-	SAFE_DELETE(nodeBuffer);
-	SAFE_DELETE(lookUpEntryBuffer);
-	SAFE_DELETE(materialBuffer);
-
-	char tmpString[256];
-	memset(tmpString, 0, 256);
-	LOG_TL(LogLevel::Info, "Block created [start: 0x%.8X(aligned to 0x%.8X), memory used: %s, numOfNodes: %d, voxelSize: ~%dB]",
-		(int)blockDescriptor.buffer,
-		(int)blockDescriptor.GetBlockInfo() + blockDescriptor.GetBlockInfo()->firstPageOffset,
-		GetMemSizeString(tmpString, blockDescriptor.bufferLength * sizeof(SVO_Node)), 
-		blockDescriptor.GetBlockInfo()->nodeCount, 
-		blockDescriptor.bufferLength * sizeof(SVO_Node) / voxelOctree->nodeCount);
-
-	return blockDescriptor;
-}
-
-
-int SVO::ProcessChildNodes(const OctreeNode* octreeNode, const SVO_Node* parentNode, SVO_Node* nextSvoNode)
-{
-	int nextNodeOffset = octreeNode->childCount;
-
-	const OctreeNode* firstChildNode = Voxelizer::Instance()->GetMemPool()->Get(octreeNode->firstChildNodeId);
-	for (int i = 0; i < octreeNode->childCount; i++)
-	{
-		const OctreeNode* childNode = firstChildNode + i;
-		SVO_Node* svoNode = nextSvoNode + i;
-		
-		// fill material data
-		// ...
-
-		if (childNode->childCount != 0)
-		{
-			// node
-			svoNode->validMask = childNode->nodeMask;
-			svoNode->leafMask = childNode->nodeMask;
-
-			SVO_Node* firstChildSvoNode = svoNode + nextNodeOffset - i;
-			
-			if (SVO_PAGE_HEADER((int)firstChildSvoNode) == (int)firstChildSvoNode)
-			{
-				firstChildSvoNode++;
-				nextNodeOffset++;
-			}
-			else if (((int)firstChildSvoNode % SVO_PAGE_SIZE) + (sizeof(SVO_Node) * childNode->childCount) > SVO_PAGE_SIZE)
-			{
-				const int offset = ((SVO_PAGE_SIZE - (int)firstChildSvoNode % SVO_PAGE_SIZE) + sizeof(SVO_Node)) / sizeof(SVO_Node);
-				firstChildSvoNode += offset;
-				nextNodeOffset += offset;
-			}
-
-			svoNode->farPtr = 0;
-			svoNode->childPtr = (int)firstChildSvoNode - (int)svoNode;
-
-			nextNodeOffset += ProcessChildNodes(childNode, svoNode, firstChildSvoNode);
-		}
-		else
-		{
-			// leaf
-			svoNode->childPtr = -1;
-		}
-	}
-
-	return nextNodeOffset;
-}
-
-
-void SVO::FixPageHeaders(SVO_BlockDescriptor& blockDescriptor)
-{
-	const SVO_BlockInfo* blockInfo = blockDescriptor.GetBlockInfo();
-	int nodeTableSize = blockInfo->materialLookUpEntryOffset;
-
-	// set page headers with relative address of block info
-	for (int i = 0; i < nodeTableSize; i+= SVO_PAGE_SIZE)
-	{
-		int* pageHeader = (int*)((int)blockInfo + blockInfo->firstPageOffset + i);
-
-		if (*pageHeader != 0 && (int)pageHeader + *pageHeader != (int)blockInfo)
-			LOG_TL(LogLevel::Warning, "Page header corrupted! 0x%.8X = %d", (int)pageHeader, *pageHeader);
-		
-		*pageHeader = (int)blockInfo - (int)pageHeader;
-	}
-}
-
-
-bool SVO::CheckBlock(const SVO_BlockDescriptor& blockDescriptor)
-{
-	const SVO_BlockInfo* blockInfo = blockDescriptor.GetBlockInfo();
-
-	// check page headers
-	int nodeTableSize = blockInfo->materialLookUpEntryOffset; 
-	for (int i = 0; i < nodeTableSize; i+= SVO_PAGE_SIZE)
-	{
-		const int* pageHeader = (int*)((int)blockInfo + blockInfo->firstPageOffset + i);
-		if ((int)pageHeader + *pageHeader != (int)blockInfo)
-		{
-			LOG_TL(LogLevel::Error, "Page header at 0x%.8X:%d is wrong! 0x%.8X != BlockInfo(0x%.8X)", (int)pageHeader, *pageHeader, (int)pageHeader + *pageHeader, (int)blockInfo);
-			return false;
-		}
-	}
-
-	// traverse through all nodes and count
-
-
-	return true;
-}
-
-
-void SVO::WriteToFile(const char* fileName, const SVO_BlockDescriptor& blockDescriptor)
-{
-	FILE* svoFile = fopen(fileName, "wb");
-	int lengthWritten = fwrite(blockDescriptor.GetBlock(), sizeof(int), blockDescriptor.GetBlockInfo()->blockLength, svoFile);
-	
-	if (lengthWritten != blockDescriptor.GetBlockInfo()->blockLength)
-	{
-		LOG_TL(LogLevel::Error, "fwrite returned %d instead of %d", lengthWritten, blockDescriptor.GetBlockInfo()->blockLength);
-	}
-	else
-	{
-		char tmpString[256];
-		memset(tmpString, 0, 256);
-
-		LOG_TL(LogLevel::Info, "Block successfully written to '%s' (%s)", fileName, GetMemSizeString(tmpString, blockDescriptor.GetBlockInfo()->blockLength * sizeof(int)));
-	}
-
-	fclose(svoFile);
-}
-
-SVO_BlockDescriptor SVO::ReadFromFile(const char* fileName)
-{
-	SVO_BlockDescriptor blockDescriptor;
-
-	FILE* svoFile = fopen(fileName, "rb");
-	fseek(svoFile, 0, SEEK_END);
-
-	int blockLength = ftell(svoFile) / sizeof(int);
-	rewind(svoFile);
-
-	blockDescriptor.bufferLength = blockLength + SVO_PAGE_SIZE;
-	blockDescriptor.buffer = new int[blockDescriptor.bufferLength];
-	int* alignedBuffer = ((int)blockDescriptor.buffer % SVO_PAGE_SIZE == 0) ? blockDescriptor.buffer : ALIGN_TO(blockDescriptor.buffer, SVO_PAGE_SIZE);
-
-	int lengthRead = fread(alignedBuffer, sizeof(int), blockLength, svoFile);
-	if (lengthRead != blockLength)
-	{
-		LOG_TL(LogLevel::Error, "fread returned %d instead of %d", lengthRead, blockDescriptor.GetBlockInfo()->blockLength);
-	}
-	else
-	{
-		char tmpString[256];
-		memset(tmpString, 0, 256);
-
-		LOG_TL(LogLevel::Info, "Block successfully read from '%s' (%s)", fileName, GetMemSizeString(tmpString, blockDescriptor.GetBlockInfo()->blockLength * sizeof(int)));
-	}
-
-	fclose(svoFile);
-
-	return blockDescriptor;
-}
+#include "Athena.h"
+#include "Bits.h"
+#include "Convert.h"
+#include "Hash.h"
+#include "HitResult.h"
+#include "Log.h"
+#include "MemoryManager.h"
+#include "Octree.h"
+#include "Ray.h"
+#include "Rendering.h"
+#include "SparseVoxelOctree.h"
+#include "StringHelpers.h"
+#include "Timers.h"
+#include "Timer.h"
+#include "Win32.h"
+
+// direction of ray parallel with axis, its planes are hit far behind any voxel
+#define SVO_MIN_DIRECTION	1e-12
+
+
+// parent node and exit distance of ray from it, stored for each scale of children
+struct SVO_StackEntry
+{
+	ui64 nodeWord;
+	real tMax;
+};
+
+// identical subtrees of block are one unique node of dag
+struct SVO_DagNode
+{
+	ui64 hash;
+	// unique nodes of non-leaf children (in order of valid mask bits) in SVO_Dag::childIds
+	ui32 firstChildId;
+	// materials of children (in order of material mask bits) in SVO_Dag::materials
+	ui32 firstMaterial;
+	ui8 validMask;
+	ui8 leafMask;
+	ui8 materialMask;
+
+	// upper bound of words written with subtree of unique node (capped, bigger ones need far pointer anyway)
+	ui64 descendants;
+	// group of children in dag block, 0 until it is written
+	ui64 groupWord;
+};
+
+struct SVO_Dag
+{
+	list_of<SVO_DagNode> nodes;
+	list_of<ui32> childIds;
+	list_of<SVO_Material> materials;
+	// open addressing, unique id + 1 or 0 when empty
+	array_of<ui32> slots;
+
+	// look-up entries of written nodes (same positions as words) and number of written nodes
+	list_of<ui32> lookUpEntries;
+	ui64 nodeCount;
+};
+
+
+void SVO::Initialize(MemoryManager* memoryManagerInstance)
+{
+	numOfBlocksCreated = numOfNodesUsed = numOfFarPtrsUsed = numOfWordsUsed = numOfOctreeNodesUsed = 0;
+	numOfBlocksCompressed = numOfWordsBeforeCompression = numOfWordsAfterCompression = 0;
+	currentOctreeBuildNumber = 0;
+	currentStreaming = currentDag = false;
+	compressionRatio = 1;
+	currentLodFraction = 0;
+
+	blockDescriptor.buffer = array_of<ui8>();
+	blockDescriptor.block = null;
+	mappedFile = null;
+
+	pageFrames = chunkFrames = array_of<std::atomic<ui32>>();
+	residentPages = array_of<ui8>();
+	residentPageIds.Initialize(memoryManagerInstance, "ui32");
+	currentFrame = 1;
+	memset(&residency, 0, sizeof(SVO_Residency));
+
+	this->memoryManagerInstance = memoryManagerInstance;
+}
+
+void SVO::Destroy(MemoryManager* memoryManagerInstance)
+{
+	if (this->memoryManagerInstance)
+	{
+		ShowStats();
+
+		DestroyBlock();
+		residentPageIds.Destroy();
+		this->memoryManagerInstance = null;
+
+		LOG_DEBUG("SVO::Destroy");
+	}
+}
+
+void SVO::DestroyBlock()
+{
+	if (blockDescriptor.buffer.ptr)
+		_MEM_FREE_ARRAY(memoryManagerInstance, ui8, &blockDescriptor.buffer);
+
+	if (mappedFile)
+	{
+		Win32UnmapFile(mappedFile);
+		_MEM_FREE(memoryManagerInstance, mappedFile);
+
+		_MEM_FREE_ARRAY(memoryManagerInstance, std::atomic<ui32>, &pageFrames);
+		_MEM_FREE_ARRAY(memoryManagerInstance, std::atomic<ui32>, &chunkFrames);
+		_MEM_FREE_ARRAY(memoryManagerInstance, ui8, &residentPages);
+		residentPageIds.Clear();
+	}
+
+	blockDescriptor.buffer = array_of<ui8>();
+	blockDescriptor.block = null;
+	pageFrames = chunkFrames = array_of<std::atomic<ui32>>();
+	residentPages = array_of<ui8>();
+}
+
+bool SVO::Update(const Octree* octree, AthenaStorage* athenaStorage, const char* fileName)
+{
+	const RenderingParameters& parameters = athenaStorage->renderingParameters;
+
+	if (parameters.tracingMethod != TracingMethod::SparseVoxelOctree || !octree->GetCurrentNodeCount())
+	{
+		DestroyBlock();
+		currentOctreeBuildNumber = 0;
+		return false;
+	}
+
+	// block is created only when octree changed
+	if (octree->GetBuildNumber() != currentOctreeBuildNumber ||
+		(parameters.svoStreaming != 0) != (currentStreaming != 0) ||
+		(parameters.svoDag != 0) != (currentDag != 0))
+	{
+		TIMED_BLOCK(&athenaStorage->timers[TimerId::SvoConstruction]);
+
+		currentOctreeBuildNumber = octree->GetBuildNumber();
+		currentStreaming = parameters.svoStreaming;
+		currentDag = parameters.svoDag;
+
+		// block file created from the same voxels is mapped again, block is not created in memory
+		const ui64 sourceHash = currentStreaming ? GetSourceHash(octree, currentDag) : 0;
+		if (!currentStreaming || !MapBlock(fileName) || blockInfo.sourceHash != sourceHash)
+		{
+			blockInfo.sourceHash = sourceHash;
+			CreateBlock(octree);
+
+			if (currentDag && blockDescriptor.block)
+				CompressBlock();
+
+			// created block is replaced by mapping of its file
+			if (currentStreaming && blockDescriptor.block)
+			{
+				WriteToFile(fileName);
+				DestroyBlock();
+				MapBlock(fileName);
+			}
+		}
+	}
+
+	currentLodFraction = parameters.voxelLodFraction;
+	UpdateResidency(parameters.svoResidentPageBudget);
+
+	return blockDescriptor.block != null;
+}
+
+ui64 SVO::GetSourceHash(const Octree* octree, b32 dag) const
+{
+	const list_of<OctreeNode>& octreeNodes = octree->GetNodes();
+	const list_of<OctreeVoxel>& octreeVoxels = octree->GetVoxels();
+	const list_of<ui32>& childVoxelIds = octree->GetChildVoxelIds();
+	const ui32 depth = octree->GetCurrentDepth();
+	const ui32 dagBlock = dag != 0;
+
+	ui64 hash = HashData(HASH_SEED, &dagBlock, sizeof(ui32));
+	hash = HashData(hash, &depth, sizeof(ui32));
+	hash = HashData(hash, &octree->GetRootCell(), sizeof(AACell));
+
+	// nodes are hashed by members, padding of node is not initialized
+	for (uint i = 0; i < octreeNodes.currentCount; ++i)
+	{
+		const OctreeNode& octreeNode = octreeNodes[i];
+		hash = HashData(hash, &octreeNode.nodeMask, sizeof(ui8));
+		hash = HashData(hash, &octreeNode.childNodeCount, sizeof(ui8));
+		hash = HashData(hash, &octreeNode.firstChildNodeId, sizeof(ui32));
+	}
+
+	hash = HashData(hash, octreeVoxels.array.ptr, octreeVoxels.currentCount * sizeof(OctreeVoxel));
+	hash = HashData(hash, childVoxelIds.array.ptr, childVoxelIds.currentCount * sizeof(ui32));
+
+	return hash;
+}
+
+void SVO::CreateBlock(const Octree* octree)
+{
+	DestroyBlock();
+
+	// only voxels can be stored in svo, leaves of object tree reference objects
+	const list_of<OctreeNode>& octreeNodes = octree->GetNodes();
+	const AACell& rootCell = octree->GetRootCell();
+	const ui32 depth = octree->GetCurrentDepth() + 1;
+	if (!octreeNodes.currentCount || octree->HasObjectLeaves() || depth > SVO_MAX_DEPTH ||
+		rootCell.maxCorner.x <= rootCell.minCorner.x)
+		return;
+
+	// number of svo nodes under each octree node, children are always stored after their parent
+	array_of<ui64> descendants = _MEM_ALLOC_ARRAY(memoryManagerInstance, ui64, octreeNodes.currentCount);
+	for (uint i = octreeNodes.currentCount; i-- > 0;)
+	{
+		const OctreeNode& octreeNode = octreeNodes[i];
+
+		descendants[i] = 0;
+		if (!octreeNode.IsParentNode())
+			for (ui32 j = 0; j < octreeNode.childNodeCount; ++j)
+				descendants[i] += 1 + descendants[octreeNode.firstChildNodeId + j];
+	}
+
+	// voxel attributes of octree are materials of children of svo nodes (in the same order), referenced by 24b pointers
+	const list_of<OctreeVoxel>& octreeVoxels = octree->GetVoxels();
+	const bool hasMaterials = octreeVoxels.currentCount && octreeVoxels.currentCount < (1 << 24);
+	if (octreeVoxels.currentCount && !hasMaterials)
+		LOG_TL(LogLevel::Warning, "SVO::CreateBlock [too many voxel attributes, they are not used]");
+
+	list_of<ui32> words(memoryManagerInstance, "ui32", SVO_PAGE_WORDS);
+	list_of<ui32> lookUpEntries(memoryManagerInstance, "ui32", hasMaterials ? SVO_PAGE_WORDS : 1);
+
+	// first page header is followed by block info
+	words.Add(1 + sizeof(SVO_BlockInfo) / sizeof(ui32));
+
+	// root is group of one node
+	const ui64 rootWord = AllocateGroup(words, 1);
+	SVO_Node& rootNode = *(SVO_Node*)&words[rootWord];
+	rootNode.validMask = octreeNodes[0].nodeMask;
+	rootNode.leafMask = octreeNodes[0].IsParentNode() ? octreeNodes[0].nodeMask : 0;
+
+	const ui32* childVoxelIds = hasMaterials ? octree->GetChildVoxelIds().array.ptr : null;
+	if (childVoxelIds)
+	{
+		lookUpEntries.Add(words.currentCount);
+		SVO_MaterialLookUpEntry& entry = *(SVO_MaterialLookUpEntry*)&lookUpEntries[rootWord];
+		entry.ptrToMaterial = childVoxelIds[0];
+		entry.validMask = octreeNodes[0].nodeMask;
+	}
+
+	const ui32 farPtrCount = descendants[0] ?
+		ProcessChildNodes(words, octreeNodes.array.ptr, descendants, childVoxelIds, lookUpEntries, 0, rootWord) : 0;
+
+	blockInfo.nodeCount = blockInfo.uniqueNodeCount = 1 + descendants[0];
+	blockInfo.depth = depth;
+	blockInfo.farPtrCount = farPtrCount;
+	blockInfo.nodesOffset = rootWord;
+	blockInfo.materialLookUpEntryOffset = 0;
+	blockInfo.materialTableOffset = 0;
+	blockInfo.cell = rootCell;
+
+	if (hasMaterials)
+	{
+		list_of<SVO_Material> materials(memoryManagerInstance, "SVO_Material", octreeVoxels.currentCount);
+		materials.Add(octreeVoxels.currentCount);
+		for (uint i = 0; i < octreeVoxels.currentCount; ++i)
+		{
+			const OctreeVoxel& voxel = octreeVoxels[i];
+			SVO_Material& material = materials[i];
+
+			material.color = voxel.color;
+			material.sign = voxel.sign;
+			material.axis = voxel.axis;
+			material.u = voxel.u;
+			material.v = voxel.v;
+		}
+
+		AppendMaterialTables(words, lookUpEntries, materials);
+	}
+
+	SetBlock(words);
+	compressionRatio = 1;
+
+	_MEM_FREE_ARRAY(memoryManagerInstance, ui64, &descendants);
+
+	numOfBlocksCreated++;
+	numOfNodesUsed += blockInfo.nodeCount;
+	numOfFarPtrsUsed += blockInfo.farPtrCount;
+	numOfWordsUsed += blockInfo.blockLength;
+	numOfOctreeNodesUsed += octreeNodes.currentCount;
+
+#ifdef _DEBUG
+	CheckBlock();
+#endif
+}
+
+void SVO::SetBlock(list_of<ui32>& words)
+{
+	// block is made of whole pages
+	const ui64 blockLength = (words.currentCount + SVO_PAGE_WORDS - 1) / SVO_PAGE_WORDS * SVO_PAGE_WORDS;
+
+	blockDescriptor.buffer = _MEM_ALLOC_ARRAY(memoryManagerInstance, ui8, blockLength * sizeof(ui32) + SVO_PAGE_SIZE);
+	blockDescriptor.block = (ui32*)(((uintptr_t)blockDescriptor.buffer.ptr + SVO_PAGE_SIZE - 1) &
+		~(uintptr_t)(SVO_PAGE_SIZE - 1));
+
+	memset(blockDescriptor.block, 0, blockLength * sizeof(ui32));
+	memcpy(blockDescriptor.block, words.array.ptr, words.currentCount * sizeof(ui32));
+
+	blockInfo.magic = SVO_BLOCK_MAGIC;
+	blockInfo.version = SVO_BLOCK_VERSION;
+	blockInfo.blockLength = blockLength;
+	*(SVO_BlockInfo*)(blockDescriptor.block + 1) = blockInfo;
+}
+
+ui64 SVO::AllocateGroup(list_of<ui32>& words, ui32 wordCount)
+{
+	ui64 word = words.currentCount;
+
+	// group would cross page boundary, rest of the page stays empty
+	if (word % SVO_PAGE_WORDS + wordCount > SVO_PAGE_WORDS)
+		word = (word / SVO_PAGE_WORDS + 1) * SVO_PAGE_WORDS;
+
+	if (word % SVO_PAGE_WORDS == 0)
+	{
+		words.Add(word + 1 - words.currentCount);
+		words[word] = (ui32)(word / SVO_PAGE_WORDS);
+		word++;
+	}
+
+	words.Add(word + wordCount - words.currentCount);
+	return word;
+}
+
+ui32 SVO::ProcessChildNodes(list_of<ui32>& words, const OctreeNode* octreeNodes, const array_of<ui64>& descendants,
+	const ui32* childVoxelIds, list_of<ui32>& lookUpEntries, ui32 octreeNodeId, ui64 nodeWord)
+{
+	const ui32 childCount = octreeNodes[octreeNodeId].childNodeCount;
+	const ui32 firstChildNodeId = octreeNodes[octreeNodeId].firstChildNodeId;
+
+	// distance to children of a node is bounded by rest of its group with far pointers and by subtrees
+	// of previous siblings, each svo node can have far pointer, empty page ends take less than 1/32
+	bool childFarPtrs[8] = {};
+	ui32 farPtrCount = 0;
+	ui64 previousDescendants = 0;
+	for (ui32 i = 0; i < childCount; ++i)
+	{
+		const ui64 maxOffset = (childCount - i) + childCount + 2 * previousDescendants;
+
+		childFarPtrs[i] = descendants[firstChildNodeId + i] && maxOffset + maxOffset / 32 + 32 > SVO_MAX_CHILD_OFFSET;
+		farPtrCount += childFarPtrs[i];
+		previousDescendants += descendants[firstChildNodeId + i];
+	}
+
+	const ui64 groupWord = AllocateGroup(words, childCount + farPtrCount);
+	LinkGroup(words, nodeWord, groupWord);
+
+	ui64 farPtrWord = groupWord + childCount;
+	for (ui32 i = 0; i < childCount; ++i)
+	{
+		const OctreeNode& childNode = octreeNodes[firstChildNodeId + i];
+
+		SVO_Node& svoNode = *(SVO_Node*)&words[groupWord + i];
+		svoNode.validMask = childNode.nodeMask;
+		// children of parent node are voxels
+		svoNode.leafMask = childNode.IsParentNode() ? childNode.nodeMask : 0;
+		svoNode.farPtr = childFarPtrs[i];
+		svoNode.childPtr = childFarPtrs[i] ? (ui16)(farPtrWord++ - (groupWord + i)) : 0;
+	}
+
+	if (childVoxelIds)
+	{
+		lookUpEntries.Add(words.currentCount - lookUpEntries.currentCount);
+		for (ui32 i = 0; i < childCount; ++i)
+		{
+			SVO_MaterialLookUpEntry& entry = *(SVO_MaterialLookUpEntry*)&lookUpEntries[groupWord + i];
+			entry.ptrToMaterial = childVoxelIds[firstChildNodeId + i];
+			entry.validMask = octreeNodes[firstChildNodeId + i].nodeMask;
+		}
+	}
+
+	// words can be reallocated, nodes are accessed again by their position
+	for (ui32 i = 0; i < childCount; ++i)
+		if (descendants[firstChildNodeId + i])
+			farPtrCount += ProcessChildNodes(words, octreeNodes, descendants, childVoxelIds, lookUpEntries,
+				firstChildNodeId + i, groupWord + i);
+
+	return farPtrCount;
+}
+
+void SVO::LinkGroup(list_of<ui32>& words, ui64 nodeWord, ui64 groupWord)
+{
+	SVO_Node& node = *(SVO_Node*)&words[nodeWord];
+	if (node.farPtr)
+	{
+		const ui64 farPtrWord = nodeWord + node.childPtr;
+		ASSERT((i64)(groupWord - farPtrWord) == (i32)(groupWord - farPtrWord));
+		words[farPtrWord] = (ui32)(i32)(groupWord - farPtrWord);
+	}
+	else
+	{
+		ASSERT(groupWord > nodeWord && groupWord - nodeWord <= SVO_MAX_CHILD_OFFSET);
+		node.childPtr = (ui16)(groupWord - nodeWord);
+	}
+}
+
+void SVO::CompressBlock()
+{
+	using namespace Common::Strings;
+
+	const SVO_BlockInfo sourceInfo = blockInfo;
+	const bool hasMaterials = sourceInfo.materialLookUpEntryOffset != 0;
+
+	SVO_Dag dag;
+	dag.nodes.Initialize(memoryManagerInstance, "SVO_DagNode");
+	dag.childIds.Initialize(memoryManagerInstance, "ui32");
+	dag.materials.Initialize(memoryManagerInstance, "SVO_Material");
+	dag.lookUpEntries.Initialize(memoryManagerInstance, "ui32");
+	dag.nodeCount = 0;
+
+	// at least twice as many slots as nodes
+	uint slotCount = 1;
+	while (slotCount < 2 * sourceInfo.nodeCount)
+		slotCount <<= 1;
+	dag.slots = _MEM_ALLOC_ARRAY(memoryManagerInstance, ui32, slotCount);
+	memset(dag.slots.ptr, 0, dag.slots.count * sizeof(ui32));
+
+	const ui32 rootId = DeduplicateNode(dag, sourceInfo.nodesOffset);
+	_MEM_FREE_ARRAY(memoryManagerInstance, ui32, &dag.slots);
+
+	// unique nodes are written top-down, so children mostly follow their parents as in tree
+	list_of<ui32> words(memoryManagerInstance, "ui32", SVO_PAGE_WORDS);
+	words.Add(1 + sizeof(SVO_BlockInfo) / sizeof(ui32));
+
+	const ui64 rootWord = AllocateGroup(words, 1);
+	const SVO_DagNode& root = dag.nodes[rootId];
+	SVO_Node& rootNode = *(SVO_Node*)&words[rootWord];
+	rootNode.validMask = root.validMask;
+	rootNode.leafMask = root.leafMask;
+	dag.nodeCount = 1;
+
+	if (hasMaterials)
+	{
+		dag.lookUpEntries.Add(words.currentCount);
+		SVO_MaterialLookUpEntry& entry = *(SVO_MaterialLookUpEntry*)&dag.lookUpEntries[rootWord];
+		entry.ptrToMaterial = root.firstMaterial;
+		entry.validMask = root.materialMask;
+	}
+
+	const ui32 farPtrCount = (root.validMask & ~root.leafMask) ?
+		ProcessDagChildNodes(words, dag, rootId, rootWord) : 0;
+
+	blockInfo.uniqueNodeCount = dag.nodeCount;
+	blockInfo.farPtrCount = farPtrCount;
+	blockInfo.nodesOffset = rootWord;
+	blockInfo.materialLookUpEntryOffset = blockInfo.materialTableOffset = 0;
+
+	// materials are referenced by 24b pointers
+	if (hasMaterials && dag.materials.currentCount < (1 << 24))
+		AppendMaterialTables(words, dag.lookUpEntries, dag.materials);
+	else if (hasMaterials)
+		LOG_TL(LogLevel::Warning, "SVO::CompressBlock [too many materials, they are not used]");
+
+	DestroyBlock();
+	SetBlock(words);
+	compressionRatio = (real)sourceInfo.blockLength / blockInfo.blockLength;
+
+	numOfBlocksCompressed++;
+	numOfWordsBeforeCompression += sourceInfo.blockLength;
+	numOfWordsAfterCompression += blockInfo.blockLength;
+
+	char tmpBuffer1[256] = {};
+	char tmpBuffer2[256] = {};
+	LOG_TL(LogLevel::Info, "SVO::CompressBlock [nodes %I64d -> %I64d; %s -> %s; ratio %.2f]",
+		sourceInfo.uniqueNodeCount, blockInfo.uniqueNodeCount,
+		GetMemSizeString(tmpBuffer1, sourceInfo.blockLength * sizeof(ui32)),
+		GetMemSizeString(tmpBuffer2, blockInfo.blockLength * sizeof(ui32)), compressionRatio);
+
+	dag.nodes.Destroy();
+	dag.childIds.Destroy();
+	dag.materials.Destroy();
+	dag.lookUpEntries.Destroy();
+
+#ifdef _DEBUG
+	CheckBlock();
+#endif
+}
+
+ui32 SVO::DeduplicateNode(SVO_Dag& dag, ui64 nodeWord)
+{
+	const SVO_Node& node = *blockDescriptor.GetNode(nodeWord);
+
+	// children are unique before their parent
+	ui32 childIds[8];
+	const ui32 childCount = CountBits(node.validMask & ~node.leafMask);
+	if (childCount)
+	{
+		const ui64 groupWord = blockDescriptor.GetGroupWord(nodeWord);
+		for (ui32 i = 0; i < childCount; ++i)
+			childIds[i] = DeduplicateNode(dag, groupWord + i);
+	}
+
+	SVO_Material materials[8];
+	ui32 materialCount = 0;
+	ui32 firstMaterial = 0;
+	ui8 materialMask = 0;
+	if (blockInfo.materialLookUpEntryOffset)
+	{
+		const SVO_MaterialLookUpEntry& entry = *blockDescriptor.GetMaterialLookUpEntry(nodeWord);
+		materialMask = (ui8)entry.validMask;
+		firstMaterial = entry.ptrToMaterial;
+		materialCount = CountBits(materialMask);
+		for (ui32 i = 0; i < materialCount; ++i)
+			materials[i] = *blockDescriptor.GetMaterial(firstMaterial + i);
+	}
+
+	ui64 hash = 14695981039346656037ull;
+	hash = HashData(hash, &node.validMask, sizeof(ui8));
+	hash = HashData(hash, &node.leafMask, sizeof(ui8));
+	hash = HashData(hash, &materialMask, sizeof(ui8));
+	hash = HashData(hash, childIds, childCount * sizeof(ui32));
+	hash = HashData(hash, materials, materialCount * sizeof(SVO_Material));
+
+	uint slot = (uint)hash & (dag.slots.count - 1);
+	for (; dag.slots[slot]; slot = (slot + 1) & (dag.slots.count - 1))
+	{
+		const ui32 uniqueId = dag.slots[slot] - 1;
+		const SVO_DagNode& dagNode = dag.nodes[uniqueId];
+
+		if (dagNode.hash == hash && dagNode.validMask == node.validMask && dagNode.leafMask == node.leafMask &&
+			dagNode.materialMask == materialMask &&
+			(!childCount || !memcmp(&dag.childIds[dagNode.firstChildId], childIds, childCount * sizeof(ui32))) &&
+			(!materialCount ||
+				!memcmp(&dag.materials[dagNode.firstMaterial], materials, materialCount * sizeof(SVO_Material))))
+			return uniqueId;
+	}
+
+	SVO_DagNode dagNode = {};
+	dagNode.hash = hash;
+	dagNode.validMask = node.validMask;
+	dagNode.leafMask = node.leafMask;
+	dagNode.materialMask = materialMask;
+
+	dagNode.firstChildId = (ui32)dag.childIds.currentCount;
+	for (ui32 i = 0; i < childCount; ++i)
+	{
+		dag.childIds.Add(childIds[i]);
+		dagNode.descendants += 1 + dag.nodes[childIds[i]].descendants;
+	}
+	dagNode.descendants = MIN2(dagNode.descendants, (ui64)SVO_MAX_CHILD_OFFSET);
+
+	dagNode.firstMaterial = (ui32)dag.materials.currentCount;
+	for (ui32 i = 0; i < materialCount; ++i)
+		dag.materials.Add(materials[i]);
+
+	const ui32 uniqueId = (ui32)dag.nodes.Add(dagNode);
+	dag.slots[slot] = uniqueId + 1;
+
+	return uniqueId;
+}
+
+ui32 SVO::ProcessDagChildNodes(list_of<ui32>& words, SVO_Dag& dag, ui32 uniqueId, ui64 nodeWord)
+{
+	const ui32 childCount = CountBits(dag.nodes[uniqueId].validMask & ~dag.nodes[uniqueId].leafMask);
+	const ui32 firstChildId = dag.nodes[uniqueId].firstChildId;
+
+	// groups written before (or by previous siblings) are shared through far pointers, other children
+	// are bounded as in tree
+	bool childFarPtrs[8] = {};
+	ui32 farPtrCount = 0;
+	ui64 previousDescendants = 0;
+	for (ui32 i = 0; i < childCount; ++i)
+	{
+		const ui32 childId = dag.childIds[firstChildId + i];
+		const SVO_DagNode& childNode = dag.nodes[childId];
+		if (!(childNode.validMask & ~childNode.leafMask))
+			continue;
+
+		bool shared = childNode.groupWord != 0;
+		for (ui32 j = 0; j < i && !shared; ++j)
+			shared = dag.childIds[firstChildId + j] == childId;
+
+		const ui64 maxOffset = (childCount - i) + childCount + 2 * previousDescendants;
+		childFarPtrs[i] = shared || maxOffset + maxOffset / 32 + 32 > SVO_MAX_CHILD_OFFSET;
+		farPtrCount += childFarPtrs[i];
+		if (!shared)
+			previousDescendants += childNode.descendants;
+	}
+
+	const ui64 groupWord = AllocateGroup(words, childCount + farPtrCount);
+	LinkGroup(words, nodeWord, groupWord);
+	dag.nodes[uniqueId].groupWord = groupWord;
+	dag.nodeCount += childCount;
+
+	if (dag.lookUpEntries.currentCount)
+		dag.lookUpEntries.Add(words.currentCount - dag.lookUpEntries.currentCount);
+
+	ui64 farPtrWord = groupWord + childCount;
+	for (ui32 i = 0; i < childCount; ++i)
+	{
+		const SVO_DagNode& childNode = dag.nodes[dag.childIds[firstChildId + i]];
+
+		SVO_Node& svoNode = *(SVO_Node*)&words[groupWord + i];
+		svoNode.validMask = childNode.validMask;
+		svoNode.leafMask = childNode.leafMask;
+		svoNode.farPtr = childFarPtrs[i];
+		svoNode.childPtr = childFarPtrs[i] ? (ui16)(farPtrWord++ - (groupWord + i)) : 0;
+
+		// each copy of unique node references the same materials
+		if (dag.lookUpEntries.currentCount)
+		{
+			SVO_MaterialLookUpEntry& entry = *(SVO_MaterialLookUpEntry*)&dag.lookUpEntries[groupWord + i];
+			entry.ptrToMaterial = childNode.firstMaterial;
+			entry.validMask = childNode.materialMask;
+		}
+	}
+
+	for (ui32 i = 0; i < childCount; ++i)
+	{
+		const ui32 childId = dag.childIds[firstChildId + i];
+		if (!(dag.nodes[childId].validMask & ~dag.nodes[childId].leafMask))
+			continue;
+
+		if (dag.nodes[childId].groupWord)
+			LinkGroup(words, groupWord + i, dag.nodes[childId].groupWord);
+		else
+			farPtrCount += ProcessDagChildNodes(words, dag, childId, groupWord + i);
+	}
+
+	return farPtrCount;
+}
+
+void SVO::AppendMaterialTables(list_of<ui32>& words, const list_of<ui32>& lookUpEntries,
+	const list_of<SVO_Material>& materials)
+{
+	// look-up entry table starts at page boundary, so entries are at the same page offsets as nodes
+	const ui64 nodesLength = (words.currentCount + SVO_PAGE_WORDS - 1) / SVO_PAGE_WORDS * SVO_PAGE_WORDS;
+	words.Add(2 * nodesLength - words.currentCount);
+
+	blockInfo.materialLookUpEntryOffset = nodesLength;
+	memcpy(&words[nodesLength], lookUpEntries.array.ptr, lookUpEntries.currentCount * sizeof(ui32));
+	for (ui64 word = nodesLength; word < 2 * nodesLength; word += SVO_PAGE_WORDS)
+		words[word] = (ui32)(word / SVO_PAGE_WORDS);
+
+	blockInfo.materialTableOffset = 2 * nodesLength;
+	for (uint i = 0; i < materials.currentCount; ++i)
+	{
+		if (i % SVO_PAGE_MATERIALS == 0)
+		{
+			const ui64 pageWord = words.Add(SVO_PAGE_WORDS);
+			words[pageWord] = (ui32)(pageWord / SVO_PAGE_WORDS);
+		}
+
+		const ui64 word = blockInfo.materialTableOffset + i / SVO_PAGE_MATERIALS * SVO_PAGE_WORDS + 1 +
+			i % SVO_PAGE_MATERIALS * 2;
+		*(SVO_Material*)&words[word] = materials[i];
+	}
+}
+
+bool SVO::CheckBlock() const
+{
+	const ui32* block = blockDescriptor.block;
+	const SVO_BlockInfo* info = blockDescriptor.GetBlockInfo();
+
+	if (info->magic != SVO_BLOCK_MAGIC || info->version != SVO_BLOCK_VERSION ||
+		!info->blockLength || info->blockLength % SVO_PAGE_WORDS || !info->depth ||
+		info->depth > SVO_MAX_DEPTH || info->nodesOffset >= info->blockLength ||
+		info->uniqueNodeCount > info->nodeCount || info->materialLookUpEntryOffset % SVO_PAGE_WORDS ||
+		info->materialTableOffset % SVO_PAGE_WORDS || info->materialTableOffset > info->blockLength ||
+		info->materialLookUpEntryOffset > info->materialTableOffset)
+	{
+		LOG_TL(LogLevel::Error, "SVO block info is wrong!");
+		return false;
+	}
+
+	// page header is index of page in block
+	const ui64 pageCount = info->blockLength / SVO_PAGE_WORDS;
+	for (ui64 page = 0; page < pageCount; ++page)
+	{
+		if (block[page * SVO_PAGE_WORDS] != page)
+		{
+			LOG_TL(LogLevel::Error, "SVO page header %I64d is wrong! %d", page, block[page * SVO_PAGE_WORDS]);
+			return false;
+		}
+	}
+
+	// traverse through all nodes and count them, each level can add 7 nodes to the stack
+	ui64 nodeWords[7 * SVO_MAX_DEPTH + 1];
+	ui32 nodeLevels[7 * SVO_MAX_DEPTH + 1];
+	ui32 stackSize = 0;
+	ui64 nodeCount = 0;
+
+	nodeWords[stackSize] = info->nodesOffset;
+	nodeLevels[stackSize++] = 0;
+	while (stackSize)
+	{
+		const ui64 nodeWord = nodeWords[--stackSize];
+		const ui32 level = nodeLevels[stackSize];
+		const SVO_Node& node = *blockDescriptor.GetNode(nodeWord);
+		nodeCount++;
+
+		const ui32 childCount = CountBits(node.validMask & ~node.leafMask);
+		if ((node.leafMask & ~node.validMask) || (childCount && level + 1 >= info->depth) ||
+			(!childCount && level + 1 < info->depth && node.validMask))
+		{
+			LOG_TL(LogLevel::Error, "SVO node %I64d at level %d is wrong!", nodeWord, level);
+			return false;
+		}
+
+		if (!childCount)
+			continue;
+
+		if (node.farPtr && nodeWord + node.childPtr >= info->blockLength)
+		{
+			LOG_TL(LogLevel::Error, "SVO far pointer of node %I64d is out of block!", nodeWord);
+			return false;
+		}
+
+		// group can not cross page boundary, groups of dag can be shared by nodes stored after them
+		const ui64 groupWord = blockDescriptor.GetGroupWord(nodeWord);
+		if ((groupWord <= nodeWord && info->uniqueNodeCount == info->nodeCount) ||
+			groupWord >= info->blockLength || groupWord + childCount > info->blockLength ||
+			groupWord % SVO_PAGE_WORDS == 0 || (groupWord + childCount - 1) / SVO_PAGE_WORDS != groupWord / SVO_PAGE_WORDS)
+		{
+			LOG_TL(LogLevel::Error, "SVO child pointer of node %I64d is wrong! %I64d", nodeWord, groupWord);
+			return false;
+		}
+
+		for (ui32 i = 0; i < childCount; ++i)
+		{
+			nodeWords[stackSize] = groupWord + i;
+			nodeLevels[stackSize++] = level + 1;
+		}
+	}
+
+	if (nodeCount != info->nodeCount)
+	{
+		LOG_TL(LogLevel::Error, "SVO node count is wrong! %I64d != %I64d", nodeCount, info->nodeCount);
+		return false;
+	}
+
+	return true;
+}
+
+void SVO::Hit(const Ray& ray, HitResult& hitResult) const
+{
+	if (!blockDescriptor.block)
+		return;
+
+	real tEntry, tExit;
+	ui32 entryAxis, exitAxis;
+	ui64 nodeWord;
+	ui32 childBit;
+	if (!CastRay(ray, 0, hitResult.distance, tEntry, tExit, entryAxis, exitAxis, nodeWord, childBit,
+		hitResult.nodeTestCount))
+		return;
+
+	// ray starting inside of voxel hits it from inside
+	const bool fromInside = tEntry <= 0;
+	const real distance = fromInside ? tExit : tEntry;
+	if (distance >= hitResult.distance)
+		return;
+
+	const ui32 axis = fromInside ? exitAxis : entryAxis;
+
+	hitResult.distance = distance;
+	hitResult.point = ray.origin + ray.direction * hitResult.distance;
+	hitResult.normal.Set(0, 0, 0);
+	hitResult.normal[axis] = (ray.sign.Get(axis) != 0) != fromInside ? (real)1 : (real)-1;
+
+	hitResult.objectId.Set(ObjectType::Voxel, 0);
+
+	const SVO_Material* material = GetChildMaterial(nodeWord, childBit);
+	if (material)
+	{
+		hitResult.color = Vector4bToVector3f(material->color);
+
+		// voxel normal is turned to the same side as hit face of voxel
+		v3f normal = GetVoxelNormal(*material);
+		if (vectors::Dot(normal, hitResult.normal) < 0)
+			vectors::Inv(normal);
+		hitResult.normal = normal;
+	}
+}
+
+const SVO_Material* SVO::GetChildMaterial(ui64 nodeWord, ui32 childBit) const
+{
+	if (!blockInfo.materialLookUpEntryOffset)
+		return null;
+
+	const ui64 entryWord = blockInfo.materialLookUpEntryOffset + nodeWord;
+	TouchPage(entryWord / SVO_PAGE_WORDS);
+
+	const SVO_MaterialLookUpEntry& entry = *(const SVO_MaterialLookUpEntry*)(blockDescriptor.block + entryWord);
+	if (!(entry.validMask & childBit))
+		return null;
+
+	const ui32 index = entry.ptrToMaterial + CountBits(entry.validMask & (childBit - 1));
+	const ui64 materialWord = blockInfo.materialTableOffset + index / SVO_PAGE_MATERIALS * SVO_PAGE_WORDS + 1 +
+		index % SVO_PAGE_MATERIALS * 2;
+	TouchPage(materialWord / SVO_PAGE_WORDS);
+
+	return (const SVO_Material*)(blockDescriptor.block + materialWord);
+}
+
+bool SVO::Collide(const Ray& ray, real from, real to) const
+{
+	if (!blockDescriptor.block)
+		return false;
+
+	real tEntry, tExit;
+	ui32 entryAxis, exitAxis;
+	ui64 nodeWord;
+	ui32 childBit;
+	uint nodeTestCount = 0;
+
+	return CastRay(ray, from, to, tEntry, tExit, entryAxis, exitAxis, nodeWord, childBit, nodeTestCount);
+}
+
+bool SVO::CastRay(const Ray& ray, real from, real to, real& tEntry, real& tExit, ui32& entryAxis,
+	ui32& exitAxis, ui64& hitNodeWord, ui32& hitChildBit, uint& nodeTestCount) const
+{
+	const ui32 depth = blockInfo.depth;
+	const real resolution = (real)(1u << depth);
+	// children smaller than this (in leaf voxels) at distance 1 are hit as voxels with prefiltered materials
+	const real lodSize = currentLodFraction * ray.footprint * resolution /
+		(blockInfo.cell.maxCorner.x - blockInfo.cell.minCorner.x);
+
+	// voxel planes are at integer positions of mirrored ray, t(position) = position * tCoef - tBias
+	real tCoef[3], tBias[3];
+	ui32 octantMask = 0;
+	for (ui32 axis = 0; axis < 3; ++axis)
+	{
+		const real scale = resolution / (blockInfo.cell.maxCorner.Get(axis) - blockInfo.cell.minCorner.Get(axis));
+
+		real origin = (ray.origin.Get(axis) - blockInfo.cell.minCorner.Get(axis)) * scale;
+		real direction = ray.direction.Get(axis) * scale;
+		if (ray.sign.Get(axis))
+		{
+			octantMask |= 1 << axis;
+			origin = resolution - origin;
+			direction = -direction;
+		}
+
+		if (direction < SVO_MIN_DIRECTION)
+			direction = SVO_MIN_DIRECTION;
+
+		tCoef[axis] = 1 / direction;
+		tBias[axis] = origin * tCoef[axis];
+	}
+
+	// root cell
+	real tMin = MAX3(-tBias[0], -tBias[1], -tBias[2]);
+	real tMax = MIN3(resolution * tCoef[0] - tBias[0], resolution * tCoef[1] - tBias[1],
+		resolution * tCoef[2] - tBias[2]);
+
+	tMin = MAX2(tMin, from);
+	if (tMin > tMax || tMin >= to)
+		return false;
+
+	SVO_StackEntry stack[SVO_MAX_DEPTH];
+
+	ui64 parentWord = blockInfo.nodesOffset;
+	// pages of mapped block are marked as used when traversal enters them
+	ui64 currentPage = parentWord / SVO_PAGE_WORDS;
+	TouchPage(currentPage);
+	// children of parent node have size 1 << scale
+	ui32 scale = depth - 1;
+	ui32 position[3] = {};
+	ui32 childIndex = 0;
+
+	// child of root containing ray at tMin
+	for (ui32 axis = 0; axis < 3; ++axis)
+		if ((position[axis] + (1u << scale)) * tCoef[axis] - tBias[axis] <= tMin)
+		{
+			childIndex |= 1 << axis;
+			position[axis] += 1u << scale;
+		}
+
+	for (;;)
+	{
+		const SVO_Node& node = *blockDescriptor.GetNode(parentWord);
+		const ui32 childSize = 1u << scale;
+		nodeTestCount++;
+
+		// exit distances of child cell
+		real tc[3];
+		for (ui32 axis = 0; axis < 3; ++axis)
+			tc[axis] = (position[axis] + childSize) * tCoef[axis] - tBias[axis];
+		const real tcMax = MIN3(tc[0], tc[1], tc[2]);
+
+		// mirrored child index to real child position
+		const ui32 childBit = 1 << (childIndex ^ octantMask);
+		if ((node.validMask & childBit) && tMin <= tMax)
+		{
+			const real tvMax = MIN2(tMax, tcMax);
+			if (tMin <= tvMax)
+			{
+				if ((node.leafMask & childBit) || (real)childSize < lodSize * tMin)
+				{
+					if (tvMax > from)
+					{
+						real t0[3];
+						for (ui32 axis = 0; axis < 3; ++axis)
+							t0[axis] = position[axis] * tCoef[axis] - tBias[axis];
+
+						tEntry = MAX3(t0[0], t0[1], t0[2]);
+						tExit = tcMax;
+						entryAxis = t0[0] >= t0[1] ? (t0[0] >= t0[2] ? 0 : 2) : (t0[1] >= t0[2] ? 1 : 2);
+						exitAxis = tc[0] <= tc[1] ? (tc[0] <= tc[2] ? 0 : 2) : (tc[1] <= tc[2] ? 1 : 2);
+						hitNodeWord = parentWord;
+						hitChildBit = childBit;
+
+						return true;
+					}
+				}
+				else
+				{
+					// PUSH
+					stack[scale].nodeWord = parentWord;
+					stack[scale].tMax = tMax;
+
+					// non-leaf children are stored in order of valid mask bits
+					const ui64 groupWord = blockDescriptor.GetGroupWord(parentWord);
+
+					if (groupWord / SVO_PAGE_WORDS != currentPage)
+					{
+						currentPage = groupWord / SVO_PAGE_WORDS;
+						TouchPage(currentPage);
+					}
+
+					parentWord = groupWord + CountBits(node.validMask & ~node.leafMask & (childBit - 1));
+					tMax = tvMax;
+					scale--;
+
+					childIndex = 0;
+					for (ui32 axis = 0; axis < 3; ++axis)
+						if ((position[axis] + (1u << scale)) * tCoef[axis] - tBias[axis] <= tMin)
+						{
+							childIndex |= 1 << axis;
+							position[axis] += 1u << scale;
+						}
+
+					continue;
+				}
+			}
+		}
+
+		// ADVANCE
+		ui32 stepMask = 0;
+		ui32 differingBits = 0;
+		for (ui32 axis = 0; axis < 3; ++axis)
+			if (tc[axis] <= tcMax)
+			{
+				stepMask |= 1 << axis;
+				differingBits |= position[axis] ^ (position[axis] + childSize);
+				position[axis] += childSize;
+			}
+
+		tMin = tcMax;
+		if (tMin >= to)
+			return false;
+
+		if (childIndex & stepMask)
+		{
+			// POP, ray left parent node, highest changed bit of position is scale of the next child
+			scale = GetHighestBit(differingBits);
+			if (scale >= depth)
+				return false;
+
+			parentWord = stack[scale].nodeWord;
+			tMax = stack[scale].tMax;
+
+			childIndex = 0;
+			for (ui32 axis = 0; axis < 3; ++axis)
+			{
+				position[axis] &= ~((1u << scale) - 1);
+				childIndex |= ((position[axis] >> scale) & 1) << axis;
+			}
+		}
+		else
+			childIndex |= stepMask;
+	}
+}
+
+void SVO::WriteToFile(const char* fileName) const
+{
+	using namespace Common::Strings;
+
+	if (!blockDescriptor.block)
+		return;
+
+	const uint size = blockInfo.blockLength * sizeof(ui32);
+	if (Win32WriteFile(fileName, size, blockDescriptor.block))
+	{
+		char tmpBuffer[256] = {};
+		LOG_TL(LogLevel::Info, "SVO block written to '%s' (%s)", fileName, GetMemSizeString(tmpBuffer, size));
+	}
+	else
+		LOG_TL(LogLevel::Error, "SVO block could not be written to '%s'", fileName);
+}
+
+bool SVO::MapBlock(const char* fileName)
+{
+	using namespace Common::Strings;
+
+	DestroyBlock();
+
+	win32_mapped_file file = Win32MapFile(fileName);
+	if (!file.memory)
+		return false;
+
+	// only block info and the first page header are checked, other pages are not read until they are used
+	const SVO_BlockInfo* info = (const SVO_BlockInfo*)((const ui32*)file.memory + 1);
+	if (file.memorySize < SVO_PAGE_SIZE || file.memorySize % SVO_PAGE_SIZE || *(const ui32*)file.memory ||
+		info->magic != SVO_BLOCK_MAGIC || info->version != SVO_BLOCK_VERSION ||
+		info->blockLength * sizeof(ui32) != file.memorySize || !info->depth || info->depth > SVO_MAX_DEPTH ||
+		info->nodesOffset >= info->blockLength)
+	{
+		LOG_TL(LogLevel::Warning, "SVO::MapBlock [%s is not valid]", fileName);
+		Win32UnmapFile(&file);
+		return false;
+	}
+
+	mappedFile = _MEM_ALLOC(memoryManagerInstance, win32_mapped_file);
+	*mappedFile = file;
+
+	// mapped memory is read-only, block is never changed
+	blockDescriptor.block = (ui32*)file.memory;
+	blockInfo = *info;
+
+	const uint pageCount = blockInfo.blockLength / SVO_PAGE_WORDS;
+	pageFrames = _MEM_ALLOC_ARRAY(memoryManagerInstance, std::atomic<ui32>, pageCount);
+	chunkFrames = _MEM_ALLOC_ARRAY(memoryManagerInstance, std::atomic<ui32>,
+		(pageCount + SVO_PAGES_PER_CHUNK - 1) / SVO_PAGES_PER_CHUNK);
+	residentPages = _MEM_ALLOC_ARRAY(memoryManagerInstance, ui8, pageCount);
+	for (uint page = 0; page < pageFrames.count; ++page)
+		pageFrames[page].store(0, std::memory_order_relaxed);
+	for (uint chunk = 0; chunk < chunkFrames.count; ++chunk)
+		chunkFrames[chunk].store(0, std::memory_order_relaxed);
+	memset(residentPages.ptr, 0, residentPages.count * sizeof(ui8));
+	residentPageIds.Clear();
+
+	residency.pageCount = pageCount;
+	residency.residentPages = 0;
+
+	char tmpBuffer[256] = {};
+	LOG_TL(LogLevel::Info, "SVO::MapBlock [%s; %s; nodes: %I64d]", fileName,
+		GetMemSizeString(tmpBuffer, file.memorySize), blockInfo.nodeCount);
+
+	return true;
+}
+
+inline void SVO::TouchPage(ui64 page) const
+{
+	// only pages of mapped block are tracked, all threads write the same frame, so relaxed order is enough
+	if (!pageFrames.ptr || pageFrames[page].load(std::memory_order_relaxed) == currentFrame)
+		return;
+
+	pageFrames[page].store(currentFrame, std::memory_order_relaxed);
+	chunkFrames[page / SVO_PAGES_PER_CHUNK].store(currentFrame, std::memory_order_relaxed);
+}
+
+void SVO::UpdateResidency(ui32 pageBudget)
+{
+	if (!pageFrames.ptr)
+		return;
+
+	// pages used in the last frame for the first time since they were evicted
+	for (uint chunk = 0; chunk < chunkFrames.count; ++chunk)
+	{
+		if (chunkFrames[chunk] != currentFrame)
+			continue;
+
+		const uint lastPage = MIN2((chunk + 1) * SVO_PAGES_PER_CHUNK, pageFrames.count);
+		for (uint page = chunk * SVO_PAGES_PER_CHUNK; page < lastPage; ++page)
+		{
+			if (pageFrames[page] != currentFrame || residentPages[page])
+				continue;
+
+			ui32 pageId = (ui32)page;
+			residentPageIds.Add(pageId);
+			residentPages[page] = true;
+			residency.pageFaults++;
+		}
+	}
+
+	// the least recently used pages are evicted until 7/8 of budget is left, so it does not happen each frame
+	if (pageBudget && residentPageIds.currentCount > pageBudget)
+	{
+		const uint evictCount = residentPageIds.currentCount - (pageBudget - pageBudget / 8);
+
+		uint ageCounts[SVO_MAX_PAGE_AGE + 1] = {};
+		for (uint i = 0; i < residentPageIds.currentCount; ++i)
+			ageCounts[MIN2(currentFrame - pageFrames[residentPageIds[i]], (ui32)SVO_MAX_PAGE_AGE)]++;
+
+		// all pages older than maxAge are evicted, pages of maxAge only until evictCount is reached
+		ui32 maxAge = SVO_MAX_PAGE_AGE;
+		uint olderCount = 0;
+		while (olderCount + ageCounts[maxAge] < evictCount)
+			olderCount += ageCounts[maxAge--];
+		uint maxAgeEvictCount = evictCount - olderCount;
+
+		uint residentCount = 0;
+		for (uint i = 0; i < residentPageIds.currentCount; ++i)
+		{
+			const ui32 page = residentPageIds[i];
+			const ui32 age = MIN2(currentFrame - pageFrames[page], (ui32)SVO_MAX_PAGE_AGE);
+
+			if (age > maxAge || (age == maxAge && maxAgeEvictCount))
+			{
+				if (age == maxAge)
+					maxAgeEvictCount--;
+
+				Win32EvictMappedMemory(blockDescriptor.block + (ui64)page * SVO_PAGE_WORDS, SVO_PAGE_SIZE);
+				pageFrames[page] = 0;
+				residentPages[page] = false;
+				residency.evictedPages++;
+			}
+			else
+				residentPageIds[residentCount++] = page;
+		}
+		residentPageIds.currentCount = residentCount;
+	}
+
+	residency.residentPages = residentPageIds.currentCount;
+
+	// frame 0 means page is not resident
+	if (!++currentFrame)
+		currentFrame = 1;
+}
+
+void SVO::ShowStats()
+{
+	using namespace Common::Strings;
+
+	char tmpBuffer[256] = {};
+	char tmpBuffer2[256] = {};
+
+	if (numOfBlocksCreated)
+	{
+		LOG_TL(LogLevel::Info, "SVO statistics:");
+		LOG_TL(LogLevel::Info, "\tblocks created:\t\t%I64d", numOfBlocksCreated);
+		LOG_TL(LogLevel::Info, "\tnodes used:\t\t%I64d (avg %I64d/block)", numOfNodesUsed,
+			numOfNodesUsed / numOfBlocksCreated);
+		LOG_TL(LogLevel::Info, "\tfar pointers used:\t%I64d (avg %I64d/block)", numOfFarPtrsUsed,
+			numOfFarPtrsUsed / numOfBlocksCreated);
+		LOG_TL(LogLevel::Info, "\tmemory used:\t\tavg %s/block (octree nodes %s)",
+			GetMemSizeString(tmpBuffer, numOfWordsUsed * sizeof(ui32) / numOfBlocksCreated),
+			GetMemSizeString(tmpBuffer2, numOfOctreeNodesUsed * sizeof(OctreeNode) / numOfBlocksCreated));
+	}
+
+	if (numOfBlocksCompressed)
+	{
+		LOG_TL(LogLevel::Info, "\tblocks compressed:\t%I64d (ratio %.2f)", numOfBlocksCompressed,
+			(real)numOfWordsBeforeCompression / numOfWordsAfterCompression);
+		LOG_TL(LogLevel::Info, "\tdag memory used:\tavg %s/block",
+			GetMemSizeString(tmpBuffer, numOfWordsAfterCompression * sizeof(ui32) / numOfBlocksCompressed));
+	}
+
+	if (residency.pageFaults)
+	{
+		LOG_TL(LogLevel::Info, "SVO residency:");
+		LOG_TL(LogLevel::Info, "\tpage faults:\t\t%I64d", residency.pageFaults);
+		LOG_TL(LogLevel::Info, "\tevicted pages:\t\t%I64d", residency.evictedPages);
+	}
+}
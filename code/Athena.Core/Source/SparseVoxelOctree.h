@@ -1,117 +1,265 @@
-#pragma once
-
-#include <Object.h>
-
-// each block start is aligned to this size
-#define SVO_PAGE_SIZE						0x1000
-
-// get page header address from node address
-#define SVO_PAGE_HEADER(nodeAddress)		(nodeAddress & ~(SVO_PAGE_SIZE - 1))
-
-// get block info from page header address
-#define SVO_BLOCK_INFO(pageHeaderAddress)	(SVO_BlockInfo*)((*(int*)pageHeaderAddress) + pageHeaderAddress);
-
-// returns first possible address aligned to given size
-#define ALIGN_TO(address, pageLength)		((int*)(((int)address & ~(pageLength - 1)) + pageLength))
-
-
-#pragma pack(push, 1)
-
-struct SVO_BlockInfo
-{
-	// length of the whole block
-	int blockLength;
-
-	// number of voxel nodes
-	int nodeCount;
-
-	// relative offset to block start
-	int firstPageOffset;
-	// relative offset to block start from this block info
-	int nodesOffset;
-	// relative offset to material lookup entry table
-	int materialLookUpEntryOffset;
-	// relative offset to material table
-	int materialTableOffset;
-
-	// block cell
-	AACell cell;
-};
-
-// sizeof() = 4B
-struct SVO_Node
-{
-	// pointer to first child node
-	unsigned short childPtr : 15;
-	// if set to 1, next int is 32B ptr to first node child
-	unsigned short farPtr : 1;
-	// specifies position and number of child nodes
-	unsigned char validMask;
-	// specifies which of child nodes are actualy leaves
-	unsigned char leafMask;
-};
-
-struct SVO_BlockDescriptor
-{
-	int* buffer;
-	int bufferLength;
-
-	inline const int* GetBlock() const 
-	{ 
-		return ((int)buffer % SVO_PAGE_SIZE == 0) ? buffer : ALIGN_TO(buffer, SVO_PAGE_SIZE);
-	}
-
-	inline const SVO_BlockInfo* GetBlockInfo() const
-	{ 
-		const int* block = GetBlock();
-		return (SVO_BlockInfo*)((int)block + *block);
-	}
-};
-
-// sizeof() = 4B
-struct SVO_MaterialLookUpEntry
-{
-	// poiter to material
-	unsigned int ptrToMaterial : 24;
-	// 
-	unsigned int validMask : 8;
-};
-
-
-// sizeof() = 8B
-struct SVO_Material
-{
-	// voxel color
-	vector4b color;
-	// voxel normal, positive or negative space
-	unsigned int sign : 1;
-	// voxel normal axis
-	unsigned int axis : 2;
-	// voxel normal u-coordinate on unit cube
-	unsigned int u : 15;
-	// voxel normal v-coordinate on unit cube
-	unsigned int v : 14;
-};
-
-#pragma pack(pop)
-
-
-class SVO : public Singleton<SVO>
-{
-public:
-
-	SVO();
-	~SVO();
-
-	SVO_BlockDescriptor CreateBlock(const VoxelOctree* voxelOctree);
-	
-	bool CheckBlock(const SVO_BlockDescriptor& blockDescriptor);
-
-	void WriteToFile(const char* directory, const SVO_BlockDescriptor& blockDescriptor);
-	SVO_BlockDescriptor ReadFromFile(const char* fileName);
-
-private:
-
-	int ProcessChildNodes(const OctreeNode* octreeNode, const SVO_Node* parentNode, SVO_Node* nextSvoNode);
-	void FixPageHeaders(SVO_BlockDescriptor& blockDescriptor);
-};
+#ifndef __sparse_voxel_octree_h
+#define __sparse_voxel_octree_h
+
+#include "AACell.h"
+#include "Array.h"
+#include <atomic>
+#include "List.h"
+#include "Octree.h"
+#include "TypeDefs.h"
+#include "Vectors.h"
+
+// block is made of pages, each one starts with page header (index of the page in block)
+#define SVO_PAGE_SIZE					0x1000
+#define SVO_PAGE_WORDS					(SVO_PAGE_SIZE / sizeof(ui32))
+// farthest child group reachable by childPtr, further ones are referenced through far pointer
+#define SVO_MAX_CHILD_OFFSET			0x7fff
+// voxel positions are integers at resolution of leaves
+#define SVO_MAX_DEPTH					30
+// material table pages hold materials (2 words each) after page header
+#define SVO_PAGE_MATERIALS				((SVO_PAGE_WORDS - 1) / 2)
+
+// block file is the block itself, it is memory mapped read-only
+#define SVO_BLOCK_MAGIC					0x4f565341 // "ASVO"
+#define SVO_BLOCK_VERSION				3
+// use of mapped pages is tracked per frame, chunks of pages not used in last frame are skipped
+#define SVO_PAGES_PER_CHUNK				64
+// pages not used for more frames are all the least recently used ones
+#define SVO_MAX_PAGE_AGE				63
+
+
+#pragma pack(push, 1)
+
+// stored right after the first page header, offsets are in words (4B) relative to block start
+struct SVO_BlockInfo
+{
+	ui32 magic;
+	ui32 version;
+
+	// length of the whole block, multiple of SVO_PAGE_WORDS
+	ui64 blockLength;
+
+	// number of svo nodes
+	ui64 nodeCount;
+	// number of svo nodes stored in block, lower than nodeCount when identical subtrees are shared (dag)
+	ui64 uniqueNodeCount;
+	// level of leaves (voxels), root node is level 0
+	ui32 depth;
+	// number of far pointers
+	ui32 farPtrCount;
+
+	// root node
+	ui64 nodesOffset;
+	// material look-up entry table, 0 when block has no materials, entry of node is at the same position
+	// in the table as the node in block
+	ui64 materialLookUpEntryOffset;
+	// material table, 0 when block has no materials
+	ui64 materialTableOffset;
+
+	// block cell
+	AACell cell;
+
+	// hash of octree voxels (and dag flag) the block was created from, streamed block file is mapped again
+	// instead of creating the block when it has the same hash
+	ui64 sourceHash;
+};
+
+// sizeof() = 4B
+struct SVO_Node
+{
+	// relative offset (in words) to the first child node, or to far pointer when farPtr is set
+	ui16 childPtr : 15;
+	// if set to 1, childPtr points to signed 32b relative offset (from far pointer) of the first child node
+	ui16 farPtr : 1;
+	// specifies position and number of child nodes
+	ui8 validMask;
+	// specifies which of child nodes are actualy leaves
+	ui8 leafMask;
+};
+
+// sizeof() = 4B
+struct SVO_MaterialLookUpEntry
+{
+	// index of material of the first child in material table
+	ui32 ptrToMaterial : 24;
+	// children with material, their materials are stored in order of mask bits
+	ui32 validMask : 8;
+};
+
+// sizeof() = 8B
+struct SVO_Material
+{
+	// voxel color
+	v4b color;
+	// voxel normal, positive or negative space
+	ui32 sign : 1;
+	// voxel normal axis
+	ui32 axis : 2;
+	// voxel normal u-coordinate on unit cube
+	ui32 u : 15;
+	// voxel normal v-coordinate on unit cube
+	ui32 v : 14;
+};
+
+#pragma pack(pop)
+
+// non-leaf children of node are stored contiguously (in order of validMask bits) followed by their
+// far pointers, such group never crosses page boundary
+struct SVO_BlockDescriptor
+{
+	// allocated memory, block starts at the first address aligned to SVO_PAGE_SIZE
+	array_of<ui8> buffer;
+	ui32* block;
+
+	inline const SVO_BlockInfo* GetBlockInfo() const { return (const SVO_BlockInfo*)(block + 1); }
+	inline const SVO_Node* GetNode(ui64 word) const { return (const SVO_Node*)(block + word); }
+
+	inline ui64 GetGroupWord(ui64 nodeWord) const
+	{
+		const SVO_Node& node = *GetNode(nodeWord);
+
+		ui64 groupWord = nodeWord + node.childPtr;
+		if (node.farPtr)
+			groupWord += (i64)(i32)block[groupWord];
+
+		return groupWord;
+	}
+
+	inline const SVO_MaterialLookUpEntry* GetMaterialLookUpEntry(ui64 nodeWord) const
+	{
+		return (const SVO_MaterialLookUpEntry*)(block + GetBlockInfo()->materialLookUpEntryOffset + nodeWord);
+	}
+
+	inline const SVO_Material* GetMaterial(ui32 index) const
+	{
+		return (const SVO_Material*)(block + GetBlockInfo()->materialTableOffset +
+			index / SVO_PAGE_MATERIALS * SVO_PAGE_WORDS + 1 + index % SVO_PAGE_MATERIALS * 2);
+	}
+};
+
+// pages of mapped block are read by OS when traversal touches them, the least recently used ones are evicted
+// from memory when there are more than residency budget
+struct SVO_Residency
+{
+	ui64 pageCount;
+	ui64 residentPages;
+	// pages touched while they were not resident
+	ui64 pageFaults;
+	ui64 evictedPages;
+};
+
+DLL_EXPORT_ARRAY_OF(ui8);
+DLL_EXPORT_ARRAY_OF(std::atomic<ui32>);
+
+
+class MemoryManager;
+struct Ray;
+struct HitResult;
+struct AthenaStorage;
+struct win32_mapped_file;
+struct SVO_Dag;
+
+class DLL_EXPORT SVO
+{
+public:
+
+	void Initialize(MemoryManager* memoryManagerInstance);
+	void Destroy(MemoryManager* memoryManagerInstance);
+	// block is created again from voxels of octree whenever the tree was constructed or loaded, with svoDag
+	// identical subtrees are merged, with svoStreaming it is written to fileName and used through read-only
+	// mapping, existing fileName created from the same voxels is mapped without creating the block,
+	// residency of mapped pages is updated each frame
+	bool Update(const Octree* octree, AthenaStorage* athenaStorage, const char* fileName);
+
+	void Hit(const Ray& ray, HitResult& hitResult) const;
+	bool Collide(const Ray& ray, real from = EPSILON, real to = _INFINITY) const;
+
+	bool CheckBlock() const;
+
+	void WriteToFile(const char* fileName) const;
+
+	uint GetCurrentNodeCount() const { return blockDescriptor.block ? (uint)blockInfo.nodeCount : 0; }
+	const SVO_Residency& GetResidency() const { return residency; }
+	// size of created block divided by size of its dag, 1 when block is not compressed
+	const real& GetCompressionRatio() const { return compressionRatio; }
+
+private:
+
+	// hash of voxels of octree and build options, stored in block info as sourceHash
+	ui64 GetSourceHash(const Octree* octree, b32 dag) const;
+	void CreateBlock(const Octree* octree);
+	// block is replaced by directed acyclic graph, where identical subtrees (including materials) are stored once
+	void CompressBlock();
+	// block is made of words padded to whole pages, blockInfo is written after the first page header
+	void SetBlock(list_of<ui32>& words);
+	bool MapBlock(const char* fileName);
+	// frees created block or unmaps mapped one
+	void DestroyBlock();
+	// returns first word of group which fits into one page, page headers are written when page is entered
+	ui64 AllocateGroup(list_of<ui32>& words, ui32 wordCount);
+	// writes group of children of octree node and links it from svo node at nodeWord, returns far pointer count
+	// look-up entries of nodes reference voxel attributes of octree (childVoxelIds) when it has them
+	ui32 ProcessChildNodes(list_of<ui32>& words, const OctreeNode* octreeNodes, const array_of<ui64>& descendants,
+		const ui32* childVoxelIds, list_of<ui32>& lookUpEntries, ui32 octreeNodeId, ui64 nodeWord);
+	// node at nodeWord references group directly or through its far pointer
+	void LinkGroup(list_of<ui32>& words, ui64 nodeWord, ui64 groupWord);
+	// returns unique id of subtree of node, subtrees are hashed bottom-up
+	ui32 DeduplicateNode(SVO_Dag& dag, ui64 nodeWord);
+	// writes group of children of unique node (once) and links it from svo node at nodeWord,
+	// returns far pointer count
+	ui32 ProcessDagChildNodes(list_of<ui32>& words, SVO_Dag& dag, ui32 uniqueId, ui64 nodeWord);
+	// look-up entry table (same length as words) and material table are appended after nodes
+	void AppendMaterialTables(list_of<ui32>& words, const list_of<ui32>& lookUpEntries,
+		const list_of<SVO_Material>& materials);
+
+	// stack based traversal (Laine & Karras, Efficient Sparse Voxel Octrees), ray is mirrored
+	// to positive directions, finds the nearest leaf overlapping (from, to)
+	// traversal stops above leaves at children smaller than voxelLodFraction of ray footprint,
+	// hit child is reported by its parent node and bit of valid mask
+	bool CastRay(const Ray& ray, real from, real to, real& tEntry, real& tExit, ui32& entryAxis,
+		ui32& exitAxis, ui64& hitNodeWord, ui32& hitChildBit, uint& nodeTestCount) const;
+	// material of child of node at nodeWord, null when block has no materials
+	const SVO_Material* GetChildMaterial(ui64 nodeWord, ui32 childBit) const;
+
+	inline void TouchPage(ui64 page) const;
+	void UpdateResidency(ui32 pageBudget);
+
+	void ShowStats();
+
+private:
+
+	// statistics
+	ui64 numOfBlocksCreated;
+	ui64 numOfNodesUsed;
+	ui64 numOfFarPtrsUsed;
+	ui64 numOfWordsUsed;
+	ui64 numOfOctreeNodesUsed;
+	ui64 numOfBlocksCompressed;
+	ui64 numOfWordsBeforeCompression;
+	ui64 numOfWordsAfterCompression;
+
+	// build number of octree the block was created from
+	ui64 currentOctreeBuildNumber;
+	b32 currentStreaming;
+	b32 currentDag;
+	real compressionRatio;
+	real currentLodFraction;
+
+	SVO_BlockDescriptor blockDescriptor;
+	// copy of block info, so mapped block is not accessed by each ray
+	SVO_BlockInfo blockInfo;
+	win32_mapped_file* mappedFile;
+
+	// frame of the last use of each mapped page (0 when it is not resident) and of each chunk of pages,
+	// written by all rendering threads
+	array_of<std::atomic<ui32>> pageFrames;
+	array_of<std::atomic<ui32>> chunkFrames;
+	array_of<ui8> residentPages;
+	list_of<ui32> residentPageIds;
+	ui32 currentFrame;
+	SVO_Residency residency;
+
+	MemoryManager* memoryManagerInstance;
+};
+
+#endif __sparse_voxel_octree_h
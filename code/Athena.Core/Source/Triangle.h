@@ -1,167 +1,219 @@
-#ifndef __triangle_h
-#define __triangle_h
-
-#include "AACell.h"
-#include "Object.h"
-#include "Ray.h"
-#include "TypeDefs.h"
-#include "Vectors.h"
-
-#define BACKFACE_CULLING_ENABLED
-
-
-struct Triangle : Object
-{
-	v3i v;	// vertex indices
-	v3i vn;	// vertex normal indices
-	v3i tc;	// texture coords indices
-	v3f normal;
-
-	int materialIndex;
-
-	__device__ Triangle()
-	{
-
-	}
-
-	__device__ Triangle(v3i& vertexIndices) : v(vertexIndices)
-	{
-
-	}
-
-	__device__ real Hit(const Ray& ray, const array_of<v3f>& vertices) const
-	{
-		// Fast, minimum storage, ray triangle intersection
-		// Tomas Moller, Ben Trumbore
-
-		v3f v0 = vertices[v.x] + position;
-		v3f v1 = vertices[v.y] + position;
-		v3f v2 = vertices[v.z] + position;
-
-		v3f edge1 = v1 - v0;
-		v3f edge2 = v2 - v0;
-
-		// begin calculating determinant - also used to calculate U parameter
-		v3f pvec = vectors::Cross(ray.direction, edge2);
-
-		// if determinant is near zero, ray lies in plane of triangle
-		const real det = vectors::Dot(edge1, pvec);
-
-#ifdef BACKFACE_CULLING_ENABLED
-		if (det < EPSILON)
-			return _INFINITY;
-
-		// calculate distance from vert0 to ray origin
-		v3f tvec = ray.origin - v0;
-
-		// calculate U parameter and test bounds
-		const real u = vectors::Dot(tvec, pvec);
-		if (u < 0 || u > det)
-			return _INFINITY;
-
-		// prepare to test V parameter
-		v3f qvec = vectors::Cross(tvec, edge1);
-
-		// calculate V parameter and test bounds
-		const real v = vectors::Dot(ray.direction, qvec);
-		if (v < 0 || (u + v) > det)
-			return _INFINITY;
-
-		const real inv_det = 1 / det;
-
-		//barycentric.u = u * inv_det;
-		//barycentric.v = v * inv_det;
-
-		// calculate t, scale parameters, ray intersects triangle
-		return vectors::Dot(edge2, qvec) * inv_det;
-#else
-		if (det > -EPSILON && det < EPSILON)
-			return _INFINITY;
-
-		const real inv_det = 1 / det;
-
-		// calculate distance from vert0 to ray origin
-		v3f tvec = ray.origin - v0;
-
-		// calculate U parameter and test bounds
-		const real u = vectors::Dot(tvec, pvec) * inv_det;
-		if (u < 0 || u > 1)
-			return _INFINITY;
-
-		// prepare to test V parameter
-		v3f qvec = vectors::Cross(tvec, edge1);
-
-		// calculate V parameter and test bounds
-		const real v = vectors::Dot(ray.direction, qvec) * inv_det;
-		if (v < 0 || (u + v) > 1)
-			return _INFINITY;
-
-		//barycentric.u = u;
-		//barycentric.v = v;
-
-		// calculate t, ray intersects triangle
-		return vectors::Dot(edge2, qvec) * inv_det;
-#endif
-	}
-
-	__device__ bool Collide(const Ray& ray, const array_of<v3f>& vertices, real from = EPSILON, real to = _INFINITY) const
-	{
-		v3f v0 = vertices[v.x] + position;
-		v3f v1 = vertices[v.y] + position;
-		v3f v2 = vertices[v.z] + position;
-
-		v3f edge1 = v1 - v0;
-		v3f edge2 = v2 - v0;
-
-		// begin calculating determinant - also used to calculate U parameter
-		v3f pvec = vectors::Cross(ray.direction, edge2);
-
-		// if determinant is near zero, ray lies in plane of triangle
-		const real det = vectors::Dot(edge1, pvec);
-		if (ABS(det) < EPSILON)
-			return false;
-
-		// calculate distance from vert0 to ray origin
-		v3f tvec = ray.origin - v0;
-
-		// calculate U parameter and test bounds
-		const real u = vectors::Dot(tvec, pvec);
-		if (u < 0 || u > det)
-			return false;
-
-		// prepare to test V parameter
-		v3f qvec = vectors::Cross(tvec, edge1);
-
-		// calculate V parameter and test bounds
-		const real v = vectors::Dot(ray.direction, qvec);
-		if (v < 0 || (u + v) > det)
-			return false;
-
-		// calculate t, scale parameters, ray intersects triangle
-		const real t = vectors::Dot(edge2, qvec) / det;
-		if (t < from || t > to)
-			return false;
-
-		return true;
-	}
-
-	__device__ bool IsInside(const v3f& point, const array_of<v3f>& vertices) const
-	{
-		v3f tmpPoint = vertices[v.x] + position;
-		return vectors::Dot(normal, point) - vectors::Dot(normal, tmpPoint) < 0;
-	}
-
-	__device__ void GetNormalAt(const v3f& point, const array_of<v3f>& vertices, v3f& normal) const
-	{
-		// TODO compute vertex normal at hit point
-		normal = this->normal;
-	}
-
-	__device__ void UpdateNormal(const array_of<v3f>& vertices)
-	{
-		normal = vectors::Cross(vertices[v.x] - vertices[v.y], vertices[v.z] - vertices[v.y]);
-		vectors::Normalize(normal);
-	}
-};
-
-#endif __triangle_h
+#ifndef __triangle_h
+#define __triangle_h
+
+#include "AACell.h"
+#include "Object.h"
+#include "Ray.h"
+#include "TypeDefs.h"
+#include "Vectors.h"
+
+#define BACKFACE_CULLING_ENABLED
+
+
+struct Triangle : Object
+{
+	v3i v;	// vertex indices
+	v3i vn;	// vertex normal indices
+	v3i tc;	// texture coords indices
+	v3f normal;
+
+	int materialIndex;
+
+	__device__ Triangle()
+	{
+
+	}
+
+	__device__ Triangle(v3i& vertexIndices) : v(vertexIndices)
+	{
+
+	}
+
+	__device__ real Hit(const Ray& ray, const array_of<v3f>& vertices) const
+	{
+		return Hit(ray, vertices[v.x] + position, vertices[v.y] + position, vertices[v.z] + position);
+	}
+
+	static __device__ real Hit(const Ray& ray, const v3f& v0, const v3f& v1, const v3f& v2)
+	{
+		// Fast, minimum storage, ray triangle intersection
+		// Tomas Moller, Ben Trumbore
+
+		v3f edge1 = v1 - v0;
+		v3f edge2 = v2 - v0;
+
+		// begin calculating determinant - also used to calculate U parameter
+		v3f pvec = vectors::Cross(ray.direction, edge2);
+
+		// if determinant is near zero, ray lies in plane of triangle
+		const real det = vectors::Dot(edge1, pvec);
+
+#ifdef BACKFACE_CULLING_ENABLED
+		if (det < EPSILON)
+			return _INFINITY;
+
+		// calculate distance from vert0 to ray origin
+		v3f tvec = ray.origin - v0;
+
+		// calculate U parameter and test bounds
+		const real u = vectors::Dot(tvec, pvec);
+		if (u < 0 || u > det)
+			return _INFINITY;
+
+		// prepare to test V parameter
+		v3f qvec = vectors::Cross(tvec, edge1);
+
+		// calculate V parameter and test bounds
+		const real v = vectors::Dot(ray.direction, qvec);
+		if (v < 0 || (u + v) > det)
+			return _INFINITY;
+
+		const real inv_det = 1 / det;
+
+		//barycentric.u = u * inv_det;
+		//barycentric.v = v * inv_det;
+
+		// calculate t, scale parameters, ray intersects triangle
+		return vectors::Dot(edge2, qvec) * inv_det;
+#else
+		if (det > -EPSILON && det < EPSILON)
+			return _INFINITY;
+
+		const real inv_det = 1 / det;
+
+		// calculate distance from vert0 to ray origin
+		v3f tvec = ray.origin - v0;
+
+		// calculate U parameter and test bounds
+		const real u = vectors::Dot(tvec, pvec) * inv_det;
+		if (u < 0 || u > 1)
+			return _INFINITY;
+
+		// prepare to test V parameter
+		v3f qvec = vectors::Cross(tvec, edge1);
+
+		// calculate V parameter and test bounds
+		const real v = vectors::Dot(ray.direction, qvec) * inv_det;
+		if (v < 0 || (u + v) > 1)
+			return _INFINITY;
+
+		//barycentric.u = u;
+		//barycentric.v = v;
+
+		// calculate t, ray intersects triangle
+		return vectors::Dot(edge2, qvec) * inv_det;
+#endif
+	}
+
+	__device__ bool Collide(const Ray& ray, const array_of<v3f>& vertices, real from = EPSILON, real to = _INFINITY) const
+	{
+		return Collide(ray, vertices[v.x] + position, vertices[v.y] + position, vertices[v.z] + position, from, to);
+	}
+
+	static __device__ bool Collide(const Ray& ray, const v3f& v0, const v3f& v1, const v3f& v2,
+		real from = EPSILON, real to = _INFINITY)
+	{
+		v3f edge1 = v1 - v0;
+		v3f edge2 = v2 - v0;
+
+		// begin calculating determinant - also used to calculate U parameter
+		v3f pvec = vectors::Cross(ray.direction, edge2);
+
+		// if determinant is near zero, ray lies in plane of triangle
+		const real det = vectors::Dot(edge1, pvec);
+		if (ABS(det) < EPSILON)
+			return false;
+
+		// calculate distance from vert0 to ray origin
+		v3f tvec = ray.origin - v0;
+
+		// calculate U parameter and test bounds
+		const real u = vectors::Dot(tvec, pvec);
+		if (u < 0 || u > det)
+			return false;
+
+		// prepare to test V parameter
+		v3f qvec = vectors::Cross(tvec, edge1);
+
+		// calculate V parameter and test bounds
+		const real v = vectors::Dot(ray.direction, qvec);
+		if (v < 0 || (u + v) > det)
+			return false;
+
+		// calculate t, scale parameters, ray intersects triangle
+		const real t = vectors::Dot(edge2, qvec) / det;
+		if (t < from || t > to)
+			return false;
+
+		return true;
+	}
+
+	// triangle/box overlap (Akenine-Moller), triangle is separated from cell by one of 13 axes:
+	// cell axes, triangle normal or cross product of cell axis and triangle edge
+	static __device__ bool AndAACell(const v3f& v0, const v3f& v1, const v3f& v2, const AACell& cell)
+	{
+		const v3f center = (cell.minCorner + cell.maxCorner) * .5;
+		const v3f halfSize = (cell.maxCorner - cell.minCorner) * .5;
+
+		// cell is moved to origin
+		const v3f vertices[3] = { v0 - center, v1 - center, v2 - center };
+		const v3f edges[3] = { vertices[1] - vertices[0], vertices[2] - vertices[1], vertices[0] - vertices[2] };
+
+		for (ui32 i = 0; i < 3; ++i)
+		{
+			if (MIN3(vertices[0].Get(i), vertices[1].Get(i), vertices[2].Get(i)) > halfSize.Get(i) ||
+				MAX3(vertices[0].Get(i), vertices[1].Get(i), vertices[2].Get(i)) < -halfSize.Get(i))
+				return false;
+		}
+
+		v3f axis = vectors::Cross(edges[0], edges[1]);
+		if (!AndAxis(vertices, axis, halfSize))
+			return false;
+
+		for (ui32 i = 0; i < 3; ++i)
+		{
+			for (ui32 j = 0; j < 3; ++j)
+			{
+				v3f cellAxis;
+				cellAxis[j] = 1;
+
+				axis = vectors::Cross(cellAxis, edges[i]);
+				if (!AndAxis(vertices, axis, halfSize))
+					return false;
+			}
+		}
+
+		return true;
+	}
+
+	// projections of triangle and cell (centered at origin) to axis overlap
+	static __device__ bool AndAxis(const v3f* vertices, const v3f& axis, const v3f& halfSize)
+	{
+		const real p0 = vectors::Dot(vertices[0], axis);
+		const real p1 = vectors::Dot(vertices[1], axis);
+		const real p2 = vectors::Dot(vertices[2], axis);
+		const real r = halfSize.x * ABS(axis.x) + halfSize.y * ABS(axis.y) + halfSize.z * ABS(axis.z);
+
+		return MIN3(p0, p1, p2) <= r && MAX3(p0, p1, p2) >= -r;
+	}
+
+	__device__ bool IsInside(const v3f& point, const array_of<v3f>& vertices) const
+	{
+		v3f tmpPoint = vertices[v.x] + position;
+		return vectors::Dot(normal, point) - vectors::Dot(normal, tmpPoint) < 0;
+	}
+
+	__device__ void GetNormalAt(const v3f& point, const array_of<v3f>& vertices, v3f& normal) const
+	{
+		// TODO compute vertex normal at hit point
+		normal = this->normal;
+	}
+
+	__device__ void UpdateNormal(const array_of<v3f>& vertices)
+	{
+		normal = vectors::Cross(vertices[v.x] - vertices[v.y], vertices[v.z] - vertices[v.y]);
+		vectors::Normalize(normal);
+	}
+};
+
+#endif __triangle_h
@@ -0,0 +1,599 @@
+#include "Athena.h"
+#include "HitResult.h"
+#include "Log.h"
+#include "MemoryManager.h"
+#include "Objects.h"
+#include "Ray.h"
+#include "Rendering.h"
+#include "StringHelpers.h"
+#include "Timer.h"
+#include "Timers.h"
+#include "UniformGrid.h"
+#include <cfloat>
+
+
+void UniformGrid::Initialize(Objects* objects, MemoryManager* memoryManagerInstance)
+{
+	numOfGridsConstructed = numOfCellsUsed = numOfReferencesUsed = 0;
+	currentObjectsVersion = 0;
+	currentCellsPerObject = 0;
+
+	rootCell.SetEmpty();
+	resolution.Set(0, 0, 0);
+
+	cellStarts = array_of<ui32>();
+	references = array_of<ObjectId>();
+	cellCount = referenceCount = 0;
+
+	objectCells = array_of<AACell>();
+	objectRanges = array_of<GridObjectRange>();
+	taskCount = 0;
+
+	this->objects = objects;
+	this->memoryManagerInstance = memoryManagerInstance;
+}
+
+void UniformGrid::Destroy(MemoryManager* memoryManagerInstance)
+{
+	if (this->memoryManagerInstance)
+	{
+		ShowStats();
+
+		_MEM_FREE_ARRAY(memoryManagerInstance, ui32, &cellStarts);
+		_MEM_FREE_ARRAY(memoryManagerInstance, ObjectId, &references);
+		_MEM_FREE_ARRAY(memoryManagerInstance, AACell, &objectCells);
+		_MEM_FREE_ARRAY(memoryManagerInstance, GridObjectRange, &objectRanges);
+		cellCount = referenceCount = 0;
+
+		objects = null;
+		this->memoryManagerInstance = null;
+
+		LOG_DEBUG("UniformGrid::Destroy");
+	}
+}
+
+bool UniformGrid::Update(array_of<std::thread>& threads, bool sceneChanged, AthenaStorage* athenaStorage)
+{
+	TIMED_BLOCK(&athenaStorage->timers[TimerId::GridConstruction]);
+
+	const RenderingParameters& parameters = athenaStorage->renderingParameters;
+
+	if (parameters.tracingMethod != TracingMethod::UniformGrid)
+	{
+		Clear();
+		return false;
+	}
+
+	real cellsPerObject = parameters.gridCellsPerObject;
+	CLAMP(cellsPerObject, GRID_MIN_CELLS_PER_OBJECT, GRID_MAX_CELLS_PER_OBJECT);
+
+	// existing grid can be reused if it was built with the same density for the same objects
+	if (!sceneChanged && cellCount && cellsPerObject == currentCellsPerObject &&
+		objects->version == currentObjectsVersion)
+		return true;
+
+	currentCellsPerObject = cellsPerObject;
+
+	return Construct(threads);
+}
+
+void UniformGrid::Clear()
+{
+	cellCount = referenceCount = 0;
+	currentObjectsVersion = 0;
+}
+
+bool UniformGrid::Construct(array_of<std::thread>& threads)
+{
+	Clear();
+
+	const uint objectCount = objects->everything.currentCount;
+	if (!objectCount)
+		return false;
+
+	// buffers are kept for next constructions, dynamic scene is constructed each frame
+	if (objectCells.count < objectCount)
+	{
+		_MEM_FREE_ARRAY(memoryManagerInstance, AACell, &objectCells);
+		objectCells = _MEM_ALLOC_ARRAY(memoryManagerInstance, AACell, objectCount);
+		_MEM_FREE_ARRAY(memoryManagerInstance, GridObjectRange, &objectRanges);
+		objectRanges = _MEM_ALLOC_ARRAY(memoryManagerInstance, GridObjectRange, objectCount);
+	}
+
+	// one task per thread, small scenes are constructed on calling thread
+	taskCount = 1;
+	if (objectCount >= 2 * GRID_MIN_BUILD_TASK_OBJECTS)
+		taskCount = MAX2(MIN2(threads.count, GRID_MAX_BUILD_TASKS), 1);
+
+	for (uint i = 0; i < taskCount; ++i)
+	{
+		GridBuildTask& task = tasks[i];
+		task.firstObjectId = objectCount * i / taskCount;
+		task.objectCount = objectCount * (i + 1) / taskCount - task.firstObjectId;
+	}
+
+	RunTasks(threads, &UniformGrid::ComputeObjectCells);
+
+	rootCell.SetEmpty();
+	uint boundedObjectCount = 0;
+	for (uint i = 0; i < taskCount; ++i)
+	{
+		rootCell.Add(tasks[i].cell);
+		boundedObjectCount += tasks[i].boundedObjectCount;
+	}
+
+	// only planes or point lights
+	if (!boundedObjectCount)
+		return false;
+
+	UpdateResolution(boundedObjectCount);
+
+	RunTasks(threads, &UniformGrid::ComputeObjectRanges);
+
+	// cell counts are stored at position of next cell, first cell starts at 0
+	cellCount = resolution.x * resolution.y * resolution.z;
+	if (cellStarts.count < cellCount + 1)
+	{
+		_MEM_FREE_ARRAY(memoryManagerInstance, ui32, &cellStarts);
+		cellStarts = _MEM_ALLOC_ARRAY(memoryManagerInstance, ui32, (cellCount + 1) * 2);
+	}
+	cellStarts[0] = 0;
+
+	// cells are split evenly, objects are spread evenly too
+	for (uint i = 0; i < taskCount; ++i)
+	{
+		GridBuildTask& task = tasks[i];
+		task.firstCellId = (ui32)((uint)cellCount * i / taskCount);
+		task.cellCount = (ui32)((uint)cellCount * (i + 1) / taskCount) - task.firstCellId;
+	}
+
+	RunTasks(threads, &UniformGrid::CountReferences);
+
+	for (uint i = 0; i < taskCount; ++i)
+	{
+		tasks[i].firstReferenceId = referenceCount;
+		referenceCount += tasks[i].referenceCount;
+	}
+
+	if (references.count < referenceCount)
+	{
+		_MEM_FREE_ARRAY(memoryManagerInstance, ObjectId, &references);
+		references = _MEM_ALLOC_ARRAY(memoryManagerInstance, ObjectId, referenceCount * 2);
+	}
+
+	RunTasks(threads, &UniformGrid::ScatterReferences);
+
+	currentObjectsVersion = objects->version;
+
+	numOfGridsConstructed++;
+	numOfCellsUsed += cellCount;
+	numOfReferencesUsed += referenceCount;
+
+	return true;
+}
+
+void UniformGrid::UpdateResolution(uint objectCount)
+{
+	const v3f size = rootCell.maxCorner - rootCell.minCorner;
+	const real cellCount = MIN2(currentCellsPerObject * objectCount, (real)GRID_MAX_CELLS);
+
+	// cells are cubes, axes thinner than one cell are not split and the other axes share all cells
+	ui32 splitAxes = 7;
+	real cellEdge = 0;
+	while (splitAxes)
+	{
+		real volume = 1;
+		ui32 axisCount = 0;
+		for (ui32 axis = 0; axis < 3; ++axis)
+		{
+			if (splitAxes & (1 << axis))
+			{
+				volume *= size.Get(axis);
+				axisCount++;
+			}
+		}
+
+		cellEdge = pow(volume / cellCount, (real)1 / axisCount);
+
+		ui32 thinAxes = 0;
+		for (ui32 axis = 0; axis < 3; ++axis)
+			if ((splitAxes & (1 << axis)) && (size.Get(axis) <= 0 || size.Get(axis) < cellEdge))
+				thinAxes |= 1 << axis;
+
+		if (!thinAxes)
+			break;
+
+		splitAxes &= ~thinAxes;
+	}
+
+	for (ui32 axis = 0; axis < 3; ++axis)
+	{
+		ui32 axisResolution = 1;
+		if (splitAxes & (1 << axis))
+			axisResolution = (ui32)(size.Get(axis) / cellEdge + .5);
+		CLAMP(axisResolution, 1, GRID_MAX_RESOLUTION);
+
+		resolution[axis] = axisResolution;
+		cellSize[axis] = size.Get(axis) / axisResolution;
+		// flat grid has all objects in one cell layer
+		invCellSize[axis] = cellSize[axis] > 0 ? 1 / cellSize[axis] : 0;
+	}
+}
+
+void UniformGrid::RunTasks(array_of<std::thread>& threads, void (UniformGrid::*step)(GridBuildTask*))
+{
+	if (taskCount == 1)
+	{
+		(this->*step)(&tasks[0]);
+		return;
+	}
+
+	for (uint i = 0; i < taskCount; ++i)
+		threads[i] = std::thread(step, this, &tasks[i]);
+	for (uint i = 0; i < taskCount; ++i)
+		threads[i].join();
+}
+
+void UniformGrid::ComputeObjectCells(GridBuildTask* task)
+{
+	task->cell.SetEmpty();
+	task->boundedObjectCount = 0;
+
+	for (uint i = task->firstObjectId; i < task->firstObjectId + task->objectCount; ++i)
+	{
+		AACell& objectCell = objectCells[i];
+		if (GetObjectCell(objects->everything[i], objectCell))
+		{
+			task->cell.Add(objectCell);
+			task->boundedObjectCount++;
+		}
+		else
+			objectCell.SetEmpty();
+	}
+}
+
+void UniformGrid::ComputeObjectRanges(GridBuildTask* task)
+{
+	for (uint i = task->firstObjectId; i < task->firstObjectId + task->objectCount; ++i)
+	{
+		const AACell& objectCell = objectCells[i];
+		GridObjectRange& range = objectRanges[i];
+
+		// object without bounds
+		if (objectCell.minCorner.Get(0) > objectCell.maxCorner.Get(0))
+		{
+			range.minCell[0] = 1;
+			range.maxCell[0] = 0;
+			continue;
+		}
+
+		for (ui32 axis = 0; axis < 3; ++axis)
+		{
+			const real minCell = (objectCell.minCorner.Get(axis) - rootCell.minCorner.Get(axis)) * invCellSize.Get(axis);
+			const real maxCell = (objectCell.maxCorner.Get(axis) - rootCell.minCorner.Get(axis)) * invCellSize.Get(axis);
+
+			range.minCell[axis] = (ui16)MIN2(MAX2(minCell, 0), resolution.Get(axis) - 1);
+			range.maxCell[axis] = (ui16)MIN2(MAX2(maxCell, 0), resolution.Get(axis) - 1);
+		}
+	}
+}
+
+void UniformGrid::CountReferences(GridBuildTask* task)
+{
+	ui32* counts = cellStarts.ptr + 1;
+	memset(counts + task->firstCellId, 0, task->cellCount * sizeof(ui32));
+	task->referenceCount = 0;
+
+	// all objects are checked, only their cells in range of task are counted
+	const ui32 endCellId = task->firstCellId + task->cellCount;
+	for (uint i = 0; i < objects->everything.currentCount; ++i)
+	{
+		const GridObjectRange& range = objectRanges[i];
+		if (range.minCell[0] > range.maxCell[0])
+			continue;
+
+		// objects outside of task cells are skipped without walking their rows
+		if (GetCellId(range.maxCell) < task->firstCellId || GetCellId(range.minCell) >= endCellId)
+			continue;
+
+		for (ui32 z = range.minCell[2]; z <= range.maxCell[2]; ++z)
+		{
+			for (ui32 y = range.minCell[1]; y <= range.maxCell[1]; ++y)
+			{
+				const ui32 rowId = (z * resolution.y + y) * resolution.x;
+				if (rowId + range.maxCell[0] < task->firstCellId || rowId + range.minCell[0] >= endCellId)
+					continue;
+
+				const ui32 firstX = MAX2(range.minCell[0], task->firstCellId > rowId ? task->firstCellId - rowId : 0);
+				const ui32 lastX = MIN2(range.maxCell[0], endCellId - 1 - rowId);
+				for (ui32 x = firstX; x <= lastX; ++x)
+					counts[rowId + x]++;
+
+				task->referenceCount += lastX - firstX + 1;
+			}
+		}
+	}
+}
+
+void UniformGrid::ScatterReferences(GridBuildTask* task)
+{
+	// counts are turned to starts shifted by one cell, each reference moves start of its cell, so it becomes
+	// start of next cell at the end
+	ui32* starts = cellStarts.ptr + 1;
+	ui32 start = (ui32)task->firstReferenceId;
+	for (ui32 cellId = task->firstCellId; cellId < task->firstCellId + task->cellCount; ++cellId)
+	{
+		const ui32 count = starts[cellId];
+		starts[cellId] = start;
+		start += count;
+	}
+
+	const ui32 endCellId = task->firstCellId + task->cellCount;
+	for (uint i = 0; i < objects->everything.currentCount; ++i)
+	{
+		const GridObjectRange& range = objectRanges[i];
+		if (range.minCell[0] > range.maxCell[0])
+			continue;
+
+		// objects outside of task cells are skipped without walking their rows
+		if (GetCellId(range.maxCell) < task->firstCellId || GetCellId(range.minCell) >= endCellId)
+			continue;
+
+		const ObjectId& objectId = objects->everything[i];
+		for (ui32 z = range.minCell[2]; z <= range.maxCell[2]; ++z)
+		{
+			for (ui32 y = range.minCell[1]; y <= range.maxCell[1]; ++y)
+			{
+				const ui32 rowId = (z * resolution.y + y) * resolution.x;
+				if (rowId + range.maxCell[0] < task->firstCellId || rowId + range.minCell[0] >= endCellId)
+					continue;
+
+				const ui32 firstX = MAX2(range.minCell[0], task->firstCellId > rowId ? task->firstCellId - rowId : 0);
+				const ui32 lastX = MIN2(range.maxCell[0], endCellId - 1 - rowId);
+				for (ui32 x = firstX; x <= lastX; ++x)
+					references[starts[rowId + x]++] = objectId;
+			}
+		}
+	}
+}
+
+bool UniformGrid::GetObjectCell(const ObjectId& objectId, AACell& objectCell) const
+{
+	switch (objectId.Type())
+	{
+		case ObjectType::Sphere:
+			GetWorldCell(objects->spheres[objectId.index], objectCell);
+			return true;
+
+		case ObjectType::Box:
+			GetWorldCell(objects->boxes[objectId.index], objectCell);
+			return true;
+
+		case ObjectType::Mesh:
+			GetWorldCell(objects->meshes[objectId.index], objectCell);
+			return true;
+
+		case ObjectType::MeshInstance:
+			GetWorldCell(objects->meshInstances[objectId.index], objectCell);
+			return true;
+
+		case ObjectType::SphereLightSource:
+			GetWorldCell(objects->sphereLights[objectId.index], objectCell);
+			return true;
+
+		case ObjectType::BoxLightSource:
+			GetWorldCell(objects->boxLights[objectId.index], objectCell);
+			return true;
+
+		case ObjectType::Plane:
+		case ObjectType::PointLightSource:
+			break;
+	}
+
+	return false;
+}
+
+bool UniformGrid::StartTraversal(const Ray& ray, real& tmin, real& tmax, ui32* cell, real* tNext, real* tDelta) const
+{
+	// NOTE when ray is parallel with slab t can be NaN, comparisons below keep interval unchanged then
+	for (ui32 axis = 0; axis < 3; ++axis)
+	{
+		const real origin = ray.origin.Get(axis);
+		const real invDirection = ray.invDirection.Get(axis);
+
+		const real tNear = ((ray.sign.Get(axis) ? rootCell.maxCorner.Get(axis) : rootCell.minCorner.Get(axis)) -
+			origin) * invDirection;
+		const real tFar = ((ray.sign.Get(axis) ? rootCell.minCorner.Get(axis) : rootCell.maxCorner.Get(axis)) -
+			origin) * invDirection;
+
+		if (tNear > tmin)
+			tmin = tNear;
+		if (tFar < tmax)
+			tmax = tFar;
+	}
+
+	if (tmin > tmax)
+		return false;
+
+	for (ui32 axis = 0; axis < 3; ++axis)
+	{
+		const real position = ray.origin.Get(axis) + ray.direction.Get(axis) * tmin;
+		const real entryCell = (position - rootCell.minCorner.Get(axis)) * invCellSize.Get(axis);
+		cell[axis] = (ui32)MIN2(MAX2(entryCell, 0), resolution.Get(axis) - 1);
+
+		// boundary of cell is never crossed by parallel ray
+		if (ray.direction.Get(axis) == 0)
+		{
+			tNext[axis] = DBL_MAX;
+			tDelta[axis] = 0;
+			continue;
+		}
+
+		const real boundary = rootCell.minCorner.Get(axis) +
+			(cell[axis] + (ray.sign.Get(axis) ? 0 : 1)) * cellSize.Get(axis);
+		tNext[axis] = (boundary - ray.origin.Get(axis)) * ray.invDirection.Get(axis);
+		tDelta[axis] = cellSize.Get(axis) * ABS(ray.invDirection.Get(axis));
+	}
+
+	return true;
+}
+
+void UniformGrid::Hit(const Ray& ray, HitResult& hitResult) const
+{
+	if (!cellCount)
+		return;
+
+	real tmin = EPSILON;
+	real tmax = hitResult.distance;
+	ui32 cell[3];
+	real tNext[3], tDelta[3];
+	if (!StartTraversal(ray, tmin, tmax, cell, tNext, tDelta))
+		return;
+
+	while (true)
+	{
+		HitCell(ray, GetCellId(cell), hitResult);
+
+		const ui32 axis = tNext[0] < tNext[1] ? (tNext[0] < tNext[2] ? 0 : 2) : (tNext[1] < tNext[2] ? 1 : 2);
+
+		// hit inside of cell is the closest one, objects of next cells are farther (objects overlapping more cells
+		// are tested again in the cell of their hit)
+		if (hitResult.distance <= tNext[axis] || tNext[axis] > tmax)
+			return;
+
+		cell[axis] += ray.sign.Get(axis) ? -1 : 1;
+		if (cell[axis] >= resolution.Get(axis))
+			return;
+
+		tNext[axis] += tDelta[axis];
+	}
+}
+
+void UniformGrid::HitCell(const Ray& ray, ui32 cellId, HitResult& hitResult) const
+{
+	hitResult.nodeTestCount++;
+
+	ObjectId innerObjectId;
+	for (ui32 i = cellStarts[cellId]; i < cellStarts[cellId + 1]; ++i)
+	{
+		real t;
+		const ObjectId& objectId = references[i];
+		switch (objectId.Type())
+		{
+			case ObjectType::Sphere: t = objects->spheres[objectId.index].Hit(ray); break;
+			case ObjectType::Box: t = objects->boxes[objectId.index].Hit(ray); break;
+			case ObjectType::SphereLightSource: t = objects->sphereLights[objectId.index].Hit(ray); break;
+			case ObjectType::BoxLightSource: t = objects->boxLights[objectId.index].Hit(ray); break;
+			case ObjectType::Mesh: t = objects->meshes[objectId.index].Hit(ray, innerObjectId); break;
+			case ObjectType::MeshInstance:
+			{
+				const MeshInstance& instance = objects->meshInstances[objectId.index];
+				t = instance.Hit(ray, objects->sharedMeshes[instance.meshIndex], innerObjectId);
+				break;
+			}
+
+			default:
+				t = _INFINITY;
+		}
+
+		if (t > EPSILON && t < hitResult.distance)
+		{
+			hitResult.distance = t;
+			hitResult.objectId = objectId;
+			if (objectId.Type() == ObjectType::Mesh || objectId.Type() == ObjectType::MeshInstance)
+				hitResult.innerObjectId = innerObjectId;
+		}
+	}
+
+	hitResult.intersectionCount += cellStarts[cellId + 1] - cellStarts[cellId];
+}
+
+bool UniformGrid::Collide(const Ray& ray, real from, real to, const ObjectId* objectIdToSkip) const
+{
+	if (!cellCount)
+		return false;
+
+	real tmin = from;
+	real tmax = to;
+	ui32 cell[3];
+	real tNext[3], tDelta[3];
+	if (!StartTraversal(ray, tmin, tmax, cell, tNext, tDelta))
+		return false;
+
+	while (true)
+	{
+		if (CollideCell(ray, GetCellId(cell), from, to, objectIdToSkip))
+			return true;
+
+		const ui32 axis = tNext[0] < tNext[1] ? (tNext[0] < tNext[2] ? 0 : 2) : (tNext[1] < tNext[2] ? 1 : 2);
+		if (tNext[axis] > tmax)
+			return false;
+
+		cell[axis] += ray.sign.Get(axis) ? -1 : 1;
+		if (cell[axis] >= resolution.Get(axis))
+			return false;
+
+		tNext[axis] += tDelta[axis];
+	}
+}
+
+bool UniformGrid::CollideCell(const Ray& ray, ui32 cellId, real from, real to, const ObjectId* objectIdToSkip) const
+{
+	bool collision = false;
+	for (ui32 i = cellStarts[cellId]; i < cellStarts[cellId + 1]; ++i)
+	{
+		const ObjectId& objectId = references[i];
+		if ((objectId.Type() != ObjectType::Mesh && objectId.Type() != ObjectType::MeshInstance) &&
+			(objectId.IsLight() || (objectIdToSkip != null && objectId._value == objectIdToSkip->_value)))
+			continue;
+
+		switch (objectId.Type())
+		{
+			case ObjectType::Sphere:
+				collision = objects->spheres[objectId.index].Collide(ray, from, to);
+				break;
+			case ObjectType::Box:
+				collision = objects->boxes[objectId.index].Collide(ray, from, to);
+				break;
+			case ObjectType::Mesh:
+				collision = objects->meshes[objectId.index].Collide(ray, from, to);
+				break;
+			case ObjectType::MeshInstance:
+			{
+				const MeshInstance& instance = objects->meshInstances[objectId.index];
+				collision = instance.Collide(ray, objects->sharedMeshes[instance.meshIndex], from, to);
+				break;
+			}
+
+			default:
+				break;
+		}
+
+		if (collision)
+			return true;
+	}
+
+	return false;
+}
+
+void UniformGrid::ShowStats()
+{
+	using namespace Common::Strings;
+
+	char tmpBuffer[256] = {};
+
+	if (numOfGridsConstructed)
+	{
+		LOG_TL(LogLevel::Info, "Uniform grid statistics:");
+		LOG_TL(LogLevel::Info, "\tgrids constructed:\t%I64d", numOfGridsConstructed);
+		LOG_TL(LogLevel::Info, "\tresolution last:\t%dx%dx%d (%.2f cells/object)",
+			resolution.x, resolution.y, resolution.z, currentCellsPerObject);
+		LOG_TL(LogLevel::Info, "\tcells used:\t\t%I64d (avg %I64d/grid)", numOfCellsUsed,
+			numOfCellsUsed / numOfGridsConstructed);
+		LOG_TL(LogLevel::Info, "\treferences used:\t%I64d (avg %I64d/grid)", numOfReferencesUsed,
+			numOfReferencesUsed / numOfGridsConstructed);
+		LOG_TL(LogLevel::Info, "\tmemory used:\t\tavg %s/grid",
+			GetMemSizeString(tmpBuffer, (numOfCellsUsed * sizeof(ui32) + numOfReferencesUsed * sizeof(ObjectId)) /
+			numOfGridsConstructed));
+	}
+}
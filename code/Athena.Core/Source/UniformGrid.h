@@ -0,0 +1,136 @@
+#ifndef __uniform_grid_h
+#define __uniform_grid_h
+
+// Uniform grid traversed by 3D-DDA
+// A Fast Voxel Traversal Algorithm for Ray Tracing, Eurographics 1987
+//
+// John Amanatides and Andrew Woo
+
+#include "AACell.h"
+#include "Array.h"
+#include "Object.h"
+#include "thread"
+#include "TypeDefs.h"
+#include "Vectors.h"
+
+// number of cells is gridCellsPerObject times number of objects, cells are cubes (axes thinner than one cell
+// have one cell)
+#define GRID_MIN_CELLS_PER_OBJECT		(real).125
+#define GRID_MAX_CELLS_PER_OBJECT		(real)16
+#define GRID_MAX_RESOLUTION				1024 // cells per axis
+#define GRID_MAX_CELLS					(1 << 24)
+
+// parallel construction
+#define GRID_MAX_BUILD_TASKS			16
+#define GRID_MIN_BUILD_TASK_OBJECTS		4096 // smaller grids are not worth of threads
+
+
+// cells overlapped by object bounds, min corner is above max corner for objects without bounds (planes, point lights)
+struct GridObjectRange
+{
+	ui16 minCell[3];
+	ui16 maxCell[3];
+};
+
+// one step of counting sort run by one thread, either for contiguous part of objects or of cells
+struct GridBuildTask
+{
+	uint firstObjectId, objectCount;
+	ui32 firstCellId, cellCount;
+
+	// bounds of task objects and number of objects with bounds
+	AACell cell;
+	uint boundedObjectCount;
+	// references to task cells, the first one is after references of previous tasks
+	uint firstReferenceId, referenceCount;
+};
+
+DLL_EXPORT_ARRAY_OF(GridObjectRange);
+
+
+class MemoryManager;
+struct AthenaStorage;
+struct HitResult;
+struct Objects;
+struct ObjectId;
+struct Ray;
+
+class DLL_EXPORT UniformGrid
+{
+public:
+
+	void Initialize(Objects* objects, MemoryManager* memoryManagerInstance);
+	void Destroy(MemoryManager* memoryManagerInstance);
+	// constructs grid when objects moved (sceneChanged), object references are sorted to cells by counting sort,
+	// steps of construction are run on threads for parts of objects or cells
+	bool Update(array_of<std::thread>& threads, bool sceneChanged, AthenaStorage* athenaStorage);
+
+	// cells are visited along ray until the one containing the closest hit
+	void Hit(const Ray& ray, HitResult& hitResult) const;
+	bool Collide(const Ray& ray, real from = EPSILON, real to = _INFINITY, const ObjectId* objectIdToSkip = null) const;
+
+	inline const uint GetCurrentCellCount() const { return cellCount; }
+
+private:
+
+	void ShowStats();
+
+	void Clear();
+	bool Construct(array_of<std::thread>& threads);
+	// resolution of grid follows density of objects in its bounds
+	void UpdateResolution(uint objectCount);
+
+	void RunTasks(array_of<std::thread>& threads, void (UniformGrid::*step)(GridBuildTask*));
+	// steps of construction, objects (bounds and cell ranges of objects), cells (count and scatter of references)
+	void ComputeObjectCells(GridBuildTask* task);
+	void ComputeObjectRanges(GridBuildTask* task);
+	void CountReferences(GridBuildTask* task);
+	void ScatterReferences(GridBuildTask* task);
+
+	bool GetObjectCell(const ObjectId& objectId, AACell& objectCell) const;
+	// cells are stored by rows along x axis, then by layers along y axis
+	template <typename T> inline ui32 GetCellId(const T* cell) const
+	{
+		return ((ui32)cell[2] * resolution.y + cell[1]) * resolution.x + cell[0];
+	}
+
+	// 3D-DDA starts in cell where ray enters grid (interval is clipped by grid bounds), tNext is distance of
+	// the next cell boundary on each axis and tDelta is distance between boundaries, false if grid is missed
+	bool StartTraversal(const Ray& ray, real& tmin, real& tmax, ui32* cell, real* tNext, real* tDelta) const;
+
+	void HitCell(const Ray& ray, ui32 cellId, HitResult& hitResult) const;
+	bool CollideCell(const Ray& ray, ui32 cellId, real from, real to, const ObjectId* objectIdToSkip) const;
+
+private:
+
+	// statistics
+	uint64 numOfGridsConstructed;
+	uint64 numOfCellsUsed;
+	uint64 numOfReferencesUsed;
+
+	ui64 currentObjectsVersion; // objects->version of constructed grid
+	real currentCellsPerObject;
+
+	AACell rootCell;
+	v3ui resolution;
+	v3f cellSize;
+	v3f invCellSize;
+
+	Objects* objects;
+
+	// compressed sparse row layout, references of cell are between its start and start of next cell,
+	// arrays are allocated for more cells and references than used
+	array_of<ui32> cellStarts;
+	array_of<ObjectId> references;
+	uint cellCount, referenceCount;
+
+	// construction buffers, kept for next constructions
+	array_of<AACell> objectCells;
+	array_of<GridObjectRange> objectRanges;
+	GridBuildTask tasks[GRID_MAX_BUILD_TASKS];
+	uint taskCount;
+
+	MemoryManager* memoryManagerInstance;
+};
+
+#endif __uniform_grid_h
@@ -1,26 +1,26 @@
-
-#include "Log.h"
-#include <windows.h>
-
-
-BOOL APIENTRY DllMain(HMODULE hModule,
-	DWORD  ul_reason_for_call,
-	LPVOID lpReserved
-	)
-{
-	switch (ul_reason_for_call)
-	{
-	case DLL_PROCESS_ATTACH:
-		Log::Instance()->Initialize("Athena.Core", true);
-		Log::Instance()->SetLogLevel(LogLevel::Everything);
-		break;
-	case DLL_THREAD_ATTACH:
-		break;
-	case DLL_THREAD_DETACH:
-		break;
-	case DLL_PROCESS_DETACH:
-		Log::Destroy();
-		break;
-	}
-	return TRUE;
-}
+
+#include "Log.h"
+#include <windows.h>
+
+
+BOOL APIENTRY DllMain(HMODULE hModule,
+	DWORD  ul_reason_for_call,
+	LPVOID lpReserved
+	)
+{
+	switch (ul_reason_for_call)
+	{
+	case DLL_PROCESS_ATTACH:
+		Log::Instance()->Initialize("Athena.Core", true);
+		Log::Instance()->SetLogLevel(LogLevel::Everything);
+		break;
+	case DLL_THREAD_ATTACH:
+		break;
+	case DLL_THREAD_DETACH:
+		break;
+	case DLL_PROCESS_DETACH:
+		Log::Destroy();
+		break;
+	}
+	return TRUE;
+}